@@ -0,0 +1,208 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int lhsList[100000];
+int rhsList[100000];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Loop Fill / Copy / Sum / Argmin / Dot (The CMM loops of the array builtins)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int loopFill(int numList[], int lo, int hi, int numVal)
+{
+    while (lo < hi)
+    {
+        numList[lo] = numVal;
+        lo = lo + 1;
+    }
+
+    return 0;
+}
+
+
+int loopCopy(int dstList[], int srcList[], int n)
+{
+    int nowIdx;
+
+    nowIdx = 0;
+
+    while (nowIdx < n)
+    {
+        dstList[nowIdx] = srcList[nowIdx];
+        nowIdx = nowIdx + 1;
+    }
+
+    return 0;
+}
+
+
+int loopSum(int numList[], int lo, int hi)
+{
+    int sumNum;
+
+    sumNum = 0;
+
+    while (lo < hi)
+    {
+        sumNum = sumNum + numList[lo];
+        lo = lo + 1;
+    }
+
+    return sumNum;
+}
+
+
+int loopArgmin(int numList[], int lo, int hi)
+{
+    int minIdx;
+
+    minIdx = lo;
+
+    while (lo < hi)
+    {
+        if (numList[lo] < numList[minIdx])
+        {
+            minIdx = lo;
+        }
+
+        lo = lo + 1;
+    }
+
+    return minIdx;
+}
+
+
+int loopDot(int lhsList[], int rhsList[], int n)
+{
+    int nowIdx;
+    int dotNum;
+
+    nowIdx = 0;
+    dotNum = 0;
+
+    while (nowIdx < n)
+    {
+        dotNum = dotNum + lhsList[nowIdx] * rhsList[nowIdx];
+        nowIdx = nowIdx + 1;
+    }
+
+    return dotNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Run (Op: 1 fill, 2 copy, 3 sum, 4 argmin, 5 dot, by the builtin if builtinBool, the result of the last round)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int run(int opIdx, int builtinBool, int n, int roundNum)
+{
+    int resNum;
+
+    resNum = 0;
+
+    while (roundNum > 0)
+    {
+        if (opIdx == 1)
+        {
+            if (builtinBool)
+            {
+                fill(rhsList, 0, n, roundNum);
+            }
+            else
+            {
+                loopFill(rhsList, 0, n, roundNum);
+            }
+
+            resNum = rhsList[n - 1];
+        }
+
+        if (opIdx == 2)
+        {
+            if (builtinBool)
+            {
+                copy(rhsList, lhsList, n);
+            }
+            else
+            {
+                loopCopy(rhsList, lhsList, n);
+            }
+
+            resNum = rhsList[n - 1];
+        }
+
+        if (opIdx == 3)
+        {
+            if (builtinBool)
+            {
+                resNum = sum(lhsList, 0, n);
+            }
+            else
+            {
+                resNum = loopSum(lhsList, 0, n);
+            }
+        }
+
+        if (opIdx == 4)
+        {
+            if (builtinBool)
+            {
+                resNum = argmin(lhsList, 0, n);
+            }
+            else
+            {
+                resNum = loopArgmin(lhsList, 0, n);
+            }
+        }
+
+        if (opIdx == 5)
+        {
+            if (builtinBool)
+            {
+                resNum = dot(lhsList, lhsList, n);
+            }
+            else
+            {
+                resNum = loopDot(lhsList, lhsList, n);
+            }
+        }
+
+        roundNum = roundNum - 1;
+    }
+
+    return resNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (Read the op, builtinBool, N and the rounds, write the result)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int opIdx;
+    int builtinBool;
+    int n;
+    int roundNum;
+    int nowIdx;
+    int seedNum;
+
+    opIdx = input();
+    builtinBool = input();
+    n = input();
+    roundNum = input();
+
+    nowIdx = 0;
+    seedNum = 1;
+
+    while (nowIdx < n)
+    {
+        seedNum = seedNum * 1103 + 12345;
+        seedNum = seedNum - seedNum / 65536 * 65536;
+        lhsList[nowIdx] = seedNum - 32768;
+        nowIdx = nowIdx + 1;
+    }
+
+    output(run(opIdx, builtinBool, n, roundNum));
+}
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+
+'''
+    arrays.py
+    =========
+        Run each array builtin of bench/arrays.c (fill, copy, sum, argmin, dot) and its CMM loop, the builtin with
+        each array kernel the CPU supports, check the results and report the median time per round (Without the
+        setup of the arrays) and the speedup over the loop.
+
+        Usage: bench/arrays.py [--size N] [--rounds N] [--builtin-rounds N] [--runs N] [--word-size 32|64]
+                               [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+OP_LIST = ['fill', 'copy', 'sum', 'argmin', 'dot']
+
+################################################################################################################################
+# Reference Implementation (The result of an op after roundNum rounds)
+################################################################################################################################
+
+def refArrays(opName, n, roundNum, wordSize):
+    numList, seedNum = [], 1
+
+    for _ in range(n):
+        seedNum = (seedNum * 1103 + 12345) % 65536
+        numList.append(seedNum - 32768)
+
+    wrap = lambda x: (x + (1 << (wordSize - 1))) % (1 << wordSize) - (1 << (wordSize - 1))
+
+    if not roundNum:
+        return 0
+
+    return {
+        'fill':   lambda: 1,
+        'copy':   lambda: numList[-1],
+        'sum':    lambda: wrap(sum(numList)),
+        'argmin': lambda: numList.index(min(numList)),
+        'dot':    lambda: wrap(sum(x * x for x in numList)),
+    }[opName]()
+
+
+################################################################################################################################
+# Run (The run wall time of bench/arrays.c in ms, and its output)
+################################################################################################################################
+
+def run(asmPath, statsPath, argList, inputStr):
+    procObj = subprocess.run([CMM_PATH, '--asm-file-path', asmPath, '--stats-json', statsPath] + argList,
+        input=inputStr, capture_output=True, text=True)
+
+    if procObj.returncode:
+        sys.exit('CMM failed: {}'.format(procObj.stderr.strip()))
+
+    with open(statsPath) as f:
+        return json.load(f)['run']['wall_ms'], int(procObj.stdout)
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare the CMM array builtins with the equivalent CMM loops')
+
+    parser.add_argument('--size', type=int, default=100000, help='Array size (At most 100000)')
+    parser.add_argument('--rounds', type=int, default=10, help='Rounds of each loop per run')
+    parser.add_argument('--builtin-rounds', type=int, default=20000, help='Rounds of each builtin per run')
+    parser.add_argument('--runs', type=int, default=3, help='Runs of each op and mode')
+    parser.add_argument('--word-size', type=int, default=32, help='VM word size')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    if not 0 < args.size <= 100000:
+        sys.exit('Invalid size: {}'.format(args.size))
+
+    # The kernels of the CPU ("--array-kernel" fails for the other ones)
+    kernelList = [kernelName for kernelName in ['scalar', 'sse4.2', 'avx2'] if not subprocess.run([CMM_PATH,
+        '--array-kernel', kernelName], capture_output=True).returncode]
+
+    modeList = [('loop', [], 0, args.rounds)] + [(kernelName, ['--array-kernel', kernelName], 1, args.builtin_rounds)
+        for kernelName in kernelList]
+    resList = []
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        asmPath, statsPath = os.path.join(tmpPath, 'arrays.asm'), os.path.join(tmpPath, 'stats.json')
+
+        subprocess.run([CMM_PATH, '--input-file-path', os.path.join(ROOT_PATH, 'bench', 'arrays.c'),
+            '--output-file-path', asmPath], check=True)
+
+        for opIdx, opName in enumerate(OP_LIST, 1):
+            resDict = {'op': opName}
+
+            for modeName, argList, builtinBool, roundNum in modeList:
+                expectNum = refArrays(opName, args.size, roundNum, args.word_size)
+                argList = argList + ['--word-size', str(args.word_size)]
+                timeList = []
+
+                for _ in range(args.runs):
+                    setupTime, _ = run(asmPath, statsPath, argList,
+                        '{} {} {} 0\n'.format(opIdx, builtinBool, args.size))
+                    wallTime, outputNum = run(asmPath, statsPath, argList,
+                        '{} {} {} {}\n'.format(opIdx, builtinBool, args.size, roundNum))
+
+                    if outputNum != expectNum:
+                        sys.exit('{} ({}): expect {}, got {}'.format(opName, modeName, expectNum, outputNum))
+
+                    timeList.append(max(wallTime - setupTime, 0.) / roundNum)
+
+                resDict[modeName] = statistics.median(timeList)
+
+            resList.append(resDict)
+
+    print('{:>8}'.format('Op') + ''.join('  {:>12}'.format(modeName + ' (ms)') for modeName, _, _, _ in modeList) +
+        '  {:>8}'.format('Speedup'))
+
+    for resDict in resList:
+        resDict['speedup'] = resDict['loop'] / max(min(resDict[kernelName] for kernelName in kernelList), 1e-6)
+
+        print('{:>8}'.format(resDict['op']) + ''.join('  {:>12.4f}'.format(resDict[modeName])
+            for modeName, _, _, _ in modeList) + '  {:>8.1f}'.format(resDict['speedup']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-arrays/1', 'size': args.size, 'rounds': args.rounds,
+                'builtin_rounds': args.builtin_rounds,
+                'word_size': args.word_size, 'kernels': kernelList, 'results': resList}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,90 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int numArray[100000];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Binary Search (The index of targetNum in the sorted [0, n), or -1)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int binarySearch(int numArray[], int n, int targetNum)
+{
+    int lowIdx;
+    int highIdx;
+    int midIdx;
+
+    lowIdx = 0;
+    highIdx = n;
+
+    while (lowIdx < highIdx)
+    {
+        midIdx = (lowIdx + highIdx) / 2;
+
+        if (numArray[midIdx] < targetNum)
+        {
+            lowIdx = midIdx + 1;
+        }
+        else
+        {
+            highIdx = midIdx;
+        }
+    }
+
+    if (lowIdx < n)
+    {
+        if (numArray[lowIdx] == targetNum)
+        {
+            return lowIdx;
+        }
+    }
+
+    return 0 - 1;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (Read n and the query number, search 0, 7, 14, ... in 1, 4, 7, ...)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+    int queryNum;
+    int idx;
+    int foundNum;
+    int sumIdx;
+    int resIdx;
+
+    n = input();
+    queryNum = input();
+
+    idx = 0;
+
+    while (idx < n)
+    {
+        numArray[idx] = idx * 3 + 1;
+        idx = idx + 1;
+    }
+
+    idx = 0;
+    foundNum = 0;
+    sumIdx = 0;
+
+    while (idx < queryNum)
+    {
+        resIdx = binarySearch(numArray, n, idx * 7);
+
+        if (resIdx >= 0)
+        {
+            foundNum = foundNum + 1;
+            sumIdx = sumIdx + resIdx;
+        }
+
+        idx = idx + 1;
+    }
+
+    output(foundNum);
+    output(sumIdx);
+}
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+
+'''
+    cache.py
+    ========
+        Compile the generated CMM programs (bench/gen.py) of growing function numbers with --cache into an empty cache
+        dir, then again, then after an edit of one function, and report the median wall time of a miss (The compiler
+        and the store), of a hit (The load of the cached asm) and of the edit (Only the edited function is generated)
+        per size.
+
+        Usage: bench/cache.py [--sizes N,N,...] [--runs N] [-O LEVEL] [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+from gen import DEFAULT_CONFIG, Generator
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+
+################################################################################################################################
+# Compile (Return the "compile" part of the stats JSON)
+################################################################################################################################
+
+def compileProgram(srcPath, optLevel, cachePath, tmpPath):
+    statsPath = os.path.join(tmpPath, 'stats.json')
+
+    subprocess.run([CMM_PATH, '--input-file-path', srcPath, '--output-file-path', os.path.join(tmpPath, 'gen.asm'),
+        '-O', str(optLevel), '--cache-dir', cachePath, '--stats-json', statsPath], check=True)
+
+    with open(statsPath) as f:
+        return json.load(f)['compile']
+
+
+################################################################################################################################
+# Run Size (Each miss starts from an empty cache dir)
+################################################################################################################################
+
+def runSize(funcNum, runNum, optLevel, tmpPath):
+    srcPath, editPath, cachePath = [os.path.join(tmpPath, fileName) for fileName in ('gen.c', 'edit.c', 'cache')]
+    sourceStr = Generator(dict(DEFAULT_CONFIG, funcs=funcNum)).genProgram()
+
+    # The edit: The first number after the middle of the source is changed (In the body of a function)
+    numMatch = re.compile(r'\b\d+\b').search(sourceStr, len(sourceStr) // 2)
+
+    with open(srcPath, 'w') as f:
+        f.write(sourceStr)
+
+    with open(editPath, 'w') as f:
+        f.write(sourceStr[:numMatch.start()] + str(int(numMatch.group()) + 1) + sourceStr[numMatch.end():])
+
+    missList, hitList, editList = [], [], []
+
+    for _ in range(runNum):
+        shutil.rmtree(cachePath, ignore_errors=True)
+
+        missDict = compileProgram(srcPath, optLevel, cachePath, tmpPath)
+        hitDict = compileProgram(srcPath, optLevel, cachePath, tmpPath)
+        editDict = compileProgram(editPath, optLevel, cachePath, tmpPath)
+
+        if missDict['cache_misses'] != 1 or hitDict['cache_hits'] != 1 or editDict['cache_misses'] != 1:
+            sys.exit('Invalid cache stats: {} / {} / {}'.format(missDict, hitDict, editDict))
+
+        missList.append(missDict['wall_ms'])
+        hitList.append(hitDict['wall_ms'])
+        editList.append(editDict['wall_ms'])
+
+    return {
+        'funcs':        funcNum,
+        'instructions': hitDict['instructions'],
+        'miss_ms':      statistics.median(missList),
+        'hit_ms':       statistics.median(hitList),
+        'edit_ms':      statistics.median(editList),
+        'edit_reused':  editDict.get('functions_reused'),
+    }
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the CMM compile time with a cold and a warm --cache')
+
+    parser.add_argument('--sizes', default='25,50,100,200', help='The comma separated function numbers')
+    parser.add_argument('--runs', type=int, default=3, help='Compile each program N times and report the medians')
+    parser.add_argument('-O', '--opt-level', type=int, default=1, help='Optimization level: 0, 1, 2 (SSA)')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    try:
+        sizeList = [int(sizeStr) for sizeStr in args.sizes.split(',')]
+    except ValueError:
+        sys.exit('Invalid sizes: ' + args.sizes)
+
+    resList = []
+
+    print('{:>10}{:>14}{:>14}{:>14}{:>10}{:>14}{:>10}'.format('funcs', 'Instructions', 'Miss (ms)', 'Hit (ms)',
+        'Speedup', 'Edit (ms)', 'Reused'))
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        for funcNum in sizeList:
+            resDict = runSize(funcNum, args.runs, args.opt_level, tmpPath)
+
+            print('{:>10}{:>14}{:>14.3f}{:>14.3f}{:>9.1f}x{:>14.3f}{:>10}'.format(funcNum, resDict['instructions'],
+                resDict['miss_ms'], resDict['hit_ms'], resDict['miss_ms'] / max(resDict['hit_ms'], 1e-3),
+                resDict['edit_ms'], '-' if resDict['edit_reused'] is None else resDict['edit_reused']), flush=True)
+
+            resList.append(resDict)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-cache-bench/1', 'opt_level': args.opt_level, 'runs': args.runs,
+                'results': resList}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
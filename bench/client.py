@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+
+'''
+    client.py
+    =========
+        A client of "CMM --serve": send a CMM source (Or an asm file) with the program input of stdin, write the output
+        to stdout and the stats JSON of the server to stderr (With --stats), and exit with 1 if the run failed.
+
+        Usage: bench/client.py SOCKET FILE [--asm] [--fuel N] [-O LEVEL] [--stats] < INPUT
+
+        As a module, Client(socketPath).run(codeStr, inputStr) returns (Status, Output, Stats dict), reusing the
+        connection.
+'''
+
+import argparse
+import json
+import socket
+import sys
+
+################################################################################################################################
+# Client
+################################################################################################################################
+
+class Client:
+    def __init__(self, socketPath):
+        self.sockObj = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sockObj.connect(socketPath)
+        self.bufferBytes = b''
+
+    def close(self):
+        self.sockObj.close()
+
+    def readExact(self, byteNum):
+        while len(self.bufferBytes) < byteNum:
+            readBytes = self.sockObj.recv(max(byteNum - len(self.bufferBytes), 1 << 16))
+
+            if not readBytes:
+                raise ConnectionError('CMM server closed the connection')
+
+            self.bufferBytes += readBytes
+
+        dataBytes, self.bufferBytes = self.bufferBytes[:byteNum], self.bufferBytes[byteNum:]
+
+        return dataBytes
+
+    def readLine(self):
+        while b'\n' not in self.bufferBytes:
+            readBytes = self.sockObj.recv(1 << 16)
+
+            if not readBytes:
+                raise ConnectionError('CMM server closed the connection')
+
+            self.bufferBytes += readBytes
+
+        lineBytes, self.bufferBytes = self.bufferBytes.split(b'\n', 1)
+
+        return lineBytes.decode()
+
+    # Kind: "cmm" or "asm", fuel 0 / optLevel -1 for the server ones
+    def run(self, codeStr, inputStr='', kindStr='cmm', fuel=0, optLevel=-1):
+        codeBytes, inputBytes = codeStr.encode(), inputStr.encode()
+
+        self.sockObj.sendall('{} {} {} {} {}\n'.format(kindStr, len(codeBytes), len(inputBytes), fuel,
+            optLevel).encode() + codeBytes + inputBytes)
+
+        statusStr, outputSize, statsSize = self.readLine().split()
+        outputStr = self.readExact(int(outputSize)).decode()
+
+        return statusStr, outputStr, json.loads(self.readExact(int(statsSize)))
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Run a CMM program on a CMM --serve server')
+
+    parser.add_argument('socket', help='Socket path of the server')
+    parser.add_argument('file', help='CMM source (Or asm with --asm) file')
+    parser.add_argument('--asm', action='store_true', help='The file is an asm file')
+    parser.add_argument('--fuel', type=int, default=0, help='Max instructions of the run (Default: the server one)')
+    parser.add_argument('-O', dest='opt_level', type=int, default=-1, help='Optimization level (Default: the server one)')
+    parser.add_argument('--stats', action='store_true', help='Write the stats JSON of the server to stderr')
+
+    args = parser.parse_args()
+
+    with open(args.file) as f:
+        codeStr = f.read()
+
+    clientObj = Client(args.socket)
+    statusStr, outputStr, statsDict = clientObj.run(codeStr, sys.stdin.read(), 'asm' if args.asm else 'cmm',
+        args.fuel, args.opt_level)
+    clientObj.close()
+
+    sys.stdout.write(outputStr)
+
+    if args.stats:
+        json.dump(statsDict, sys.stderr, indent=4)
+        sys.stderr.write('\n')
+
+    if statusStr != 'ok':
+        sys.exit(statsDict['error'])
+
+
+if __name__ == '__main__':
+    main()
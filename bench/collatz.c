@@ -0,0 +1,44 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count Collatz Steps (Of n down to 1)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int countCollatzSteps(int n)
+{
+    int stepNum;
+
+    stepNum = 0;
+
+    while (n != 1)
+    {
+        if (n - n / 2 * 2 == 0)
+        {
+            n = n / 2;
+        }
+        else
+        {
+            n = n * 3 + 1;
+        }
+
+        stepNum = stepNum + 1;
+    }
+
+    return stepNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (Read N, then read N ints and write the steps of each one)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+
+    n = input();
+
+    while (n > 0)
+    {
+        output(countCollatzSteps(input()));
+        n = n - 1;
+    }
+}
@@ -0,0 +1,16 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Read N, then read N ints and write them back
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+
+    n = input();
+
+    while (n > 0)
+    {
+        output(input());
+        n = n - 1;
+    }
+}
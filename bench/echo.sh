@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Usage: bench/echo.sh [N]  (Read N ints and write them back, default 10000000)
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+N=${1:-10000000}
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+awk -v n="$N" 'BEGIN { srand(1); print n; for (i = 0; i < n; i++) print int(rand() * 4294967296) - 2147483648 }' \
+    > "$TMP_DIR/input.txt"
+
+bin/CMM --input-file-path bench/echo.c --output-file-path "$TMP_DIR/echo.asm"
+
+START_TIME=$(date +%s.%N)
+bin/CMM --asm-file-path "$TMP_DIR/echo.asm" < "$TMP_DIR/input.txt" > "$TMP_DIR/output.txt"
+END_TIME=$(date +%s.%N)
+
+tail -n +2 "$TMP_DIR/input.txt" | cmp - "$TMP_DIR/output.txt"
+
+awk -v n="$N" -v s="$START_TIME" -v e="$END_TIME" 'BEGIN { printf "echo %d ints: %.3f s\n", n, e - s }'
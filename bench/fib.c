@@ -0,0 +1,23 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Calc Fibonacci (Naive recursion)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int calcFibonacci(int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+
+    return calcFibonacci(n - 1) + calcFibonacci(n - 2);
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    output(calcFibonacci(input()));
+}
@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+
+'''
+    gen.py
+    ======
+        Generate a valid CMM program for the compiler scalability benchmark.
+
+        Usage: bench/gen.py [--funcs N] [--stmts N] [--depth N] [--array-size N] [--fanout N] [--call-sites N]
+                            [--seed N]
+
+        Each function has two int params, takes "--stmts" statements (Assignments, array stores, if / else and while
+        loops) and calls "--fanout" of the functions before it (The first call is to the previous one, so all the
+        functions are reachable from main), every expression is nested "--depth" levels deep and there are two global
+        arrays of "--array-size" ints. The functions only call the ones before them, so there is no recursion.
+        With "--call-sites", main also calls a small leaf function (Inlined at each call site) that many times.
+'''
+
+import argparse
+import random
+import string
+
+################################################################################################################################
+# Config
+################################################################################################################################
+
+DEFAULT_CONFIG = {
+    'funcs':      20,
+    'stmts':      20,
+    'depth':      4,
+    'array_size': 100,
+    'fanout':     2,
+    'call_sites': 0,
+    'seed':       1,
+}
+
+VAR_LIST = ['pa', 'pb', 'va', 'vb', 'vc']
+
+
+################################################################################################################################
+# Get Func Name (The identifiers are letters only: 0 -> fnA, 25 -> fnZ, 26 -> fnBA, ...)
+################################################################################################################################
+
+def getFuncName(funcIdx):
+    nameStr = ''
+
+    while True:
+        nameStr = string.ascii_uppercase[funcIdx % 26] + nameStr
+        funcIdx //= 26
+
+        if not funcIdx:
+            return 'fn' + nameStr
+
+
+################################################################################################################################
+# Class Generator
+################################################################################################################################
+
+class Generator:
+
+    def __init__(self, configDict):
+        self.configDict = dict(DEFAULT_CONFIG, **configDict)
+        self.randomObj  = random.Random(self.configDict['seed'])
+
+
+    # Gen Leaf: A var, a number or a global array element
+    def genLeaf(self):
+        leafType = self.randomObj.randrange(4)
+
+        if leafType < 2:
+            return self.randomObj.choice(VAR_LIST)
+        elif leafType == 2:
+            return str(self.randomObj.randrange(100))
+        else:
+            return 'gA[{}]'.format(self.randomObj.randrange(self.configDict['array_size']))
+
+
+    # Gen Expr: Nested depth levels of parentheses, one side of each level is a leaf
+    def genExpr(self, depthNum = None):
+        if depthNum is None:
+            depthNum = self.configDict['depth']
+
+        exprStr = self.genLeaf()
+
+        for _ in range(depthNum):
+            opStr = self.randomObj.choice(['+', '-', '*'])
+
+            if self.randomObj.randrange(2):
+                exprStr = '({} {} {})'.format(exprStr, opStr, self.genLeaf())
+            else:
+                exprStr = '({} {} {})'.format(self.genLeaf(), opStr, exprStr)
+
+        return exprStr
+
+
+    # Gen Stmt
+    def genStmt(self, indentStr):
+        stmtType = self.randomObj.randrange(4)
+        lhsStr   = self.randomObj.choice(['va', 'vb', 'vc'])
+
+        # Assignment
+        if stmtType == 0:
+            return ['{}{} = {};'.format(indentStr, lhsStr, self.genExpr())]
+
+        # Array store
+        elif stmtType == 1:
+            return ['{}gB[{}] = {};'.format(indentStr, self.randomObj.randrange(self.configDict['array_size']),
+                self.genExpr())]
+
+        # If / else
+        elif stmtType == 2:
+            return [
+                '{}if ({} < {})'.format(indentStr, self.genExpr(), self.genExpr()),
+                indentStr + '{',
+                '{}    {} = {};'.format(indentStr, lhsStr, self.genExpr()),
+                indentStr + '}',
+                indentStr + 'else',
+                indentStr + '{',
+                '{}    {} = {};'.format(indentStr, lhsStr, self.genExpr()),
+                indentStr + '}',
+            ]
+
+        # While (Bounded by the array size)
+        else:
+            return [
+                '{}vi = 0;'.format(indentStr),
+                '{}while (vi < {})'.format(indentStr, min(self.configDict['array_size'], 8)),
+                indentStr + '{',
+                '{}    gB[vi] = gB[vi] + {};'.format(indentStr, self.genExpr()),
+                '{}    vi = vi + 1;'.format(indentStr),
+                indentStr + '}',
+            ]
+
+
+    # Gen Func
+    def genFunc(self, funcIdx):
+        lineList = [
+            'int {}(int pa, int pb)'.format(getFuncName(funcIdx)),
+            '{',
+            '    int va;',
+            '    int vb;',
+            '    int vc;',
+            '    int vi;',
+            '',
+            '    va = pa;',
+            '    vb = pb;',
+            '    vc = 0;',
+            '',
+        ]
+
+        stmtNum = self.configDict['stmts']
+        callNum = min(self.configDict['fanout'], stmtNum) if funcIdx else 0
+        callIdxList = sorted(self.randomObj.sample(range(stmtNum), callNum))
+
+        for stmtIdx in range(stmtNum):
+            if stmtIdx in callIdxList:
+                # The first call is to the previous function, so all the functions are reachable from main
+                calleeIdx = funcIdx - 1 if stmtIdx == callIdxList[0] else self.randomObj.randrange(funcIdx)
+
+                lineList.append('    {} = {}({}, {});'.format(self.randomObj.choice(['va', 'vb', 'vc']),
+                    getFuncName(calleeIdx), self.genExpr(), self.genExpr()))
+            else:
+                lineList.extend(self.genStmt('    '))
+
+        lineList.extend(['', '    return va + vb + vc;', '}', '', ''])
+
+        return lineList
+
+
+    # Gen Program
+    def genProgram(self):
+        arraySize = self.configDict['array_size']
+
+        lineList = [
+            '/* Generated by bench/gen.py: {} */'.format(', '.join('{} = {}'.format(*configPair)
+                for configPair in sorted(self.configDict.items()))),
+            '',
+            'int gA[{}];'.format(arraySize),
+            'int gB[{}];'.format(arraySize),
+            '',
+            '',
+        ]
+
+        for funcIdx in range(self.configDict['funcs']):
+            lineList.extend(self.genFunc(funcIdx))
+
+        callSiteNum = self.configDict['call_sites']
+
+        if callSiteNum:
+            lineList.extend([
+                'int leaf(int pa, int pb)',
+                '{',
+                '    if (pa < pb)',
+                '    {',
+                '        return pb - pa;',
+                '    }',
+                '',
+                '    return pa - pb;',
+                '}',
+                '',
+                '',
+            ])
+
+        lineList.extend([
+            'int main()',
+            '{',
+            '    int vi;',
+            '',
+            '    vi = 0;',
+            '',
+            '    while (vi < {})'.format(arraySize),
+            '    {',
+            '        gA[vi] = vi;',
+            '        gB[vi] = 0;',
+            '        vi = vi + 1;',
+            '    }',
+            '',
+        ])
+
+        # The leaf calls are chained from the input, so none of them is folded away
+        if callSiteNum:
+            lineList.append('    vi = input();')
+
+            for _ in range(callSiteNum):
+                lineList.append('    vi = leaf(vi, {});'.format(self.randomObj.randrange(100)))
+
+            lineList.extend(['', '    output({}(vi, 1));'.format(getFuncName(self.configDict['funcs'] - 1)), '}'])
+        else:
+            lineList.extend(['    output({}(input(), 1));'.format(getFuncName(self.configDict['funcs'] - 1)), '}'])
+
+        return '\n'.join(lineList) + '\n'
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate a valid CMM program')
+
+    parser.add_argument('--funcs', type=int, default=DEFAULT_CONFIG['funcs'], help='Function number')
+    parser.add_argument('--stmts', type=int, default=DEFAULT_CONFIG['stmts'], help='Statements per function')
+    parser.add_argument('--depth', type=int, default=DEFAULT_CONFIG['depth'], help='Expression nesting depth')
+    parser.add_argument('--array-size', type=int, default=DEFAULT_CONFIG['array_size'], help='Global array size')
+    parser.add_argument('--fanout', type=int, default=DEFAULT_CONFIG['fanout'], help='Calls per function')
+    parser.add_argument('--call-sites', type=int, default=DEFAULT_CONFIG['call_sites'],
+        help='Calls of a small leaf function in main')
+    parser.add_argument('--seed', type=int, default=DEFAULT_CONFIG['seed'], help='Random seed')
+
+    args = parser.parse_args()
+
+    if args.funcs < 1 or args.stmts < 0 or args.depth < 0 or args.array_size < 1 or args.fanout < 0 or \
+        args.call_sites < 0:
+        parser.error('Invalid config')
+
+    print(Generator(vars(args)).genProgram(), end='')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,72 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hash Rounds (A uniform kernel: The same instructions for any seed)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int hashRounds(int seedNum, int roundNum)
+{
+    int hashNum;
+    int nowIdx;
+
+    hashNum = seedNum;
+    nowIdx = 0;
+
+    while (nowIdx < roundNum)
+    {
+        hashNum = hashNum * 31 + seedNum * nowIdx + 7;
+        hashNum = hashNum - hashNum / 65521 * 65521;
+        nowIdx = nowIdx + 1;
+    }
+
+    return hashNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count Collatz Steps (A divergent kernel: Of n down to 1)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int countCollatzSteps(int n)
+{
+    int stepNum;
+
+    stepNum = 0;
+
+    while (n != 1)
+    {
+        if (n - n / 2 * 2 == 0)
+        {
+            n = n / 2;
+        }
+        else
+        {
+            n = n * 3 + 1;
+        }
+
+        stepNum = stepNum + 1;
+    }
+
+    return stepNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (A record per line: "0 Seed Rounds" for the hash, "1 N" for the Collatz steps)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int kernelIdx;
+    int seedNum;
+
+    kernelIdx = input();
+
+    if (kernelIdx == 0)
+    {
+        seedNum = input();
+        output(hashRounds(seedNum, input()));
+    }
+    else
+    {
+        output(countCollatzSteps(input()));
+    }
+}
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+
+'''
+    lanes.py
+    ========
+        Run bench/lanes.c by --batch over many records, one record at a time and with each "--lanes", for a uniform
+        kernel (The same instructions for every record) and a divergent one (Collatz steps), check the outputs and
+        report the median wall time, the speedup over one record at a time and the lanes per lockstep step.
+
+        Usage: bench/lanes.py [--records N] [--rounds N] [--lanes N,N,...] [--runs N] [--word-size 32|64]
+                              [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import random
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+################################################################################################################################
+# Reference Implementation (The output line of a record)
+################################################################################################################################
+
+def refHash(seedNum, roundNum):
+    hashNum = seedNum
+
+    for nowIdx in range(roundNum):
+        hashNum = (hashNum * 31 + seedNum * nowIdx + 7) % 65521
+
+    return hashNum
+
+
+def refCollatz(n):
+    stepNum = 0
+
+    while n != 1:
+        n = n // 2 if n % 2 == 0 else n * 3 + 1
+        stepNum += 1
+
+    return stepNum
+
+
+################################################################################################################################
+# Generate (The input text and the expected output lines of a kernel)
+################################################################################################################################
+
+def genRecords(kernelName, recordNum, roundNum):
+    randObj = random.Random(1)
+
+    if kernelName == 'uniform':
+        argList = [(randObj.randint(0, 65520), roundNum) for _ in range(recordNum)]
+
+        return ''.join('0 {} {}\n'.format(*x) for x in argList), [str(refHash(*x)) for x in argList]
+
+    argList = [randObj.randint(1, 100000) for _ in range(recordNum)]
+
+    return ''.join('1 {}\n'.format(x) for x in argList), [str(refCollatz(x)) for x in argList]
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare --batch with the lockstep lanes of --lanes')
+
+    parser.add_argument('--records', type=int, default=2000, help='Records per kernel')
+    parser.add_argument('--rounds', type=int, default=200, help='Hash rounds of a uniform record (At most 30000)')
+    parser.add_argument('--lanes', default='8,16', help='Lane numbers, comma separated')
+    parser.add_argument('--runs', type=int, default=3, help='Runs per kernel and lane number')
+    parser.add_argument('--word-size', type=int, default=32, help='VM word size')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    laneList = [0] + list(map(int, args.lanes.split(',')))
+    resList = []
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        asmPath, statsPath = os.path.join(tmpPath, 'lanes.asm'), os.path.join(tmpPath, 'stats.json')
+
+        subprocess.run([CMM_PATH, '--input-file-path', os.path.join(ROOT_PATH, 'bench', 'lanes.c'),
+            '--output-file-path', asmPath], check=True)
+
+        for kernelName in ['uniform', 'divergent']:
+            inputStr, expectList = genRecords(kernelName, args.records, args.rounds)
+
+            for laneNum in laneList:
+                argList = ['--lanes', str(laneNum)] if laneNum else []
+                timeList = []
+
+                for _ in range(args.runs):
+                    startTime = time.perf_counter()
+                    procObj = subprocess.run([CMM_PATH, '--asm-file-path', asmPath, '--batch', '--word-size',
+                        str(args.word_size), '--stats-json', statsPath] + argList, input=inputStr,
+                        capture_output=True, text=True)
+                    timeList.append((time.perf_counter() - startTime) * 1000.)
+
+                    if procObj.returncode:
+                        sys.exit('CMM failed with {} lanes: {}'.format(laneNum, procObj.stderr.strip()))
+
+                    if procObj.stdout.split('\n')[:-1] != expectList:
+                        sys.exit('{} ({} lanes): unexpected output'.format(kernelName, laneNum))
+
+                with open(statsPath) as f:
+                    runDict = json.load(f)['run']
+
+                resList.append({
+                    'kernel':       kernelName,
+                    'lanes':        laneNum,
+                    'wall_ms':      statistics.median(timeList),
+                    'instructions': runDict['guest_instructions'],
+                    'lane_steps':   runDict.get('lane_steps', 0),
+                    'divergences':  runDict.get('lane_divergences', 0),
+                    'fallbacks':    runDict.get('lane_fallbacks', 0),
+                })
+
+    print('{:>10}  {:>6}  {:>12}  {:>8}  {:>14}  {:>12}  {:>10}'.format('Kernel', 'Lanes', 'Wall (ms)', 'Speedup',
+        'Lanes / Step', 'Divergences', 'Fallbacks'))
+
+    for resDict in resList:
+        baseDict = next(x for x in resList if x['kernel'] == resDict['kernel'] and not x['lanes'])
+        resDict['speedup'] = baseDict['wall_ms'] / resDict['wall_ms']
+        resDict['lanes_per_step'] = resDict['instructions'] / resDict['lane_steps'] if resDict['lane_steps'] else 1.
+
+        print('{:>10}  {:>6}  {:>12.3f}  {:>8.2f}  {:>14.2f}  {:>12}  {:>10}'.format(resDict['kernel'],
+            resDict['lanes'], resDict['wall_ms'], resDict['speedup'], resDict['lanes_per_step'],
+            resDict['divergences'], resDict['fallbacks']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-lanes/1', 'records': args.records, 'rounds': args.rounds,
+                'word_size': args.word_size, 'cpus': os.cpu_count(), 'results': resList}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+'''
+    link.py
+    =======
+        Split a generated CMM program (bench/gen.py) into files of consecutive functions (The global arrays are in the
+        first one, main is in the last one), compile each file with --object and link the objects with
+        --link-file-path, check the linked program outputs the same as the compile of the whole program, and report the
+        median wall time of the whole compile, of the object compiles one by one and all at once, of the link, and of an
+        edit of one file (Its object compile and the link).
+
+        The functions call one function before them by default, since a program calling two of them takes exponential
+        time to run for the check.
+
+        Usage: bench/link.py [--funcs N] [--fanout N] [--units N] [--runs N] [-O LEVEL] [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+from gen import DEFAULT_CONFIG, Generator
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+INPUT_STR = '7\n'
+
+
+################################################################################################################################
+# Split Program (The header, the functions in order and main, regrouped to the sources of the files)
+################################################################################################################################
+
+def splitProgram(sourceStr, unitNum):
+    partList = re.split(r'\n(?=int \w+\()', sourceStr)
+    headStr, funcList, mainStr = partList[0], partList[1:-1], partList[-1]
+
+    chunkSize = -(-len(funcList) // unitNum)
+    unitList  = ['\n'.join(funcList[idx:idx + chunkSize]) for idx in range(0, len(funcList), chunkSize)]
+
+    unitList[0]  = headStr + '\n' + unitList[0]
+    unitList[-1] = unitList[-1] + '\n' + mainStr
+
+    return unitList
+
+
+################################################################################################################################
+# Time (ms) of a list of commands, one by one or all at once
+################################################################################################################################
+
+def timeCommand(cmdList, parallelBool=False):
+    startTime = time.perf_counter()
+
+    if parallelBool:
+        procList = [subprocess.Popen(cmdObj) for cmdObj in cmdList]
+
+        if any(procObj.wait() for procObj in procList):
+            sys.exit('Invalid compile')
+    else:
+        for cmdObj in cmdList:
+            subprocess.run(cmdObj, check=True)
+
+    return (time.perf_counter() - startTime) * 1000
+
+
+################################################################################################################################
+# Run (Return the output of an asm)
+################################################################################################################################
+
+def runAsm(asmPath):
+    return subprocess.run([CMM_PATH, '--asm-file-path', asmPath], input=INPUT_STR, capture_output=True, text=True,
+        check=True).stdout
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the CMM compile time of a program split into linked objects')
+
+    parser.add_argument('--funcs', type=int, default=200, help='The function number of the generated program')
+    parser.add_argument('--fanout', type=int, default=1, help='The calls of each function of the generated program')
+    parser.add_argument('--units', type=int, default=8, help='Split the program into N files')
+    parser.add_argument('--runs', type=int, default=3, help='Build N times and report the medians')
+    parser.add_argument('-O', '--opt-level', type=int, default=1, help='Optimization level: 0, 1')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    sourceStr = Generator(dict(DEFAULT_CONFIG, funcs=args.funcs, fanout=args.fanout)).genProgram()
+    unitList  = splitProgram(sourceStr, args.units)
+    optList   = ['-O', str(args.opt_level)]
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        wholePath, wholeAsmPath, linkAsmPath = [os.path.join(tmpPath, fileName) for fileName in
+            ('whole.c', 'whole.asm', 'link.asm')]
+        srcPathList = [os.path.join(tmpPath, 'unit{}.c'.format(unitIdx)) for unitIdx in range(len(unitList))]
+        objPathList = [os.path.join(tmpPath, 'unit{}.o'.format(unitIdx)) for unitIdx in range(len(unitList))]
+
+        with open(wholePath, 'w') as f:
+            f.write(sourceStr)
+
+        for srcPath, unitStr in zip(srcPathList, unitList):
+            with open(srcPath, 'w') as f:
+                f.write(unitStr)
+
+        # The edit: The first number after the middle of the middle file is changed
+        editIdx   = len(unitList) // 2
+        editStr   = unitList[editIdx]
+        numMatch  = re.compile(r'\b\d+\b').search(editStr, len(editStr) // 2)
+        editedStr = editStr[:numMatch.start()] + str(int(numMatch.group()) + 1) + editStr[numMatch.end():]
+
+        wholeCmd   = [CMM_PATH, '--input-file-path', wholePath, '--output-file-path', wholeAsmPath] + optList
+        objCmdList = [[CMM_PATH, '--input-file-path', srcPath, '--output-file-path', objPath, '--object'] + optList
+            for srcPath, objPath in zip(srcPathList, objPathList)]
+        linkCmd    = [CMM_PATH, '--link-file-path'] + objPathList + ['--output-file-path', linkAsmPath] + optList
+
+        timeDict = {timeName: [] for timeName in ('whole_ms', 'serial_ms', 'parallel_ms', 'link_ms', 'edit_ms')}
+
+        for _ in range(args.runs):
+            timeDict['whole_ms'].append(timeCommand([wholeCmd]))
+            timeDict['serial_ms'].append(timeCommand(objCmdList))
+            timeDict['parallel_ms'].append(timeCommand(objCmdList, True))
+            timeDict['link_ms'].append(timeCommand([linkCmd]))
+
+            if runAsm(wholeAsmPath) != runAsm(linkAsmPath):
+                sys.exit('Invalid output of the linked program')
+
+            # The edited file (Its object and the link), then back
+            with open(srcPathList[editIdx], 'w') as f:
+                f.write(editedStr)
+
+            timeDict['edit_ms'].append(timeCommand([objCmdList[editIdx], linkCmd]))
+
+            with open(srcPathList[editIdx], 'w') as f:
+                f.write(editStr)
+
+        resDict = {timeName: statistics.median(timeList) for timeName, timeList in timeDict.items()}
+
+    print('{:>8}{:>8}{:>12}{:>12}{:>14}{:>10}{:>12}'.format('funcs', 'units', 'Whole (ms)', 'Serial (ms)',
+        'Parallel (ms)', 'Link (ms)', 'Edit (ms)'))
+
+    print('{:>8}{:>8}{:>12.1f}{:>12.1f}{:>14.1f}{:>10.1f}{:>12.1f}'.format(args.funcs, len(unitList),
+        resDict['whole_ms'], resDict['serial_ms'], resDict['parallel_ms'], resDict['link_ms'], resDict['edit_ms']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-link-bench/1', 'opt_level': args.opt_level, 'runs': args.runs,
+                'funcs': args.funcs, 'fanout': args.fanout, 'units': len(unitList), 'results': resDict}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global (n * n matrices, flattened)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int lhsMatrix[3600];
+int rhsMatrix[3600];
+int resMatrix[3600];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Init Matrix
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+void initMatrix(int n)
+{
+    int rowIdx;
+    int colIdx;
+
+    rowIdx = 0;
+
+    while (rowIdx < n)
+    {
+        colIdx = 0;
+
+        while (colIdx < n)
+        {
+            lhsMatrix[rowIdx * n + colIdx] = (rowIdx + colIdx) - (rowIdx + colIdx) / 10 * 10;
+            rhsMatrix[rowIdx * n + colIdx] = rowIdx * colIdx - rowIdx * colIdx / 7 * 7;
+            colIdx = colIdx + 1;
+        }
+
+        rowIdx = rowIdx + 1;
+    }
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Multiply Matrix
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+void multiplyMatrix(int n)
+{
+    int rowIdx;
+    int colIdx;
+    int midIdx;
+    int sumNum;
+
+    rowIdx = 0;
+
+    while (rowIdx < n)
+    {
+        colIdx = 0;
+
+        while (colIdx < n)
+        {
+            sumNum = 0;
+            midIdx = 0;
+
+            while (midIdx < n)
+            {
+                sumNum = sumNum + lhsMatrix[rowIdx * n + midIdx] * rhsMatrix[midIdx * n + colIdx];
+                midIdx = midIdx + 1;
+            }
+
+            resMatrix[rowIdx * n + colIdx] = sumNum;
+            colIdx = colIdx + 1;
+        }
+
+        rowIdx = rowIdx + 1;
+    }
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+    int idx;
+    int sumNum;
+
+    n = input();
+
+    initMatrix(n);
+    multiplyMatrix(n);
+
+    idx = 0;
+    sumNum = 0;
+
+    while (idx < n * n)
+    {
+        sumNum = sumNum + resMatrix[idx];
+        idx = idx + 1;
+    }
+
+    output(sumNum);
+    output(resMatrix[n * n - 1]);
+}
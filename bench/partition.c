@@ -0,0 +1,68 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+/* memoArray[n * 200 + k] is the result + 1 (0 for unknown) */
+int memoArray[40000];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count Partition (The partitions of n into parts <= k, mod 1000007, memoized recursion)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int countPartition(int n, int k)
+{
+    int resNum;
+
+    if (n == 0)
+    {
+        return 1;
+    }
+
+    if (k == 0)
+    {
+        return 0;
+    }
+
+    if (memoArray[n * 200 + k] > 0)
+    {
+        return memoArray[n * 200 + k] - 1;
+    }
+
+    if (k > n)
+    {
+        resNum = countPartition(n, n);
+    }
+    else
+    {
+        resNum = countPartition(n, k - 1) + countPartition(n - k, k);
+        resNum = resNum - resNum / 1000007 * 1000007;
+    }
+
+    memoArray[n * 200 + k] = resNum + 1;
+
+    return resNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+    int idx;
+
+    n = input();
+    idx = 0;
+
+    /* The globals are not zero initialized */
+    while (idx < 40000)
+    {
+        memoArray[idx] = 0;
+        idx = idx + 1;
+    }
+
+    output(countPartition(n, n));
+}
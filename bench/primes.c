@@ -0,0 +1,85 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int primeNum[1];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Is Prime (Trial division)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int isPrime(int n)
+{
+    int divNum;
+
+    if (n < 2)
+    {
+        return 0;
+    }
+
+    divNum = 2;
+
+    while (divNum * divNum <= n)
+    {
+        if (n - n / divNum * divNum == 0)
+        {
+            return 0;
+        }
+
+        divNum = divNum + 1;
+    }
+
+    return 1;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count Prime (The primes in [lo, hi), split into a task per chunk of chunkSize ints)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int countPrime(int lo, int hi, int chunkSize)
+{
+    int mid;
+    int taskId;
+    int localNum;
+
+    if (hi - lo <= chunkSize)
+    {
+        localNum = 0;
+
+        while (lo < hi)
+        {
+            localNum = localNum + isPrime(lo);
+            lo = lo + 1;
+        }
+
+        atomicAdd(primeNum, 0, localNum);
+
+        return localNum;
+    }
+
+    mid = (lo + hi) / 2;
+    taskId = spawn(countPrime, lo, mid, chunkSize);
+    localNum = countPrime(mid, hi, chunkSize);
+
+    return join(taskId) + localNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (Read N and the chunk size, write the primes < N, by the joins and by the atomic counter)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int maxNum;
+    int chunkSize;
+
+    maxNum = input();
+    chunkSize = input();
+    primeNum[0] = 0;
+
+    output(countPrime(0, maxNum, chunkSize));
+    output(primeNum[0]);
+}
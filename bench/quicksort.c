@@ -0,0 +1,114 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int numArray[100000];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Init Num List (A linear congruential generator)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+void initNumList(int numArray[], int n)
+{
+    int idx;
+    int seedNum;
+
+    idx = 0;
+    seedNum = 1;
+
+    while (idx < n)
+    {
+        seedNum = seedNum * 1103 + 12345;
+        seedNum = seedNum - seedNum / 65536 * 65536;
+        numArray[idx] = seedNum;
+        idx = idx + 1;
+    }
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Partition (Lomuto, the last one is the pivot)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int partitionNumList(int numArray[], int beginIdx, int endIdx)
+{
+    int pivotNum;
+    int lowIdx;
+    int nowIdx;
+    int tmpNum;
+
+    pivotNum = numArray[endIdx - 1];
+    lowIdx = beginIdx;
+    nowIdx = beginIdx;
+
+    while (nowIdx < endIdx - 1)
+    {
+        if (numArray[nowIdx] < pivotNum)
+        {
+            tmpNum = numArray[nowIdx];
+            numArray[nowIdx] = numArray[lowIdx];
+            numArray[lowIdx] = tmpNum;
+            lowIdx = lowIdx + 1;
+        }
+
+        nowIdx = nowIdx + 1;
+    }
+
+    numArray[endIdx - 1] = numArray[lowIdx];
+    numArray[lowIdx] = pivotNum;
+
+    return lowIdx;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Sort Num List (Quicksort of [beginIdx, endIdx))
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+void sortNumList(int numArray[], int beginIdx, int endIdx)
+{
+    int pivotIdx;
+
+    if (endIdx - beginIdx > 1)
+    {
+        pivotIdx = partitionNumList(numArray, beginIdx, endIdx);
+        sortNumList(numArray, beginIdx, pivotIdx);
+        sortNumList(numArray, pivotIdx + 1, endIdx);
+    }
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+    int idx;
+    int sortedBool;
+
+    n = input();
+
+    initNumList(numArray, n);
+    sortNumList(numArray, 0, n);
+
+    idx = 1;
+    sortedBool = 1;
+
+    while (idx < n)
+    {
+        if (numArray[idx - 1] > numArray[idx])
+        {
+            sortedBool = 0;
+        }
+
+        idx = idx + 1;
+    }
+
+    output(sortedBool);
+    output(numArray[0]);
+    output(numArray[n / 2]);
+    output(numArray[n - 1]);
+}
@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+
+'''
+    run.py
+    ======
+        Compile and run each bench program several times, check the outputs and report the medians of the compile
+        time, run time and guest instructions per second. The check programs are run first at each -O (And word size).
+
+        Usage: bench/run.py [--runs N] [-O LEVEL] [--json PATH] [NAME ...]
+'''
+
+import argparse
+import json
+import os
+import random
+import statistics
+import subprocess
+import sys
+import tempfile
+
+from gen import Generator
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+################################################################################################################################
+# Reference Implementations (Input list -> Expected output list)
+################################################################################################################################
+
+def refSieve(maxNum):
+    isComposite = bytearray(maxNum + 1)
+    primeNum = 0
+
+    for nowNum in range(2, maxNum + 1):
+        if not isComposite[nowNum]:
+            primeNum += 1
+            isComposite[nowNum * nowNum::nowNum] = b'\x01' * len(range(nowNum * nowNum, maxNum + 1, nowNum))
+
+    return [primeNum]
+
+
+def refFib(n):
+    lhsNum, rhsNum = 0, 1
+
+    for _ in range(n):
+        lhsNum, rhsNum = rhsNum, lhsNum + rhsNum
+
+    return [lhsNum]
+
+
+def refPartition(n):
+    # The partitions of n, mod 1000007
+    partitionList = [1] + [0] * n
+
+    for partNum in range(1, n + 1):
+        for sumNum in range(partNum, n + 1):
+            partitionList[sumNum] = (partitionList[sumNum] + partitionList[sumNum - partNum]) % 1000007
+
+    return [partitionList[n]]
+
+
+def refMatmul(n):
+    lhsMatrix = [[(i + j) % 10 for j in range(n)] for i in range(n)]
+    rhsMatrix = [[i * j % 7 for j in range(n)] for i in range(n)]
+    resMatrix = [[sum(lhsMatrix[i][k] * rhsMatrix[k][j] for k in range(n)) for j in range(n)] for i in range(n)]
+
+    return [sum(map(sum, resMatrix)), resMatrix[-1][-1]]
+
+
+def refQuicksort(n):
+    numList, seedNum = [], 1
+
+    for _ in range(n):
+        seedNum = (seedNum * 1103 + 12345) % 65536
+        numList.append(seedNum)
+
+    numList.sort()
+
+    return [1, numList[0], numList[n // 2], numList[-1]]
+
+
+def refBsearch(n, queryNum):
+    resList = [(idx * 7 - 1) // 3 for idx in range(queryNum) if idx * 7 % 3 == 1 and (idx * 7 - 1) // 3 < n]
+
+    return [len(resList), sum(resList)]
+
+
+def refTokenizer(n, *charList):
+    text = ''.join(map(chr, charList))
+    idNum = numberNum = opNum = sumNum = idx = 0
+
+    while idx < n:
+        if text[idx] in ' \t\n\v\f\r':
+            idx += 1
+        elif text[idx].isascii() and (text[idx].isalpha() or text[idx] == '_'):
+            while idx < n and text[idx].isascii() and (text[idx].isalnum() or text[idx] == '_'):
+                idx += 1
+
+            idNum += 1
+        elif text[idx].isdigit():
+            valNum = 0
+
+            while idx < n and text[idx].isdigit():
+                valNum = (valNum * 10 + int(text[idx])) % 1000007
+                idx += 1
+
+            numberNum += 1
+            sumNum = (sumNum + valNum) % 1000007
+        else:
+            opNum += 1
+            idx += 1
+
+    return [idNum, numberNum, opNum, sumNum]
+
+
+################################################################################################################################
+# Input Generators
+################################################################################################################################
+
+def refWrap(wordSize):
+    return [wrapWord(2000000000 + 2000000000, wordSize), wrapWord(65536 * 65536, wordSize)]
+
+
+def wrapWord(num, wordSize):
+    num &= (1 << wordSize) - 1
+
+    return num - (1 << wordSize) if num >> (wordSize - 1) else num
+
+
+def genTokenizerInput(charNum):
+    # A deterministic C-like text
+    randomObj = random.Random(1)
+    wordList = ['int', 'while', 'if', 'else', 'return', 'numArray', 'idx', 'sum_num', 'x1', 'tmp']
+    opList = ['+', '-', '*', '/', '=', '==', '<=', '(', ')', '[', ']', '{', '}', ';', ',']
+    text = ''
+
+    while len(text) < charNum:
+        tokenType = randomObj.randrange(3)
+
+        if tokenType == 0:
+            text += randomObj.choice(wordList)
+        elif tokenType == 1:
+            text += str(randomObj.randrange(10 ** randomObj.randrange(1, 10)))
+        else:
+            text += randomObj.choice(opList)
+
+        text += randomObj.choice([' ', ' ', '', '\n', '\t'])
+
+    text = text[:charNum]
+
+    return [len(text)] + [ord(curChar) for curChar in text]
+
+
+################################################################################################################################
+# Bench List: (Name, Input list, Reference)
+################################################################################################################################
+
+BENCH_LIST = [
+    ('sieve',     [100000],                    refSieve),
+    ('fib',       [27],                        refFib),
+    ('partition', [199],                       refPartition),
+    ('matmul',    [60],                        refMatmul),
+    ('quicksort', [10000],                     refQuicksort),
+    ('bsearch',   [50000, 10000],              refBsearch),
+    ('tokenizer', genTokenizerInput(100000),   refTokenizer),
+]
+
+
+# The programs checked at each -O and word size before the benches (The const folding of -O2 has to compute in the VM
+# word): (Name, Reference by the word size)
+CHECK_LIST = [
+    ('wrap', refWrap),
+]
+
+# The generated programs (bench/gen.py) checked at each -O against the output of -O0, and for a -O2 compile time over
+# MAX_COMPILE_RATIO times the -O1 one (The -O2 passes were quadratic in the inlined call sites): (Name, gen.py config)
+GEN_CHECK_LIST = [
+    ('call-sites', {'funcs': 2, 'stmts': 4, 'call_sites': 2000}),
+]
+
+MAX_COMPILE_RATIO = 10
+
+
+################################################################################################################################
+# Run CMM (Return the stats JSON)
+################################################################################################################################
+
+def runCMM(argList, tmpPath):
+    statsPath = os.path.join(tmpPath, 'stats.json')
+
+    subprocess.run([CMM_PATH] + argList + ['--stats-json', statsPath], check=True)
+
+    with open(statsPath) as f:
+        return json.load(f)
+
+
+################################################################################################################################
+# Run Check
+################################################################################################################################
+
+def runCheck(checkName, refFunc, tmpPath):
+    srcPath    = os.path.join(ROOT_PATH, 'bench', checkName + '.c')
+    asmPath    = os.path.join(tmpPath, checkName + '.asm')
+    outputPath = os.path.join(tmpPath, checkName + '.out')
+
+    for optLevel in range(3):
+        for wordSize in [32, 64]:
+            wordList = ['--word-size', str(wordSize)]
+
+            runCMM(['--input-file-path', srcPath, '--output-file-path', asmPath, '-O', str(optLevel)] + wordList,
+                tmpPath)
+            runCMM(['--asm-file-path', asmPath, '--input-file', os.devnull, '--output-file', outputPath] + wordList,
+                tmpPath)
+
+            with open(outputPath) as f:
+                outputList = list(map(int, f.read().split()))
+
+            if outputList != refFunc(wordSize):
+                sys.exit('{} (-O {}, --word-size {}): expect {}, got {}'.format(checkName, optLevel, wordSize,
+                    refFunc(wordSize), outputList))
+
+
+def runGenCheck(checkName, configDict, tmpPath):
+    srcPath    = os.path.join(tmpPath, checkName + '.c')
+    asmPath    = os.path.join(tmpPath, checkName + '.asm')
+    inputPath  = os.path.join(tmpPath, checkName + '.in')
+    outputPath = os.path.join(tmpPath, checkName + '.out')
+
+    with open(srcPath, 'w') as f:
+        f.write(Generator(configDict).genProgram())
+
+    with open(inputPath, 'w') as f:
+        f.write('7\n')
+
+    compileTimeList, outputListList = [], []
+
+    for optLevel in range(3):
+        statsDict = runCMM(['--input-file-path', srcPath, '--output-file-path', asmPath, '-O', str(optLevel)], tmpPath)
+        compileTimeList.append(statsDict['compile']['wall_ms'])
+
+        runCMM(['--asm-file-path', asmPath, '--input-file', inputPath, '--output-file', outputPath], tmpPath)
+
+        with open(outputPath) as f:
+            outputListList.append(list(map(int, f.read().split())))
+
+        if outputListList[-1] != outputListList[0]:
+            sys.exit('{} (-O {}): expect {}, got {}'.format(checkName, optLevel, outputListList[0],
+                outputListList[-1]))
+
+    if compileTimeList[2] > compileTimeList[1] * MAX_COMPILE_RATIO:
+        sys.exit('{}: -O2 compiles in {:.3f} ms, over {} times the {:.3f} ms of -O1'.format(checkName,
+            compileTimeList[2], MAX_COMPILE_RATIO, compileTimeList[1]))
+
+
+################################################################################################################################
+# Run Bench
+################################################################################################################################
+
+def runBench(benchName, inputList, refFunc, runNum, optLevel, tmpPath):
+    srcPath    = os.path.join(ROOT_PATH, 'bench', benchName + '.c')
+    asmPath    = os.path.join(tmpPath, benchName + '.asm')
+    inputPath  = os.path.join(tmpPath, benchName + '.in')
+    outputPath = os.path.join(tmpPath, benchName + '.out')
+
+    with open(inputPath, 'w') as f:
+        f.write('\n'.join(map(str, inputList)) + '\n')
+
+    expectList = refFunc(*inputList)
+    compileTimeList, runTimeList = [], []
+
+    for _ in range(runNum):
+        statsDict = runCMM(['--input-file-path', srcPath, '--output-file-path', asmPath, '-O', str(optLevel)], tmpPath)
+        compileTimeList.append(statsDict['compile']['wall_ms'])
+
+        statsDict = runCMM(['--asm-file-path', asmPath, '--input-file', inputPath, '--output-file', outputPath], tmpPath)
+        runTimeList.append(statsDict['run']['wall_ms'])
+        guestInsNum = statsDict['run']['guest_instructions']
+
+        with open(outputPath) as f:
+            outputList = list(map(int, f.read().split()))
+
+        if outputList != expectList:
+            sys.exit('{}: expect {}, got {}'.format(benchName, expectList, outputList))
+
+    compileTime = statistics.median(compileTimeList)
+    runTime     = statistics.median(runTimeList)
+
+    return {
+        'name':               benchName,
+        'compile_ms':         compileTime,
+        'run_ms':             runTime,
+        'guest_instructions': guestInsNum,
+        'mips':               guestInsNum / runTime / 1000. if runTime else 0.,
+    }
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the CMM bench suite')
+
+    parser.add_argument('--runs', type=int, default=3, help='Run each program N times and report the medians')
+    parser.add_argument('-O', '--opt-level', type=int, default=1, help='Optimization level: 0, 1, 2 (SSA)')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+    parser.add_argument('nameList', metavar='NAME', nargs='*', help='Only run the named programs')
+
+    args = parser.parse_args()
+
+    for benchName in args.nameList:
+        if benchName not in [benchTuple[0] for benchTuple in BENCH_LIST]:
+            sys.exit('Invalid bench name: ' + benchName)
+
+    resList = []
+
+    print('{:<12}{:>16}{:>16}{:>16}{:>20}'.format('Benchmark', 'Compile (ms)', 'Run (ms)', 'Guest Ins',
+        'M guest ins/s'))
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        for checkName, refFunc in CHECK_LIST:
+            runCheck(checkName, refFunc, tmpPath)
+
+        for checkName, configDict in GEN_CHECK_LIST:
+            runGenCheck(checkName, configDict, tmpPath)
+
+        for benchName, inputList, refFunc in BENCH_LIST:
+            if args.nameList and benchName not in args.nameList:
+                continue
+
+            resDict = runBench(benchName, inputList, refFunc, args.runs, args.opt_level, tmpPath)
+            resList.append(resDict)
+
+            print('{:<12}{:>16.3f}{:>16.3f}{:>16}{:>20.3f}'.format(resDict['name'], resDict['compile_ms'],
+                resDict['run_ms'], resDict['guest_instructions'], resDict['mips']), flush=True)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-bench/1', 'opt_level': args.opt_level, 'runs': args.runs,
+                'results': resList}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+
+'''
+    scale.py
+    ========
+        Compile the generated CMM programs (bench/gen.py) of growing sizes along one dimension, and report the median
+        time of each __Compiler phase with the scaling exponent of the total time between two sizes (About 1 for the
+        linear phases, about 2 for the quadratic ones).
+
+        Exits non-zero if a phase or a pass grows faster than the tokens^X (--max-exponent, fitted over all the sizes),
+        or a pass takes more than X times the tokenizer at a size (--max-ratio), such as a pass doing more rounds on a
+        longer function.
+
+        "--dim call-sites" grows the calls of a small leaf function in main, which -O 2 inlines at each call site (So
+        inline and simplifycfg see one long main).
+
+        Usage: bench/scale.py [--dim DIM] [--sizes N,N,...] [--runs N] [-O LEVEL] [--max-exponent X] [--max-ratio X]
+                              [--json PATH]
+'''
+
+import argparse
+import json
+import math
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+from gen import DEFAULT_CONFIG, Generator
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+################################################################################################################################
+# Dimension -> (Config key, Default sizes, Base config over gen.py's DEFAULT_CONFIG)
+################################################################################################################################
+
+DIM_DICT = {
+    'funcs':      ('funcs',      [25, 50, 100, 200, 400],                 {}),
+    'stmts':      ('stmts',      [25, 50, 100, 200, 400],                 {}),
+    'depth':      ('depth',      [25, 50, 100, 200, 400],                 {}),
+    'array-size': ('array_size', [10000, 20000, 40000, 80000, 160000],    {}),
+    'fanout':     ('fanout',     [1, 2, 4, 8, 16],                        {}),
+
+    # A small rest of the program, so the tokens grow with the call sites (A call costs more than an average token)
+    'call-sites': ('call_sites', [500, 1000, 2000, 4000, 8000],           {'funcs': 2, 'stmts': 4}),
+}
+
+# The sizes where a phase or a pass is faster than it (ms) are not checked, their time is mostly noise
+MIN_CHECK_MS = 5
+
+
+################################################################################################################################
+# Compile (Return the "compile" part of the stats JSON)
+################################################################################################################################
+
+def compileProgram(srcPath, optLevel, tmpPath):
+    statsPath = os.path.join(tmpPath, 'stats.json')
+
+    subprocess.run([CMM_PATH, '--input-file-path', srcPath, '--output-file-path', os.path.join(tmpPath, 'gen.asm'),
+        '-O', str(optLevel), '--stats-json', statsPath], check=True)
+
+    with open(statsPath) as f:
+        return json.load(f)['compile']
+
+
+################################################################################################################################
+# Run Size
+################################################################################################################################
+
+def runSize(configDict, runNum, optLevel, tmpPath):
+    srcPath = os.path.join(tmpPath, 'gen.c')
+
+    with open(srcPath, 'w') as f:
+        f.write(Generator(configDict).genProgram())
+
+    compileList = [compileProgram(srcPath, optLevel, tmpPath) for _ in range(runNum)]
+
+    return {
+        'config':       configDict,
+        'tokens':       compileList[0]['tokens'],
+        'ast_nodes':    compileList[0]['ast_nodes'],
+        'instructions': compileList[0]['instructions'],
+        'phases_ms':    {phaseName: statistics.median(compileDict['phases_ms'][phaseName]
+            for compileDict in compileList) for phaseName in compileList[0]['phases_ms']},
+        'passes_ms':    {passDict['name']: statistics.median(compileDict['passes_ms'][passIdx]['ms']
+            for compileDict in compileList) for passIdx, passDict in enumerate(compileList[0]['passes_ms'])},
+        'wall_ms':      statistics.median(compileDict['wall_ms'] for compileDict in compileList),
+    }
+
+
+################################################################################################################################
+# Check Time (Return the failures: The phases and passes growing faster than tokens^maxExponent, and the passes taking
+# more than maxRatio times the tokenizer at a size)
+################################################################################################################################
+
+def checkTime(resList, maxExponent, maxRatio):
+    failList = []
+
+    for timeName in dict(resList[-1]['phases_ms'], **resList[-1]['passes_ms']):
+        # The sizes where it takes long enough to be measured
+        pointList = [(math.log(resDict['tokens']), math.log(timeDict[timeName])) for resDict in resList
+            for timeDict in [dict(resDict['phases_ms'], **resDict['passes_ms'])]
+            if timeDict.get(timeName, 0) >= MIN_CHECK_MS]
+
+        # The tokens must grow enough for a stable exponent (Not along --dim array-size)
+        if len(pointList) < 2 or pointList[-1][0] - pointList[0][0] < math.log(2):
+            continue
+
+        # The least squares slope of log(T) by log(Tokens), so one noisy size does not decide it
+        xMean = sum(x for x, _ in pointList) / len(pointList)
+        yMean = sum(y for _, y in pointList) / len(pointList)
+        exponentNum = sum((x - xMean) * (y - yMean) for x, y in pointList) / sum((x - xMean) ** 2 for x, _ in pointList)
+
+        if exponentNum > maxExponent:
+            failList.append('{} grows as tokens^{:.2f} (Over {})'.format(timeName, exponentNum, maxExponent))
+
+    # A pass many times slower than the linear tokenizer is a regression even if it grows slowly along the dimension
+    # (Such as the rounds of a pass depending on the function length, not on the function number)
+    for passName in resList[-1]['passes_ms']:
+        for resDict in resList:
+            passMs, tokenMs = resDict['passes_ms'].get(passName, 0), resDict['phases_ms']['__constructTokenList']
+
+            if passMs >= MIN_CHECK_MS and tokenMs > 0 and passMs > tokenMs * maxRatio:
+                failList.append('{} takes {:.1f}x the tokenizer at {} tokens (Over {})'.format(passName,
+                    passMs / tokenMs, resDict['tokens'], maxRatio))
+                break
+
+    return failList
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the CMM compile time scaling')
+
+    parser.add_argument('--dim', choices=list(DIM_DICT), default='funcs', help='The dimension to grow')
+    parser.add_argument('--sizes', help='The comma separated sizes (Default: 5 doublings)')
+    parser.add_argument('--runs', type=int, default=3, help='Compile each program N times and report the medians')
+    parser.add_argument('-O', '--opt-level', type=int, default=1, help='Optimization level: 0, 1, 2 (SSA)')
+    parser.add_argument('--passes', action='store_true', help='Also report each pass in the table')
+    parser.add_argument('--max-exponent', type=float, default=1.4,
+        help='Fail if a phase or a pass grows faster than tokens^X (Default: 1.4)')
+    parser.add_argument('--max-ratio', type=float, default=30,
+        help='Fail if a pass takes more than X times the tokenizer at a size (Default: 30)')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    configKey, sizeList, baseDict = DIM_DICT[args.dim]
+
+    if args.sizes:
+        try:
+            sizeList = [int(sizeStr) for sizeStr in args.sizes.split(',')]
+        except ValueError:
+            sys.exit('Invalid sizes: ' + args.sizes)
+
+    resList = []
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        for sizeNum in sizeList:
+            resDict = runSize(dict(DEFAULT_CONFIG, **baseDict, **{configKey: sizeNum}), args.runs, args.opt_level, tmpPath)
+
+            # The first row prints the header
+            if not resList:
+                columnList = list(resDict['phases_ms']) + (list(resDict['passes_ms']) if args.passes else [])
+
+                print('{:>10}{:>10}'.format(args.dim, 'Tokens') +
+                    ''.join('{:>{}}'.format(columnName, max(len(columnName), 8) + 2) for columnName in columnList) +
+                    '{:>12}{:>10}'.format('Total (ms)', 'Exponent'))
+
+            timeDict = dict(resDict['phases_ms'], **resDict['passes_ms'])
+
+            # log(T2 / T1) / log(N2 / N1)
+            if resList and resList[-1]['wall_ms'] > 0 and sizeNum != resList[-1]['config'][configKey]:
+                exponentStr = '{:.2f}'.format(math.log(resDict['wall_ms'] / resList[-1]['wall_ms']) /
+                    math.log(sizeNum / resList[-1]['config'][configKey]))
+            else:
+                exponentStr = '-'
+
+            print('{:>10}{:>10}'.format(sizeNum, resDict['tokens']) +
+                ''.join('{:>{}.3f}'.format(timeDict[columnName], max(len(columnName), 8) + 2)
+                    for columnName in columnList) +
+                '{:>12.3f}{:>10}'.format(resDict['wall_ms'], exponentStr), flush=True)
+
+            resList.append(resDict)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-scale/1', 'dim': args.dim, 'opt_level': args.opt_level, 'runs': args.runs,
+                'results': resList}, f, indent=4)
+            f.write('\n')
+
+    failList = checkTime(resList, args.max_exponent, args.max_ratio)
+
+    for failStr in failList:
+        print(failStr, file=sys.stderr)
+
+    if failList:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+
+'''
+    serve.py
+    ========
+        Load test of "CMM --serve": start a server on a temporary socket, send requests (bench/fib.c with a small n,
+        compiled by each request, or its asm with --asm) from concurrent clients, check the outputs and report the
+        p50 / p99 / max latency and the throughput, with the latency of a cold CMM process per request to compare.
+
+        Usage: bench/serve.py [--clients N] [--requests N] [--n N] [--asm] [--jobs N] [--cold-runs N] [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+from client import Client
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+FIB_PATH  = os.path.join(ROOT_PATH, 'bench', 'fib.c')
+
+################################################################################################################################
+# Reference Implementation
+################################################################################################################################
+
+def refFib(n):
+    lhsNum, rhsNum = 0, 1
+
+    for _ in range(n):
+        lhsNum, rhsNum = rhsNum, lhsNum + rhsNum
+
+    return lhsNum
+
+
+################################################################################################################################
+# Percentile (Of a sorted list)
+################################################################################################################################
+
+def getPercentile(sortedList, percentNum):
+    return sortedList[min(int(len(sortedList) * percentNum / 100.), len(sortedList) - 1)]
+
+
+################################################################################################################################
+# Run Client (The latencies (ms) of its requests to timeList)
+################################################################################################################################
+
+def runClient(socketPath, codeStr, kindStr, n, requestNum, timeList, errorList):
+    try:
+        clientObj = Client(socketPath)
+
+        for _ in range(requestNum):
+            startTime = time.perf_counter()
+            statusStr, outputStr, statsDict = clientObj.run(codeStr, '{}\n'.format(n), kindStr)
+            timeList.append((time.perf_counter() - startTime) * 1000.)
+
+            if statusStr != 'ok' or outputStr.split() != [str(refFib(n))]:
+                errorList.append('{}: {!r} {}'.format(statusStr, outputStr, statsDict['error']))
+
+                break
+
+        clientObj.close()
+    except (OSError, ValueError) as errObj:
+        errorList.append(str(errObj))
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Load test of CMM --serve')
+
+    parser.add_argument('--clients', type=int, default=4, help='Concurrent clients, a connection each')
+    parser.add_argument('--requests', type=int, default=500, help='Requests per client')
+    parser.add_argument('--n', type=int, default=10, help='The fib(n) of each request')
+    parser.add_argument('--asm', action='store_true', help='Send the compiled asm instead of the source')
+    parser.add_argument('--jobs', type=int, default=0, help='Server workers (Default: one per CPU)')
+    parser.add_argument('--cold-runs', type=int, default=20, help='Runs of a cold CMM process per request')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        socketPath, asmPath = os.path.join(tmpPath, 'serve.sock'), os.path.join(tmpPath, 'fib.asm')
+
+        subprocess.run([CMM_PATH, '--input-file-path', FIB_PATH, '--output-file-path', asmPath], check=True)
+
+        with open(asmPath if args.asm else FIB_PATH) as f:
+            codeStr = f.read()
+
+        # The cold latency: A CMM process compiling (Unless --asm) and running the program
+        coldList = []
+
+        for _ in range(args.cold_runs):
+            startTime = time.perf_counter()
+            subprocess.run([CMM_PATH, '--asm-file-path', asmPath] + ([] if args.asm else ['--input-file-path',
+                FIB_PATH, '--output-file-path', asmPath]), input='{}\n'.format(args.n), capture_output=True,
+                check=True, text=True)
+            coldList.append((time.perf_counter() - startTime) * 1000.)
+
+        serverObj = subprocess.Popen([CMM_PATH, '--serve', socketPath, '--jobs', str(args.jobs)],
+            stderr=subprocess.DEVNULL)
+
+        try:
+            while not os.path.exists(socketPath):
+                if serverObj.poll() is not None:
+                    sys.exit('CMM --serve failed')
+
+                time.sleep(0.01)
+
+            timeList, errorList = [], []
+            threadList = [threading.Thread(target=runClient, args=(socketPath, codeStr, 'asm' if args.asm else 'cmm',
+                args.n, args.requests, timeList, errorList)) for _ in range(args.clients)]
+
+            startTime = time.perf_counter()
+
+            for threadObj in threadList:
+                threadObj.start()
+
+            for threadObj in threadList:
+                threadObj.join()
+
+            wallTime = time.perf_counter() - startTime
+        finally:
+            serverObj.terminate()
+            serverObj.wait()
+
+    if errorList:
+        sys.exit('Failed requests: {}'.format(errorList[0]))
+
+    timeList.sort()
+    coldList.sort()
+
+    resDict = {
+        'requests':    len(timeList),
+        'p50_ms':      getPercentile(timeList, 50),
+        'p99_ms':      getPercentile(timeList, 99),
+        'max_ms':      timeList[-1],
+        'rps':         len(timeList) / wallTime,
+        'cold_p50_ms': getPercentile(coldList, 50),
+        'cold_p99_ms': getPercentile(coldList, 99),
+    }
+
+    print('{:>10}  {:>10}  {:>10}  {:>10}  {:>10}  {:>14}  {:>14}'.format('Requests', 'p50 (ms)', 'p99 (ms)',
+        'Max (ms)', 'Req / s', 'Cold p50 (ms)', 'Cold p99 (ms)'))
+    print('{:>10}  {:>10.3f}  {:>10.3f}  {:>10.3f}  {:>10.1f}  {:>14.3f}  {:>14.3f}'.format(resDict['requests'],
+        resDict['p50_ms'], resDict['p99_ms'], resDict['max_ms'], resDict['rps'], resDict['cold_p50_ms'],
+        resDict['cold_p99_ms']))
+    print('{} clients, {} CPUs'.format(args.clients, os.cpu_count()))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-serve-load/1', 'clients': args.clients, 'n': args.n, 'asm': args.asm,
+                'jobs': args.jobs, 'cpus': os.cpu_count(), 'results': resDict}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,61 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int isComposite[200001];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count Prime (Sieve of Eratosthenes, the primes <= maxNum)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int countPrime(int maxNum)
+{
+    int nowNum;
+    int mulNum;
+    int primeNum;
+
+    nowNum = 2;
+
+    while (nowNum <= maxNum)
+    {
+        isComposite[nowNum] = 0;
+        nowNum = nowNum + 1;
+    }
+
+    nowNum = 2;
+    primeNum = 0;
+
+    while (nowNum <= maxNum)
+    {
+        if (isComposite[nowNum] == 0)
+        {
+            primeNum = primeNum + 1;
+            mulNum = nowNum * nowNum;
+
+            /* nowNum * nowNum may overflow, so check nowNum first */
+            if (nowNum <= maxNum / nowNum)
+            {
+                while (mulNum <= maxNum)
+                {
+                    isComposite[mulNum] = 1;
+                    mulNum = mulNum + nowNum;
+                }
+            }
+        }
+
+        nowNum = nowNum + 1;
+    }
+
+    return primeNum;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    output(countPrime(input()));
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+
+'''
+    stream.py
+    =========
+        Run many instances of bench/collatz.c with "CMM --stream", feed their inputs in random chunks with random
+        delays, check the outputs of each instance and report the throughput and the latency from the last input of an
+        instance to its end. A parked instance does not hold a worker, so the workers keep running the other ones.
+
+        Usage: bench/stream.py [--instances N] [--values N] [--max-delay-ms MS] [--jobs N] [--quantum N] [--seed N]
+                               [--min-values-per-s N] [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import random
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+################################################################################################################################
+# Reference Implementation (The Collatz steps of a value)
+################################################################################################################################
+
+def refCollatz(n):
+    stepNum = 0
+
+    while n != 1:
+        n = n // 2 if n % 2 == 0 else n * 3 + 1
+        stepNum += 1
+
+    return stepNum
+
+
+################################################################################################################################
+# Gen Line List (The "Id Int ..." lines of all the instances, merged in a random order)
+################################################################################################################################
+
+def genLineList(instanceNum, valueNum, rng):
+    valueDict, pendingList = {}, []
+
+    for instanceId in range(1, instanceNum + 1):
+        valueList = [rng.randint(1, 1000) for _ in range(valueNum)]
+        valueDict[instanceId] = valueList
+
+        # The count first, then the values by chunks of 1 to 3
+        lineList, valueIdx = [[valueNum]], 0
+
+        while valueIdx < valueNum:
+            chunkSize = rng.randint(1, 3)
+            lineList.append(valueList[valueIdx:valueIdx + chunkSize])
+            valueIdx += chunkSize
+
+        pendingList.append((instanceId, lineList))
+
+    mergeList = []
+
+    while pendingList:
+        pendingIdx = rng.randrange(len(pendingList))
+        instanceId, lineList = pendingList[pendingIdx]
+
+        mergeList.append((instanceId, '{} {}\n'.format(instanceId, ' '.join(map(str, lineList.pop(0))))))
+
+        if not lineList:
+            pendingList[pendingIdx] = pendingList[-1]
+            pendingList.pop()
+
+    return valueDict, mergeList
+
+
+################################################################################################################################
+# Feed (Write the lines with random delays, and the send time of the last line of each instance)
+################################################################################################################################
+
+def feed(procObj, lineList, maxDelay, rng, lastTimeDict):
+    for instanceId, lineStr in lineList:
+        if maxDelay:
+            time.sleep(rng.uniform(0, maxDelay))
+
+        # Before the write, the instance may end before it returns
+        lastTimeDict[instanceId] = time.perf_counter()
+        procObj.stdin.write(lineStr)
+        procObj.stdin.flush()
+
+    procObj.stdin.close()
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Feed many CMM stream instances with random delays')
+
+    parser.add_argument('--instances', type=int, default=200, help='Instances')
+    parser.add_argument('--values', type=int, default=20, help='Values per instance')
+    parser.add_argument('--max-delay-ms', type=float, default=1., help='Max delay before each input line')
+    parser.add_argument('--jobs', type=int, default=0, help='Worker threads (Default: one per CPU)')
+    parser.add_argument('--quantum', type=int, default=0, help='Instructions per slice (Default: the CMM one)')
+    parser.add_argument('--seed', type=int, default=1, help='Random seed')
+    parser.add_argument('--min-values-per-s', type=float, default=0., help='Fail below this throughput')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    valueDict, lineList = genLineList(args.instances, args.values, rng)
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        asmPath, statsPath = os.path.join(tmpPath, 'collatz.asm'), os.path.join(tmpPath, 'stats.json')
+
+        subprocess.run([CMM_PATH, '--input-file-path', os.path.join(ROOT_PATH, 'bench', 'collatz.c'),
+            '--output-file-path', asmPath], check=True)
+
+        procObj = subprocess.Popen([CMM_PATH, '--asm-file-path', asmPath, '--stream', '--jobs', str(args.jobs),
+            '--quantum', str(args.quantum), '--stats-json', statsPath], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+            text=True, bufsize=1)
+
+        lastTimeDict, outputDict, endTimeDict = {}, {instanceId: [] for instanceId in valueDict}, {}
+
+        startTime = time.perf_counter()
+        feedThread = threading.Thread(target=feed,
+            args=(procObj, lineList, args.max_delay_ms / 1000., random.Random(args.seed + 1), lastTimeDict))
+        feedThread.start()
+
+        for lineStr in procObj.stdout:
+            idStr, valueStr = lineStr.split()
+
+            if valueStr == '.':
+                endTimeDict[int(idStr)] = time.perf_counter()
+            else:
+                outputDict[int(idStr)].append(int(valueStr))
+
+        feedThread.join()
+
+        if procObj.wait():
+            sys.exit('CMM failed: {}'.format(procObj.returncode))
+
+        wallTime = time.perf_counter() - startTime
+        feedTime = max(lastTimeDict.values()) - startTime
+
+        with open(statsPath) as f:
+            runDict = json.load(f)['run']
+
+    for instanceId, valueList in valueDict.items():
+        expectList = [refCollatz(value) for value in valueList]
+
+        if outputDict[instanceId] != expectList or instanceId not in endTimeDict:
+            sys.exit('Instance {}: expect {}, got {}'.format(instanceId, expectList, outputDict[instanceId]))
+
+    latencyList = sorted((endTimeDict[instanceId] - lastTimeDict[instanceId]) * 1000. for instanceId in valueDict)
+
+    resDict = {
+        'instances':          args.instances,
+        'values':             args.instances * args.values,
+        'lines':              len(lineList),
+        'wall_ms':            wallTime * 1000.,
+        'feed_ms':            feedTime * 1000.,
+        'values_per_s':       args.instances * args.values / wallTime,
+        'latency_p50_ms':     statistics.median(latencyList),
+        'latency_p99_ms':     latencyList[min(len(latencyList) - 1, len(latencyList) * 99 // 100)],
+        'guest_instructions': runDict['guest_instructions'],
+        'slices':             runDict['slices'],
+        'parks':              runDict['parks'],
+    }
+
+    print('{} instances, {} values in {} lines: {:.3f} ms (Feed {:.3f} ms), {:.0f} values/s'.format(
+        resDict['instances'], resDict['values'], resDict['lines'], resDict['wall_ms'], resDict['feed_ms'],
+        resDict['values_per_s']))
+    print('Latency after the last input: p50 {:.3f} ms, p99 {:.3f} ms'.format(resDict['latency_p50_ms'],
+        resDict['latency_p99_ms']))
+    print('{} guest instructions, {} slices, {} parks'.format(resDict['guest_instructions'], resDict['slices'],
+        resDict['parks']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-stream/1', 'max_delay_ms': args.max_delay_ms, 'jobs': args.jobs,
+                'quantum': args.quantum, 'seed': args.seed, 'results': resDict}, f, indent=4)
+            f.write('\n')
+
+    if resDict['values_per_s'] < args.min_values_per_s:
+        sys.exit('Throughput {:.0f} values/s is below {:.0f}'.format(resDict['values_per_s'], args.min_values_per_s))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+
+'''
+    tasks.py
+    ========
+        Run bench/primes.c (Counting the primes by spawned tasks) with a growing "--jobs", check the outputs and
+        report the median wall time of each job number and its speedup over one job.
+
+        Usage: bench/tasks.py [--max N] [--chunk N] [--jobs N,N,...] [--runs N] [--quantum N] [--json PATH]
+'''
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CMM_PATH  = os.path.join(ROOT_PATH, 'bin', 'CMM')
+
+################################################################################################################################
+# Reference Implementation (The primes < maxNum)
+################################################################################################################################
+
+def refPrimes(maxNum):
+    isComposite = bytearray(max(maxNum, 2))
+    primeNum = 0
+
+    for nowNum in range(2, maxNum):
+        if not isComposite[nowNum]:
+            primeNum += 1
+            isComposite[nowNum * nowNum::nowNum] = b'\x01' * len(range(nowNum * nowNum, maxNum, nowNum))
+
+    return [primeNum, primeNum]
+
+
+################################################################################################################################
+# Main
+################################################################################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the CMM task bench with a growing job number')
+
+    parser.add_argument('--max', type=int, default=40000, help='Count the primes below it')
+    parser.add_argument('--chunk', type=int, default=1000, help='Ints per task')
+    parser.add_argument('--jobs', default='1,2,4,8', help='Job numbers, comma separated')
+    parser.add_argument('--runs', type=int, default=3, help='Runs per job number')
+    parser.add_argument('--quantum', type=int, default=0, help='Instructions per slice (Default: the CMM one)')
+    parser.add_argument('--json', help='Also write the results as JSON to the path')
+
+    args = parser.parse_args()
+
+    expectList, inputStr = refPrimes(args.max), '{} {}\n'.format(args.max, args.chunk)
+    resList = []
+
+    with tempfile.TemporaryDirectory() as tmpPath:
+        asmPath, statsPath = os.path.join(tmpPath, 'primes.asm'), os.path.join(tmpPath, 'stats.json')
+
+        subprocess.run([CMM_PATH, '--input-file-path', os.path.join(ROOT_PATH, 'bench', 'primes.c'),
+            '--output-file-path', asmPath], check=True)
+
+        for jobNum in map(int, args.jobs.split(',')):
+            timeList = []
+
+            for _ in range(args.runs):
+                startTime = time.perf_counter()
+                procObj = subprocess.run([CMM_PATH, '--asm-file-path', asmPath, '--jobs', str(jobNum), '--quantum',
+                    str(args.quantum), '--stats-json', statsPath], input=inputStr, capture_output=True, text=True)
+                timeList.append((time.perf_counter() - startTime) * 1000.)
+
+                if procObj.returncode:
+                    sys.exit('CMM failed with {} jobs: {}'.format(jobNum, procObj.stderr.strip()))
+
+                if list(map(int, procObj.stdout.split())) != expectList:
+                    sys.exit('{} jobs: expect {}, got {}'.format(jobNum, expectList, procObj.stdout.split()))
+
+            with open(statsPath) as f:
+                runDict = json.load(f)['run']
+
+            resList.append({
+                'jobs':    jobNum,
+                'wall_ms': statistics.median(timeList),
+                'tasks':   runDict['tasks'],
+                'steals':  runDict['steals'],
+                'parks':   runDict['parks'],
+            })
+
+    print('{:>6}  {:>12}  {:>8}  {:>8}  {:>8}  {:>8}'.format('Jobs', 'Wall (ms)', 'Speedup', 'Tasks', 'Steals',
+        'Parks'))
+
+    for resDict in resList:
+        resDict['speedup'] = resList[0]['wall_ms'] / resDict['wall_ms']
+
+        print('{:>6}  {:>12.3f}  {:>8.2f}  {:>8}  {:>8}  {:>8}'.format(resDict['jobs'], resDict['wall_ms'],
+            resDict['speedup'], resDict['tasks'], resDict['steals'], resDict['parks']))
+
+    print('{} CPUs'.format(os.cpu_count()))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'schema': 'cmm-tasks/1', 'max': args.max, 'chunk': args.chunk, 'quantum': args.quantum,
+                'cpus': os.cpu_count(), 'results': resList}, f, indent=4)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,147 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Global (The text as an int array of the char codes)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int textArray[300000];
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Is Alpha ([A-Za-z_])
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int isAlpha(int charNum)
+{
+    if (charNum >= 97)
+    {
+        return charNum <= 122;
+    }
+
+    if (charNum >= 65)
+    {
+        if (charNum <= 90)
+        {
+            return 1;
+        }
+
+        return charNum == 95;
+    }
+
+    return 0;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Is Digit ([0-9])
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int isDigit(int charNum)
+{
+    if (charNum >= 48)
+    {
+        return charNum <= 57;
+    }
+
+    return 0;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Is Space (' ', '\t', '\n', '\r')
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int isSpace(int charNum)
+{
+    if (charNum == 32)
+    {
+        return 1;
+    }
+
+    if (charNum >= 9)
+    {
+        return charNum <= 13;
+    }
+
+    return 0;
+}
+
+
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (Read n and n char codes, output the id / number / operator token numbers and the sum of the numbers)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int n;
+    int idx;
+    int idNum;
+    int numberNum;
+    int opNum;
+    int sumNum;
+    int valNum;
+
+    n = input();
+    idx = 0;
+
+    while (idx < n)
+    {
+        textArray[idx] = input();
+        idx = idx + 1;
+    }
+
+    /* A sentinel */
+    textArray[n] = 0;
+
+    idx = 0;
+    idNum = 0;
+    numberNum = 0;
+    opNum = 0;
+    sumNum = 0;
+
+    while (idx < n)
+    {
+        if (isSpace(textArray[idx]))
+        {
+            idx = idx + 1;
+        }
+        else
+        {
+            if (isAlpha(textArray[idx]))
+            {
+                while (isAlpha(textArray[idx]) + isDigit(textArray[idx]))
+                {
+                    idx = idx + 1;
+                }
+
+                idNum = idNum + 1;
+            }
+            else
+            {
+                if (isDigit(textArray[idx]))
+                {
+                    valNum = 0;
+
+                    while (isDigit(textArray[idx]))
+                    {
+                        valNum = valNum * 10 + textArray[idx] - 48;
+                        valNum = valNum - valNum / 1000007 * 1000007;
+                        idx = idx + 1;
+                    }
+
+                    numberNum = numberNum + 1;
+                    sumNum = sumNum + valNum;
+                    sumNum = sumNum - sumNum / 1000007 * 1000007;
+                }
+                else
+                {
+                    opNum = opNum + 1;
+                    idx = idx + 1;
+                }
+            }
+        }
+    }
+
+    output(idNum);
+    output(numberNum);
+    output(opNum);
+    output(sumNum);
+}
@@ -0,0 +1,13 @@
+/*//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main (The sums and products over int32, which wrap around in the VM word: -O2 folds them at compile time)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+int main()
+{
+    int a;
+
+    a = 2000000000;
+
+    output(a + 2000000000);
+    output(65536 * 65536);
+}
@@ -0,0 +1,727 @@
+/*
+    ArrayKernel.hpp
+    ===============
+        Class __ArrayKernel implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::runtime_error;
+
+
+#ifdef __x86_64__
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Struct __AVX2Kernel (The array builtins by 256-bit vectors, only called if the CPU supports AVX2)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+struct __AVX2Kernel
+{
+    // Set1
+    template <typename WordT>
+    static __m256i __set1(WordT wordVal)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm256_set1_epi32(wordVal);
+        }
+        else
+        {
+            return _mm256_set1_epi64x(wordVal);
+        }
+    }
+
+
+    // Add
+    template <typename WordT>
+    static __m256i __add(__m256i lhsVec, __m256i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm256_add_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            return _mm256_add_epi64(lhsVec, rhsVec);
+        }
+    }
+
+
+    // Mul (The low half of the products, there is no 64-bit one before AVX-512)
+    template <typename WordT>
+    static __m256i __mul(__m256i lhsVec, __m256i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm256_mullo_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            // lo * lo + ((hi * lo + lo * hi) << 32)
+            __m256i crossVec = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(lhsVec, 32), rhsVec),
+                _mm256_mul_epu32(lhsVec, _mm256_srli_epi64(rhsVec, 32)));
+
+            return _mm256_add_epi64(_mm256_mul_epu32(lhsVec, rhsVec), _mm256_slli_epi64(crossVec, 32));
+        }
+    }
+
+
+    // Min
+    template <typename WordT>
+    static __m256i __min(__m256i lhsVec, __m256i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm256_min_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            return _mm256_blendv_epi8(lhsVec, rhsVec, _mm256_cmpgt_epi64(lhsVec, rhsVec));
+        }
+    }
+
+
+    // Eq Mask (A bit per byte of the equal words)
+    template <typename WordT>
+    static uint32_t __eqMask(__m256i lhsVec, __m256i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm256_movemask_epi8(_mm256_cmpeq_epi32(lhsVec, rhsVec));
+        }
+        else
+        {
+            return _mm256_movemask_epi8(_mm256_cmpeq_epi64(lhsVec, rhsVec));
+        }
+    }
+
+
+    // Fill
+    template <typename WordT>
+    static void __fill(WordT *wordPtr, size_t wordNum, WordT wordVal)
+    {
+        constexpr size_t laneNum = 32 / sizeof(WordT);
+
+        __m256i valVec = __set1(wordVal);
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            _mm256_storeu_si256((__m256i *)(wordPtr + wordIdx), valVec);
+        }
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            wordPtr[wordIdx] = wordVal;
+        }
+    }
+
+
+    // Sum (Two accumulators, so the adds of the next vector do not wait for the last ones)
+    template <typename WordT>
+    static WordT __sum(const WordT *wordPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 32 / sizeof(WordT);
+
+        __m256i lhsVec = _mm256_setzero_si256(), rhsVec = _mm256_setzero_si256();
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum * 2 <= wordNum; wordIdx += laneNum * 2)
+        {
+            lhsVec = __add<WordT>(lhsVec, _mm256_loadu_si256((const __m256i *)(wordPtr + wordIdx)));
+            rhsVec = __add<WordT>(rhsVec, _mm256_loadu_si256((const __m256i *)(wordPtr + wordIdx + laneNum)));
+        }
+
+        return __reduceSum(__add<WordT>(lhsVec, rhsVec), wordPtr + wordIdx, wordNum - wordIdx);
+    }
+
+
+    // Dot
+    template <typename WordT>
+    static WordT __dot(const WordT *lhsPtr, const WordT *rhsPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 32 / sizeof(WordT);
+
+        __m256i sumVec = _mm256_setzero_si256();
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            sumVec = __add<WordT>(sumVec, __mul<WordT>(_mm256_loadu_si256((const __m256i *)(lhsPtr + wordIdx)),
+                _mm256_loadu_si256((const __m256i *)(rhsPtr + wordIdx))));
+        }
+
+        using UWordT = std::make_unsigned_t<WordT>;
+
+        UWordT dotVal = __reduceSum(sumVec, lhsPtr, 0);
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            dotVal += (UWordT)lhsPtr[wordIdx] * (UWordT)rhsPtr[wordIdx];
+        }
+
+        return dotVal;
+    }
+
+
+    // Argmin (The min by vectors, then the first index of it by vectors, wordNum > 0)
+    template <typename WordT>
+    static size_t __argmin(const WordT *wordPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 32 / sizeof(WordT);
+
+        WordT minVal = wordPtr[0];
+        size_t wordIdx = 0;
+
+        if (wordNum >= laneNum)
+        {
+            __m256i minVec = _mm256_loadu_si256((const __m256i *)wordPtr);
+
+            for (wordIdx = laneNum; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+            {
+                minVec = __min<WordT>(minVec, _mm256_loadu_si256((const __m256i *)(wordPtr + wordIdx)));
+            }
+
+            WordT laneList[laneNum];
+
+            _mm256_storeu_si256((__m256i *)laneList, minVec);
+
+            for (auto laneVal: laneList)
+            {
+                minVal = laneVal < minVal ? laneVal : minVal;
+            }
+        }
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            minVal = wordPtr[wordIdx] < minVal ? wordPtr[wordIdx] : minVal;
+        }
+
+        __m256i minVec = __set1(minVal);
+
+        for (wordIdx = 0; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            if (uint32_t eqMask = __eqMask<WordT>(_mm256_loadu_si256((const __m256i *)(wordPtr + wordIdx)), minVec))
+            {
+                return wordIdx + __builtin_ctz(eqMask) / sizeof(WordT);
+            }
+        }
+
+        while (wordPtr[wordIdx] != minVal)
+        {
+            wordIdx++;
+        }
+
+        return wordIdx;
+    }
+
+
+    // Reduce Sum (The lanes of sumVec and the tail words, wrapped around)
+    template <typename WordT>
+    static WordT __reduceSum(__m256i sumVec, const WordT *tailPtr, size_t tailNum)
+    {
+        using UWordT = std::make_unsigned_t<WordT>;
+
+        UWordT laneList[32 / sizeof(WordT)], sumVal = 0;
+
+        _mm256_storeu_si256((__m256i *)laneList, sumVec);
+
+        for (auto laneVal: laneList)
+        {
+            sumVal += laneVal;
+        }
+
+        for (size_t wordIdx = 0; wordIdx < tailNum; wordIdx++)
+        {
+            sumVal += tailPtr[wordIdx];
+        }
+
+        return sumVal;
+    }
+};
+
+#pragma GCC pop_options
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Struct __SSEKernel (The array builtins by 128-bit vectors, only called if the CPU supports SSE4.2)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+struct __SSEKernel
+{
+    // Set1
+    template <typename WordT>
+    static __m128i __set1(WordT wordVal)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm_set1_epi32(wordVal);
+        }
+        else
+        {
+            return _mm_set1_epi64x(wordVal);
+        }
+    }
+
+
+    // Add
+    template <typename WordT>
+    static __m128i __add(__m128i lhsVec, __m128i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm_add_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            return _mm_add_epi64(lhsVec, rhsVec);
+        }
+    }
+
+
+    // Mul (The low half of the products)
+    template <typename WordT>
+    static __m128i __mul(__m128i lhsVec, __m128i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm_mullo_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            // lo * lo + ((hi * lo + lo * hi) << 32)
+            __m128i crossVec = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(lhsVec, 32), rhsVec),
+                _mm_mul_epu32(lhsVec, _mm_srli_epi64(rhsVec, 32)));
+
+            return _mm_add_epi64(_mm_mul_epu32(lhsVec, rhsVec), _mm_slli_epi64(crossVec, 32));
+        }
+    }
+
+
+    // Min
+    template <typename WordT>
+    static __m128i __min(__m128i lhsVec, __m128i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm_min_epi32(lhsVec, rhsVec);
+        }
+        else
+        {
+            return _mm_blendv_epi8(lhsVec, rhsVec, _mm_cmpgt_epi64(lhsVec, rhsVec));
+        }
+    }
+
+
+    // Eq Mask (A bit per byte of the equal words)
+    template <typename WordT>
+    static uint32_t __eqMask(__m128i lhsVec, __m128i rhsVec)
+    {
+        if constexpr (sizeof(WordT) == 4)
+        {
+            return _mm_movemask_epi8(_mm_cmpeq_epi32(lhsVec, rhsVec));
+        }
+        else
+        {
+            return _mm_movemask_epi8(_mm_cmpeq_epi64(lhsVec, rhsVec));
+        }
+    }
+
+
+    // Fill
+    template <typename WordT>
+    static void __fill(WordT *wordPtr, size_t wordNum, WordT wordVal)
+    {
+        constexpr size_t laneNum = 16 / sizeof(WordT);
+
+        __m128i valVec = __set1(wordVal);
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            _mm_storeu_si128((__m128i *)(wordPtr + wordIdx), valVec);
+        }
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            wordPtr[wordIdx] = wordVal;
+        }
+    }
+
+
+    // Sum (Two accumulators, so the adds of the next vector do not wait for the last ones)
+    template <typename WordT>
+    static WordT __sum(const WordT *wordPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 16 / sizeof(WordT);
+
+        __m128i lhsVec = _mm_setzero_si128(), rhsVec = _mm_setzero_si128();
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum * 2 <= wordNum; wordIdx += laneNum * 2)
+        {
+            lhsVec = __add<WordT>(lhsVec, _mm_loadu_si128((const __m128i *)(wordPtr + wordIdx)));
+            rhsVec = __add<WordT>(rhsVec, _mm_loadu_si128((const __m128i *)(wordPtr + wordIdx + laneNum)));
+        }
+
+        return __reduceSum(__add<WordT>(lhsVec, rhsVec), wordPtr + wordIdx, wordNum - wordIdx);
+    }
+
+
+    // Dot
+    template <typename WordT>
+    static WordT __dot(const WordT *lhsPtr, const WordT *rhsPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 16 / sizeof(WordT);
+
+        __m128i sumVec = _mm_setzero_si128();
+        size_t wordIdx = 0;
+
+        for (; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            sumVec = __add<WordT>(sumVec, __mul<WordT>(_mm_loadu_si128((const __m128i *)(lhsPtr + wordIdx)),
+                _mm_loadu_si128((const __m128i *)(rhsPtr + wordIdx))));
+        }
+
+        using UWordT = std::make_unsigned_t<WordT>;
+
+        UWordT dotVal = __reduceSum(sumVec, lhsPtr, 0);
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            dotVal += (UWordT)lhsPtr[wordIdx] * (UWordT)rhsPtr[wordIdx];
+        }
+
+        return dotVal;
+    }
+
+
+    // Argmin (The min by vectors, then the first index of it by vectors, wordNum > 0)
+    template <typename WordT>
+    static size_t __argmin(const WordT *wordPtr, size_t wordNum)
+    {
+        constexpr size_t laneNum = 16 / sizeof(WordT);
+
+        WordT minVal = wordPtr[0];
+        size_t wordIdx = 0;
+
+        if (wordNum >= laneNum)
+        {
+            __m128i minVec = _mm_loadu_si128((const __m128i *)wordPtr);
+
+            for (wordIdx = laneNum; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+            {
+                minVec = __min<WordT>(minVec, _mm_loadu_si128((const __m128i *)(wordPtr + wordIdx)));
+            }
+
+            WordT laneList[laneNum];
+
+            _mm_storeu_si128((__m128i *)laneList, minVec);
+
+            for (auto laneVal: laneList)
+            {
+                minVal = laneVal < minVal ? laneVal : minVal;
+            }
+        }
+
+        for (; wordIdx < wordNum; wordIdx++)
+        {
+            minVal = wordPtr[wordIdx] < minVal ? wordPtr[wordIdx] : minVal;
+        }
+
+        __m128i minVec = __set1(minVal);
+
+        for (wordIdx = 0; wordIdx + laneNum <= wordNum; wordIdx += laneNum)
+        {
+            if (uint32_t eqMask = __eqMask<WordT>(_mm_loadu_si128((const __m128i *)(wordPtr + wordIdx)), minVec))
+            {
+                return wordIdx + __builtin_ctz(eqMask) / sizeof(WordT);
+            }
+        }
+
+        while (wordPtr[wordIdx] != minVal)
+        {
+            wordIdx++;
+        }
+
+        return wordIdx;
+    }
+
+
+    // Reduce Sum (The lanes of sumVec and the tail words, wrapped around)
+    template <typename WordT>
+    static WordT __reduceSum(__m128i sumVec, const WordT *tailPtr, size_t tailNum)
+    {
+        using UWordT = std::make_unsigned_t<WordT>;
+
+        UWordT laneList[16 / sizeof(WordT)], sumVal = 0;
+
+        _mm_storeu_si128((__m128i *)laneList, sumVec);
+
+        for (auto laneVal: laneList)
+        {
+            sumVal += laneVal;
+        }
+
+        for (size_t wordIdx = 0; wordIdx < tailNum; wordIdx++)
+        {
+            sumVal += tailPtr[wordIdx];
+        }
+
+        return sumVal;
+    }
+};
+
+#pragma GCC pop_options
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __ArrayKernel (The array builtins of the VM, by the widest vectors of the CPU)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    The kernel is chosen once at startup by __select ("auto" is the best one the CPU supports), a word by word
+    scalar loop is the fallback on the other CPUs. The ints wrap around, the same as the CMM loops on the VM.
+*/
+class __ArrayKernel
+{
+public:
+
+    // The kernels, from the slowest one
+    enum class __KernelType
+    {
+        __Scalar,
+        __SSE,
+        __AVX2,
+    };
+
+
+    // Select (By name: "auto", "scalar", "sse4.2" or "avx2")
+    static void __select(const string &kernelName)
+    {
+        if (kernelName == "auto")
+        {
+            __getKernelType() = __detectKernelType();
+        }
+        else if (kernelName == "scalar")
+        {
+            __getKernelType() = __KernelType::__Scalar;
+        }
+        else if (kernelName == "sse4.2" || kernelName == "avx2")
+        {
+            auto kernelType = kernelName == "avx2" ? __KernelType::__AVX2 : __KernelType::__SSE;
+
+            if (__detectKernelType() < kernelType)
+            {
+                throw runtime_error("Invalid array kernel: " + kernelName + " (Not supported by the CPU)");
+            }
+
+            __getKernelType() = kernelType;
+        }
+        else
+        {
+            throw runtime_error("Invalid array kernel: " + kernelName);
+        }
+    }
+
+
+    // Get Name (Of the selected kernel)
+    static string __getName()
+    {
+        switch (__getKernelType())
+        {
+            case __KernelType::__AVX2:
+                return "avx2";
+
+            case __KernelType::__SSE:
+                return "sse4.2";
+
+            default:
+                return "scalar";
+        }
+    }
+
+
+    // Fill (wordNum words of wordPtr with wordVal)
+    template <typename WordT>
+    static void __fill(WordT *wordPtr, size_t wordNum, WordT wordVal)
+    {
+#ifdef __x86_64__
+        switch (__getKernelType())
+        {
+            case __KernelType::__AVX2:
+                return __AVX2Kernel::__fill(wordPtr, wordNum, wordVal);
+
+            case __KernelType::__SSE:
+                return __SSEKernel::__fill(wordPtr, wordNum, wordVal);
+
+            default:
+                break;
+        }
+#endif
+
+        for (size_t wordIdx = 0; wordIdx < wordNum; wordIdx++)
+        {
+            wordPtr[wordIdx] = wordVal;
+        }
+    }
+
+
+    // Copy (wordNum words from srcPtr to dstPtr, which may overlap: memmove is already vectorized by the libc)
+    template <typename WordT>
+    static void __copy(WordT *dstPtr, const WordT *srcPtr, size_t wordNum)
+    {
+        memmove(dstPtr, srcPtr, wordNum * sizeof(WordT));
+    }
+
+
+    // Sum (Of wordNum words of wordPtr)
+    template <typename WordT>
+    static WordT __sum(const WordT *wordPtr, size_t wordNum)
+    {
+#ifdef __x86_64__
+        switch (__getKernelType())
+        {
+            case __KernelType::__AVX2:
+                return __AVX2Kernel::__sum(wordPtr, wordNum);
+
+            case __KernelType::__SSE:
+                return __SSEKernel::__sum(wordPtr, wordNum);
+
+            default:
+                break;
+        }
+#endif
+
+        std::make_unsigned_t<WordT> sumVal = 0;
+
+        for (size_t wordIdx = 0; wordIdx < wordNum; wordIdx++)
+        {
+            sumVal += wordPtr[wordIdx];
+        }
+
+        return sumVal;
+    }
+
+
+    // Dot (Of wordNum words of lhsPtr and rhsPtr)
+    template <typename WordT>
+    static WordT __dot(const WordT *lhsPtr, const WordT *rhsPtr, size_t wordNum)
+    {
+#ifdef __x86_64__
+        switch (__getKernelType())
+        {
+            case __KernelType::__AVX2:
+                return __AVX2Kernel::__dot(lhsPtr, rhsPtr, wordNum);
+
+            case __KernelType::__SSE:
+                return __SSEKernel::__dot(lhsPtr, rhsPtr, wordNum);
+
+            default:
+                break;
+        }
+#endif
+
+        using UWordT = std::make_unsigned_t<WordT>;
+
+        UWordT dotVal = 0;
+
+        for (size_t wordIdx = 0; wordIdx < wordNum; wordIdx++)
+        {
+            dotVal += (UWordT)lhsPtr[wordIdx] * (UWordT)rhsPtr[wordIdx];
+        }
+
+        return dotVal;
+    }
+
+
+    // Argmin (The index of the first min of wordNum words of wordPtr, wordNum > 0)
+    template <typename WordT>
+    static size_t __argmin(const WordT *wordPtr, size_t wordNum)
+    {
+#ifdef __x86_64__
+        switch (__getKernelType())
+        {
+            case __KernelType::__AVX2:
+                return __AVX2Kernel::__argmin(wordPtr, wordNum);
+
+            case __KernelType::__SSE:
+                return __SSEKernel::__argmin(wordPtr, wordNum);
+
+            default:
+                break;
+        }
+#endif
+
+        size_t minIdx = 0;
+
+        for (size_t wordIdx = 1; wordIdx < wordNum; wordIdx++)
+        {
+            if (wordPtr[wordIdx] < wordPtr[minIdx])
+            {
+                minIdx = wordIdx;
+            }
+        }
+
+        return minIdx;
+    }
+
+
+private:
+
+    // Detect Kernel Type (The best one the CPU supports)
+    static __KernelType __detectKernelType()
+    {
+#ifdef __x86_64__
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return __KernelType::__AVX2;
+        }
+
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return __KernelType::__SSE;
+        }
+#endif
+
+        return __KernelType::__Scalar;
+    }
+
+
+    // Get Kernel Type (The selected one, detected at the first use)
+    static __KernelType &__getKernelType()
+    {
+        static __KernelType kernelType = __detectKernelType();
+
+        return kernelType;
+    }
+};
+
+
+}  // End namespace CMM
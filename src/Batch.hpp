@@ -0,0 +1,424 @@
+/*
+    Batch.hpp
+    =========
+        Class template __Batch implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include "Code.hpp"
+#include "Scheduler.hpp"
+#include "LaneVM.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using std::unique_ptr;
+using std::make_unique;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::atomic;
+using std::pair;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __Batch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Run a program once per input record (A line of ints) on a pool of worker threads pinned to the CPUs. The program is
+    loaded once and shared by all the VMs. The output of a record is one line of ints, and the lines are written in the
+    record order.
+
+    Without a quantum, each worker has its own context (So its own SS), reset for each record, and runs the records to
+    the end one by one. With a quantum, all the records of a block have their own contexts, run by slices of the quantum
+    instructions on the __Scheduler, so a long record can not hold a worker. With lanes, each worker runs the records of
+    a chunk by groups of 8 or 16 in lockstep on a __LaneVM.
+*/
+template <typename VMType>
+class __Batch
+{
+    // Friend
+    friend class __Kernel;
+
+
+public:
+
+    // Constructor (An empty path means stdin / stdout, 0 jobs means one per CPU, 0 quantum means to the end, 0 lanes
+    // means one record at a time)
+    explicit __Batch(const string &asmFilePath, const string &inputFilePath = "", const string &outputFilePath = "",
+        size_t jobNum = 0, uint64_t quantum = 0, uint64_t fuel = UINT64_MAX, size_t laneNum = 0):
+        __asmFilePath   (asmFilePath),
+        __inputFilePath (inputFilePath),
+        __outputFilePath(outputFilePath),
+        __jobNum        (jobNum),
+        __quantum       (quantum),
+        __fuel          (fuel),
+        __laneNum       (laneNum) {}
+
+
+    // operator()
+    void operator()()
+    {
+        __main();
+    }
+
+
+private:
+
+    // The records are run and written by blocks, so the pending outputs are bounded
+    static constexpr size_t __BLOCK_SIZE = 1 << 16;
+
+    // A worker takes the records of a block by chunks
+    static constexpr size_t __CHUNK_SIZE = 64;
+
+    // The I/O buffer of a record context (There may be a block of them)
+    static constexpr size_t __RECORD_BUFFER_SIZE = 256;
+
+
+    // Attribute
+    string __asmFilePath;
+    string __inputFilePath;
+    string __outputFilePath;
+    size_t __jobNum;
+    uint64_t __quantum;
+    uint64_t __fuel;
+    size_t __laneNum;
+    shared_ptr<const __Code> __codePtr;
+
+    // The CPUs allowed for this process
+    vector<int> __cpuList;
+
+    // The text of all the records, (Start, Size) of each one
+    string __inputStr;
+    vector<pair<size_t, size_t>> __recordList;
+
+    // Run statistics (The sums of all the VMs, the same names as the __VM ones for __Kernel::__outputStats)
+    uint64_t __insCount = 0;
+    uint64_t __callCount = 0;
+    size_t __maxSSSize = 0;
+    uint64_t __sliceCount = 0;
+    uint64_t __stealCount = 0;
+    uint64_t __laneStepCount = 0;
+    uint64_t __laneDivergeCount = 0;
+    uint64_t __laneFallbackCount = 0;
+    size_t __errorNum = 0;
+    mutex __statMutex;
+
+
+    // Construct __cpuList
+    void __constructCpuList()
+    {
+        __cpuList = __Scheduler<VMType>::__getCpuList();
+
+        if (!__jobNum)
+        {
+            __jobNum = std::max(__cpuList.size(), (size_t)1);
+        }
+    }
+
+
+    // Construct __recordList (A record per line, the last line may have no '\n')
+    void __constructRecordList()
+    {
+        FILE *fdIn = __inputFilePath.empty() ? stdin : fopen(__inputFilePath.c_str(), "rb");
+
+        if (!fdIn)
+        {
+            throw runtime_error("Invalid " + __inputFilePath);
+        }
+
+        char readBuffer[1 << 16];
+
+        for (size_t readSize; (readSize = fread(readBuffer, 1, sizeof(readBuffer), fdIn)) > 0;)
+        {
+            __inputStr.append(readBuffer, readSize);
+        }
+
+        if (fdIn != stdin)
+        {
+            fclose(fdIn);
+        }
+
+        for (size_t startIdx = 0; startIdx < __inputStr.size();)
+        {
+            size_t endIdx = std::min(__inputStr.find('\n', startIdx), __inputStr.size());
+
+            __recordList.emplace_back(startIdx, endIdx - startIdx);
+            startIdx = endIdx + 1;
+        }
+    }
+
+
+    // Finish Output ("1\n2\n3\n" -> "1 2 3\n")
+    static void __finishOutput(string &outputStr)
+    {
+        if (!outputStr.empty())
+        {
+            outputStr.pop_back();
+            std::replace(outputStr.begin(), outputStr.end(), '\n', ' ');
+        }
+
+        outputStr.push_back('\n');
+    }
+
+
+    // Run Worker (The records [beginIdx, endIdx) are taken by chunks from nextIdx, each one is run to the end)
+    void __runWorker(size_t workerIdx, size_t beginIdx, size_t endIdx, atomic<size_t> &nextIdx,
+        vector<string> &outputList, vector<string> &errorList)
+    {
+        __Scheduler<VMType>::__pin(__cpuList, workerIdx);
+
+        VMType vmObj(__codePtr);
+        typename VMType::__ContextType ctxObj("", "", false, __RECORD_BUFFER_SIZE);
+
+        for (size_t chunkIdx; (chunkIdx = nextIdx.fetch_add(__CHUNK_SIZE)) < endIdx;)
+        {
+            for (size_t recordIdx = chunkIdx; recordIdx < std::min(chunkIdx + __CHUNK_SIZE, endIdx); recordIdx++)
+            {
+                auto &[startIdx, recordSize] = __recordList[recordIdx];
+                string &outputStr = outputList[recordIdx - beginIdx];
+
+                vmObj.__startRecord(ctxObj, __inputStr.data() + startIdx, recordSize, outputStr, __fuel);
+
+                // The output before a runtime error is kept, the same as a normal run
+                try
+                {
+                    vmObj.__execAll(ctxObj);
+                }
+                catch (const runtime_error &errObj)
+                {
+                    errorList[recordIdx - beginIdx] = errObj.what();
+                }
+
+                ctxObj.__flush();
+                __finishOutput(outputStr);
+            }
+        }
+
+        lock_guard<mutex> statLock(__statMutex);
+
+        __insCount += vmObj.__insCount;
+        __callCount += vmObj.__callCount;
+        __maxSSSize = std::max(__maxSSSize, vmObj.__maxSSSize);
+    }
+
+
+    // Run Lane Worker (The records [beginIdx, endIdx) are taken by chunks from nextIdx, run by LaneNum in lockstep)
+    template <size_t LaneNum>
+    void __runLaneWorker(size_t workerIdx, size_t beginIdx, size_t endIdx, atomic<size_t> &nextIdx,
+        vector<string> &outputList, vector<string> &errorList)
+    {
+        __Scheduler<VMType>::__pin(__cpuList, workerIdx);
+
+        __LaneVM<VMType, LaneNum> laneVMObj(__codePtr);
+        vector<unique_ptr<typename VMType::__ContextType>> ctxList;
+        vector<typename VMType::__ContextType *> ctxPtrList;
+        vector<string> laneErrorList(LaneNum);
+
+        for (size_t laneIdx = 0; laneIdx < LaneNum; laneIdx++)
+        {
+            ctxList.push_back(make_unique<typename VMType::__ContextType>("", "", false, __RECORD_BUFFER_SIZE));
+        }
+
+        for (size_t chunkIdx; (chunkIdx = nextIdx.fetch_add(__CHUNK_SIZE)) < endIdx;)
+        {
+            size_t chunkEndIdx = std::min(chunkIdx + __CHUNK_SIZE, endIdx);
+
+            for (size_t groupIdx = chunkIdx; groupIdx < chunkEndIdx; groupIdx += LaneNum)
+            {
+                size_t groupEndIdx = std::min(groupIdx + LaneNum, chunkEndIdx);
+
+                ctxPtrList.clear();
+
+                for (size_t recordIdx = groupIdx; recordIdx < groupEndIdx; recordIdx++)
+                {
+                    auto &[startIdx, recordSize] = __recordList[recordIdx];
+                    auto &ctxObj = *ctxList[recordIdx - groupIdx];
+
+                    laneVMObj.__vm.__startRecord(ctxObj, __inputStr.data() + startIdx, recordSize,
+                        outputList[recordIdx - beginIdx], __fuel);
+
+                    ctxPtrList.push_back(&ctxObj);
+                    laneErrorList[recordIdx - groupIdx].clear();
+                }
+
+                laneVMObj.__execAll(ctxPtrList, laneErrorList);
+
+                for (size_t recordIdx = groupIdx; recordIdx < groupEndIdx; recordIdx++)
+                {
+                    ctxList[recordIdx - groupIdx]->__flush();
+                    errorList[recordIdx - beginIdx] = laneErrorList[recordIdx - groupIdx];
+                    __finishOutput(outputList[recordIdx - beginIdx]);
+                }
+            }
+        }
+
+        lock_guard<mutex> statLock(__statMutex);
+
+        __insCount += laneVMObj.__insCount + laneVMObj.__vm.__insCount;
+        __callCount += laneVMObj.__callCount + laneVMObj.__vm.__callCount;
+        __maxSSSize = std::max({__maxSSSize, laneVMObj.__maxSSSize, laneVMObj.__vm.__maxSSSize});
+        __laneStepCount += laneVMObj.__stepCount;
+        __laneDivergeCount += laneVMObj.__divergeCount;
+        __laneFallbackCount += laneVMObj.__fallbackCount;
+    }
+
+
+    // Run Block (The records [beginIdx, endIdx) to the end one by one on each worker)
+    void __runBlock(size_t beginIdx, size_t endIdx, vector<string> &outputList, vector<string> &errorList)
+    {
+        atomic<size_t> nextIdx(beginIdx);
+        vector<thread> workerList;
+        auto workerFunc = &__Batch::__runWorker;
+
+        if constexpr (VMType::__laneBool)
+        {
+            workerFunc = __laneNum == 16 ? &__Batch::__runLaneWorker<16> :
+                __laneNum == 8 ? &__Batch::__runLaneWorker<8> : workerFunc;
+        }
+
+        for (size_t workerIdx = 0; workerIdx < std::min(__jobNum, endIdx - beginIdx); workerIdx++)
+        {
+            workerList.emplace_back(workerFunc, this, workerIdx, beginIdx, endIdx, std::ref(nextIdx),
+                std::ref(outputList), std::ref(errorList));
+        }
+
+        for (auto &workerObj: workerList)
+        {
+            workerObj.join();
+        }
+    }
+
+
+    // Schedule Block (The records [beginIdx, endIdx) as green threads on the __Scheduler)
+    void __scheduleBlock(size_t beginIdx, size_t endIdx, vector<string> &outputList, vector<string> &errorList)
+    {
+        VMType vmObj(__codePtr);
+        vector<unique_ptr<typename VMType::__ContextType>> ctxList;
+        vector<typename VMType::__ContextType *> ctxPtrList;
+
+        for (size_t recordIdx = beginIdx; recordIdx < endIdx; recordIdx++)
+        {
+            auto &[startIdx, recordSize] = __recordList[recordIdx];
+
+            ctxList.push_back(make_unique<typename VMType::__ContextType>("", "", false, __RECORD_BUFFER_SIZE));
+            ctxPtrList.push_back(ctxList.back().get());
+
+            vmObj.__startRecord(*ctxList.back(), __inputStr.data() + startIdx, recordSize,
+                outputList[recordIdx - beginIdx], __fuel);
+
+            ctxList.back()->__id = recordIdx;
+        }
+
+        __Scheduler<VMType> schedulerObj(__codePtr, __cpuList, __jobNum, __quantum,
+            [&](typename VMType::__ContextType &ctxObj, bool finishBool, const string &errStr)
+            {
+                if (finishBool && !errStr.empty())
+                {
+                    errorList[ctxObj.__id - beginIdx] = errStr;
+                }
+            });
+
+        schedulerObj(ctxPtrList);
+
+        for (auto &outputStr: outputList)
+        {
+            __finishOutput(outputStr);
+        }
+
+        __insCount += schedulerObj.__insCount;
+        __callCount += schedulerObj.__callCount;
+        __maxSSSize = std::max(__maxSSSize, schedulerObj.__maxSSSize);
+        __sliceCount += schedulerObj.__sliceCount;
+        __stealCount += schedulerObj.__stealCount;
+    }
+
+
+    // Main
+    void __main()
+    {
+        if (__asmFilePath.empty())
+        {
+            return;
+        }
+
+        __codePtr = make_shared<const __Code>(__asmFilePath);
+
+        __constructCpuList();
+        __constructRecordList();
+
+        FILE *fdOut = __outputFilePath.empty() ? stdout : fopen(__outputFilePath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            throw runtime_error("Invalid " + __outputFilePath);
+        }
+
+        for (size_t beginIdx = 0; beginIdx < __recordList.size(); beginIdx += __BLOCK_SIZE)
+        {
+            size_t endIdx = std::min(beginIdx + __BLOCK_SIZE, __recordList.size());
+            vector<string> outputList(endIdx - beginIdx), errorList(endIdx - beginIdx);
+
+            if (__quantum)
+            {
+                __scheduleBlock(beginIdx, endIdx, outputList, errorList);
+            }
+            else
+            {
+                __runBlock(beginIdx, endIdx, outputList, errorList);
+            }
+
+            // In the record order
+            for (size_t recordIdx = beginIdx; recordIdx < endIdx; recordIdx++)
+            {
+                fwrite(outputList[recordIdx - beginIdx].data(), 1, outputList[recordIdx - beginIdx].size(), fdOut);
+
+                if (!errorList[recordIdx - beginIdx].empty())
+                {
+                    fprintf(stderr, "Record %zu: %s\n", recordIdx + 1, errorList[recordIdx - beginIdx].c_str());
+                    __errorNum++;
+                }
+            }
+        }
+
+        if (fdOut != stdout)
+        {
+            fclose(fdOut);
+        }
+        else
+        {
+            fflush(stdout);
+        }
+
+        if (__errorNum)
+        {
+            throw runtime_error("Invalid records: " + to_string(__errorNum) + " of " + to_string(__recordList.size()));
+        }
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,444 @@
+/*
+    Cache.hpp
+    =========
+        Class __Cache implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::tuple;
+using std::atomic;
+using std::sort;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __Cache
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    A content-addressed cache of the compiled programs on disk. An entry is the asm text of a compile, in the file
+    "Key.asm" of the cache dir, where Key is the FNV-1a 128 hash of the compiler version, the compile flags and the
+    source bytes (The code of a function is a "Key.func" entry in the same way, see __FuncCache):
+
+        cmm-cache/1 Size\n <Size bytes>
+
+    The source path is not a part of the key: The ".file" line of an entry is rewritten to the path of the load.
+
+    An entry is written to a temp file, then renamed to its name, so a reader sees a whole entry or none, and the
+    concurrent writers of a key (The same bytes) only replace one another. The mtime of an entry is its last use (A
+    hit touches it), and a store evicts the least recently used entries until the total size is in the limit.
+*/
+class __Cache
+{
+    // Friend
+    friend class __Kernel;
+
+    friend class __Compiler;
+    friend class __FuncCache;
+
+    template <typename VMType>
+    friend class __Server;
+
+
+public:
+
+    // Constructor (An empty dir path means $XDG_CACHE_HOME/cmm, or ~/.cache/cmm)
+    explicit __Cache(const string &dirPath = "", uint64_t maxSize = 64 << 20):
+        __dirPath(dirPath.empty() ? __getDefaultDirPath() : dirPath),
+        __maxSize(maxSize)
+    {
+        __makeDir(__dirPath);
+    }
+
+
+private:
+
+    // The compiler version: Any rebuild of CMM may change the code generation, so the build time stands for it
+    static constexpr const char *__VERSION_STR = "cmm-cache/1 " __DATE__ " " __TIME__;
+
+    // A temp file older than this (s) is left by a killed writer, and is removed by the eviction
+    static constexpr time_t __STALE_TEMP_AGE = 600;
+
+
+    // Attribute
+    string __dirPath;
+    uint64_t __maxSize;
+
+    // Statistics
+    atomic<uint64_t> __hitCount {0};
+    atomic<uint64_t> __missCount {0};
+    atomic<uint64_t> __evictCount {0};
+
+    // The temp files of this process
+    atomic<uint64_t> __tempCount {0};
+
+
+    // Get Default Dir Path
+    static string __getDefaultDirPath()
+    {
+        // The XDG base dir spec ignores a relative path
+        if (const char *xdgPtr = getenv("XDG_CACHE_HOME"); xdgPtr && xdgPtr[0] == '/')
+        {
+            return string(xdgPtr) + "/cmm";
+        }
+
+        if (const char *homePtr = getenv("HOME"); homePtr && homePtr[0])
+        {
+            return string(homePtr) + "/.cache/cmm";
+        }
+
+        throw runtime_error("Invalid cache dir (No $XDG_CACHE_HOME or $HOME, see --cache-dir)");
+    }
+
+
+    // Make Dir (With its parents)
+    static void __makeDir(const string &dirPath)
+    {
+        for (size_t slashIdx = dirPath.find('/', 1);; slashIdx = dirPath.find('/', slashIdx + 1))
+        {
+            string curPath = dirPath.substr(0, slashIdx);
+
+            if (!curPath.empty() && mkdir(curPath.c_str(), 0755) < 0 && errno != EEXIST)
+            {
+                throw runtime_error("Invalid cache dir " + curPath);
+            }
+
+            if (slashIdx == string::npos)
+            {
+                break;
+            }
+        }
+    }
+
+
+    // Get Key (32 hex digits, the word size only counts with -O2, whose consts are folded in it)
+    static string __getKey(const string &sourceStr, size_t optLevel, size_t inlineBudget, bool objectBool = false,
+        size_t wordSize = 32)
+    {
+        // FNV-1a 128 (The flags end with a '\0', so they can not run into the source)
+        unsigned __int128 hashVal = ((unsigned __int128)0x6c62272e07bb0142ULL << 64) | 0x62b821756295c58dULL;
+        const unsigned __int128 primeVal = ((unsigned __int128)1 << 88) | 0x13b;
+
+        auto hashStr = [&](const string &curStr)
+        {
+            for (unsigned char curChar: curStr)
+            {
+                hashVal = (hashVal ^ curChar) * primeVal;
+            }
+        };
+
+        hashStr(string(__VERSION_STR) + " -O " + to_string(optLevel) + " --inline-budget " +
+            to_string(inlineBudget) + (objectBool ? " --object" : "") +
+            (optLevel >= 2 ? " --word-size " + to_string(wordSize) : "") + '\0');
+        hashStr(sourceStr);
+
+        char keyBuffer[33];
+
+        snprintf(keyBuffer, sizeof(keyBuffer), "%016llx%016llx", (unsigned long long)(hashVal >> 64),
+            (unsigned long long)hashVal);
+
+        return keyBuffer;
+    }
+
+
+    // Get Entry Path (".asm" for a program, ".func" for the code of a function, see __FuncCache)
+    string __getEntryPath(const string &keyStr, const string &suffixStr = ".asm") const
+    {
+        return __dirPath + "/" + keyStr + suffixStr;
+    }
+
+
+    // Read Entry (False if there is none)
+    static bool __readEntry(const string &entryPath, string &dataStr)
+    {
+        FILE *fdIn = fopen(entryPath.c_str(), "r");
+
+        if (!fdIn)
+        {
+            return false;
+        }
+
+        // A bad entry (Such as one cut by a crash before it reached the disk) is a miss, and is replaced by the store
+        unsigned long long dataSize = 0;
+        bool validBool = fscanf(fdIn, "cmm-cache/1 %llu", &dataSize) == 1 && fgetc(fdIn) == '\n';
+
+        if (validBool)
+        {
+            dataStr.resize(dataSize);
+            validBool = fread(dataStr.data(), 1, dataSize, fdIn) == dataSize && fgetc(fdIn) == EOF;
+        }
+
+        fclose(fdIn);
+
+        if (validBool)
+        {
+            // The last use for the eviction
+            utimensat(AT_FDCWD, entryPath.c_str(), nullptr, 0);
+        }
+
+        return validBool;
+    }
+
+
+    // Write Entry (Best effort: A failed write only misses the next time)
+    void __writeEntry(const string &entryPath, const string &dataStr)
+    {
+        string tempPath = entryPath + ".tmp." + to_string(getpid()) + "." + to_string(__tempCount++);
+        FILE *fdOut = fopen(tempPath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            return;
+        }
+
+        string headerStr = "cmm-cache/1 " + to_string(dataStr.size()) + "\n";
+
+        bool writeBool = fwrite(headerStr.data(), 1, headerStr.size(), fdOut) == headerStr.size() &&
+            fwrite(dataStr.data(), 1, dataStr.size(), fdOut) == dataStr.size();
+
+        if (fclose(fdOut) || !writeBool || rename(tempPath.c_str(), entryPath.c_str()) < 0)
+        {
+            unlink(tempPath.c_str());
+            return;
+        }
+
+        __evict();
+    }
+
+
+    // Load (The asm text of the key for the source path, false if there is none)
+    bool __load(const string &keyStr, const string &sourcePath, string &asmStr)
+    {
+        if (!__readEntry(__getEntryPath(keyStr), asmStr))
+        {
+            __missCount++;
+            return false;
+        }
+
+        if (auto fileIdx = asmStr.find("\n.file "); fileIdx != string::npos)
+        {
+            fileIdx += 7;
+            asmStr.replace(fileIdx, asmStr.find('\n', fileIdx) - fileIdx, sourcePath);
+        }
+
+        __hitCount++;
+        return true;
+    }
+
+
+    // Store
+    void __store(const string &keyStr, const string &asmStr)
+    {
+        __writeEntry(__getEntryPath(keyStr), asmStr);
+    }
+
+
+    // Load Func (The code text of a function, counted by __FuncCache)
+    bool __loadFunc(const string &keyStr, string &codeStr)
+    {
+        return __readEntry(__getEntryPath(keyStr, ".func"), codeStr);
+    }
+
+
+    // Store Func
+    void __storeFunc(const string &keyStr, const string &codeStr)
+    {
+        __writeEntry(__getEntryPath(keyStr, ".func"), codeStr);
+    }
+
+
+    // Evict (The least recently used entries, until the total size is in the limit)
+    void __evict()
+    {
+        DIR *dirPtr = opendir(__dirPath.c_str());
+
+        if (!dirPtr)
+        {
+            return;
+        }
+
+        // (mtime, Size, Path) of each entry
+        vector<tuple<timespec, uint64_t, string>> entryList;
+        uint64_t totalSize = 0;
+        time_t nowTime = time(nullptr);
+
+        while (auto entryPtr = readdir(dirPtr))
+        {
+            string entryName = entryPtr->d_name, entryPath = __dirPath + "/" + entryName;
+            string suffixStr = entryName.substr(std::min<size_t>(entryName.size(), 32));
+            bool tempBool = !suffixStr.compare(0, 9, ".asm.tmp.") || !suffixStr.compare(0, 10, ".func.tmp.");
+            struct stat statObj;
+
+            if (suffixStr != ".asm" && suffixStr != ".func" && !tempBool)
+            {
+                continue;
+            }
+
+            if (stat(entryPath.c_str(), &statObj) < 0)
+            {
+                continue;
+            }
+
+            if (tempBool)
+            {
+                if (nowTime - statObj.st_mtime > __STALE_TEMP_AGE)
+                {
+                    unlink(entryPath.c_str());
+                }
+
+                continue;
+            }
+
+            entryList.emplace_back(statObj.st_mtim, statObj.st_size, entryPath);
+            totalSize += statObj.st_size;
+        }
+
+        closedir(dirPtr);
+
+        if (totalSize <= __maxSize)
+        {
+            return;
+        }
+
+        sort(entryList.begin(), entryList.end(), [](const auto &lhs, const auto &rhs)
+        {
+            auto &lhsTime = std::get<0>(lhs), &rhsTime = std::get<0>(rhs);
+
+            return lhsTime.tv_sec != rhsTime.tv_sec ? lhsTime.tv_sec < rhsTime.tv_sec :
+                lhsTime.tv_nsec < rhsTime.tv_nsec;
+        });
+
+        // Another process may evict the same entries: Only the own unlinks are counted
+        for (auto &[_, entrySize, entryPath]: entryList)
+        {
+            if (totalSize <= __maxSize)
+            {
+                break;
+            }
+
+            totalSize -= entrySize;
+
+            if (unlink(entryPath.c_str()) == 0)
+            {
+                __evictCount++;
+            }
+        }
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __FuncCache
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    The code of the functions of the last compile by their keys (See __Compiler::__getFuncKey), so a compile after an
+    edit only generates the changed functions. The code text is the compiler's (See __Compiler::__toFuncCodeStr), and
+    with a __Cache it is also kept on disk, for the compiles of the later processes.
+*/
+class __FuncCache
+{
+    // Friend
+    friend class __Compiler;
+    friend class __Kernel;
+
+
+public:
+
+    // Constructor
+    explicit __FuncCache(__Cache *cachePtr = nullptr):
+        __cachePtr(cachePtr) {}
+
+
+private:
+
+    // Attribute
+    __Cache *__cachePtr;
+
+    // Key -> The code text of a function
+    unordered_map<string, string> __codeMap;
+
+    // The keys used by the current compile
+    unordered_set<string> __usedSet;
+
+
+    // Load (False if there is none)
+    bool __load(const string &keyStr, string &codeStr)
+    {
+        if (auto codeIter = __codeMap.find(keyStr); codeIter != __codeMap.end())
+        {
+            codeStr = codeIter->second;
+        }
+        else if (!__cachePtr || !__cachePtr->__loadFunc(keyStr, codeStr))
+        {
+            return false;
+        }
+        else
+        {
+            __codeMap[keyStr] = codeStr;
+        }
+
+        __usedSet.insert(keyStr);
+
+        return true;
+    }
+
+
+    // Store
+    void __store(const string &keyStr, const string &codeStr)
+    {
+        __codeMap[keyStr] = codeStr;
+        __usedSet.insert(keyStr);
+
+        if (__cachePtr)
+        {
+            __cachePtr->__storeFunc(keyStr, codeStr);
+        }
+    }
+
+
+    // Finish (The end of a compile: Only the functions of it are kept in memory)
+    void __finish()
+    {
+        for (auto codeIter = __codeMap.begin(); codeIter != __codeMap.end();)
+        {
+            codeIter = __usedSet.count(codeIter->first) ? next(codeIter) : __codeMap.erase(codeIter);
+        }
+
+        __usedSet.clear();
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,208 @@
+/*
+    Code.hpp
+    ========
+        Class __Code implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <sstream>
+#include <utility>
+#include <tuple>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::istream;
+using std::ifstream;
+using std::istringstream;
+using std::pair;
+using std::tuple;
+using std::get;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __Code (A loaded asm file, immutable after the construction, so it can be shared by many VMs)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __Code
+{
+    // Friend
+    template <typename WordT, typename BoundsPolicy, typename TracePolicy, typename ProfilePolicy>
+    friend class __VM;
+
+    template <typename VMType, size_t LaneNum>
+    friend class __LaneVM;
+
+    template <typename VMType>
+    friend class __Server;
+
+
+public:
+
+    // Constructor
+    explicit __Code(const string &inputFilePath):
+        __inputFilePath(inputFilePath)
+    {
+        ifstream fdIn(__inputFilePath);
+
+        if (!fdIn)
+        {
+            throw runtime_error("Invalid " + __inputFilePath);
+        }
+
+        __constructCS(fdIn);
+    }
+
+
+    // Constructor (An asm text in memory, inputFilePath only names it)
+    explicit __Code(const string &inputFilePath, const string &asmStr):
+        __inputFilePath(inputFilePath)
+    {
+        istringstream fdIn(asmStr);
+
+        __constructCS(fdIn);
+    }
+
+
+private:
+
+    // Attribute
+    string __inputFilePath;
+    vector<string> __CS;
+
+    // Registers used by "sr N" and "lr N"
+    size_t __RSSize = 0;
+
+    // (Function name, Function start IP) of the ".func" directives
+    vector<pair<string, size_t>> __funcList;
+
+    // The SS words of the global vars of the ".globals" directive, and whether the code calls spawn
+    size_t __globalNum = 0;
+    bool __spawnBool = false;
+
+    // The word size of the ".word" directive, which the consts were folded in (0 for any)
+    size_t __wordSize = 0;
+
+    // The line table of the ".file" and ".line" directives: IP -> Source line (0 for unknown), and the index of its
+    // source file (A linked program has many, see __Linker)
+    vector<string> __sourceFilePathList;
+    vector<size_t> __lineNumList;
+    vector<size_t> __fileIdxList;
+
+
+    // Construct __CS
+    void __constructCS(istream &fdIn)
+    {
+        // (IP, Source line, File index) of the ".line" directives, each one belongs to the last ".file"
+        vector<tuple<size_t, size_t, size_t>> lineTupleList;
+
+        for (string line; getline(fdIn, line);)
+        {
+            // Directives (Not instructions)
+            if (!line.compare(0, 6, ".func "))
+            {
+                istringstream lineStream(line.substr(6));
+                string funcName;
+                size_t funcIP;
+
+                lineStream >> funcName >> funcIP;
+                __funcList.emplace_back(funcName, funcIP);
+            }
+            else if (!line.compare(0, 9, ".globals "))
+            {
+                __globalNum = stoul(line.substr(9));
+            }
+            else if (!line.compare(0, 6, ".word "))
+            {
+                __wordSize = stoul(line.substr(6));
+            }
+            else if (!line.compare(0, 6, ".file "))
+            {
+                __sourceFilePathList.push_back(line.substr(6));
+            }
+            else if (!line.compare(0, 6, ".line "))
+            {
+                istringstream lineStream(line.substr(6));
+
+                lineTupleList.emplace_back(0, 0, __sourceFilePathList.empty() ? 0 : __sourceFilePathList.size() - 1);
+                lineStream >> get<0>(lineTupleList.back()) >> get<1>(lineTupleList.back());
+            }
+            else if (!line.compare(0, 8, ".object "))
+            {
+                throw runtime_error("Invalid asm " + __inputFilePath + " (An object, see --link-file-path)");
+            }
+            else if (line.empty() || line[0] != '.')
+            {
+                __CS.push_back(line);
+            }
+        }
+
+        // Each ".line IP Line" covers the IPs up to the next one
+        __lineNumList.assign(__CS.size(), 0);
+        __fileIdxList.assign(__CS.size(), 0);
+
+        for (size_t idx = 0; idx < lineTupleList.size(); idx++)
+        {
+            auto &[startIP, lineNum, fileIdx] = lineTupleList[idx];
+            size_t endIP = idx + 1 < lineTupleList.size() ? get<0>(lineTupleList[idx + 1]) : __CS.size();
+
+            for (size_t IP = startIP; IP < endIP && IP < __CS.size(); IP++)
+            {
+                __lineNumList[IP] = lineNum;
+                __fileIdxList[IP] = fileIdx;
+            }
+        }
+
+        for (auto &insStr: __CS)
+        {
+            if (!insStr.compare(0, 3, "sr ") && stoul(insStr.substr(3)) >= __RSSize)
+            {
+                __RSSize = stoul(insStr.substr(3)) + 1;
+            }
+
+            if (!insStr.compare(0, 6, "spawn "))
+            {
+                __spawnBool = true;
+            }
+        }
+    }
+
+
+    // Get Source ("File:Line" of an IP, "" if there is no line table)
+    string __getSource(size_t IP) const
+    {
+        if (IP >= __lineNumList.size() || !__lineNumList[IP] || __sourceFilePathList.empty())
+        {
+            return "";
+        }
+
+        return __sourceFilePathList[__fileIdxList[IP]] + ":" + to_string(__lineNumList[IP]);
+    }
+
+
+    // Check Word Size (Of the VM to run it)
+    void __checkWordSize(size_t wordSize) const
+    {
+        if (__wordSize && __wordSize != wordSize)
+        {
+            throw runtime_error("Invalid --word-size " + to_string(wordSize) + " of asm " + __inputFilePath +
+                " (Compiled with -O2 for --word-size " + to_string(__wordSize) + ")");
+        }
+    }
+};
+
+
+}  // End namespace CMM
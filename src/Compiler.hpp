@@ -3,12 +3,21 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <fstream>
 #include <utility>
+#include <tuple>
 #include <stdexcept>
+#include <algorithm>
 #include <cstdio>
 #include <cctype>
+#include <functional>
+#include <chrono>
 #include <boost/format.hpp>
+#include "IR.hpp"
+#include "IRPass.hpp"
+#include "PassManager.hpp"
+#include "Cache.hpp"
 
 namespace CMM
 {
@@ -21,9 +30,14 @@ using std::string;
 using std::to_string;
 using std::vector;
 using std::unordered_map;
+using std::unordered_set;
 using std::ifstream;
 using std::pair;
+using std::tuple;
+using std::get;
 using std::runtime_error;
+using std::sort;
+using std::function;
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -196,16 +210,19 @@ class __AST
 public:
 
     // Constructor
-    explicit __AST(__TokenType tokenType, const string &tokenStr = "", const vector<__AST *> &subList = {}):
+    explicit __AST(__TokenType tokenType, const string &tokenStr = "", const vector<__AST *> &subList = {},
+        size_t lineNum = 0):
         __tokenType(tokenType),
         __tokenStr (tokenStr),
-        __subList  (subList) {}
+        __subList  (subList),
+        __lineNum  (lineNum) {}
 
 
     // Constructor (With __tokenPtr)
     explicit __AST(const __Token *__tokenPtr):
         __tokenType(__tokenPtr->__tokenType),
-        __tokenStr (__tokenPtr->__tokenStr) {}
+        __tokenStr (__tokenPtr->__tokenStr),
+        __lineNum  (__tokenPtr->__lineNum) {}
 
 
     // Destructor
@@ -224,6 +241,7 @@ private:
     __TokenType __tokenType;
     string __tokenStr;
     vector<__AST *> __subList;
+    size_t __lineNum;
 };
 
 
@@ -235,6 +253,7 @@ class __Instruction
 {
     // Friend
     friend class __Compiler;
+    friend class __Linker;
 
 
 public:
@@ -251,6 +270,9 @@ private:
     string __insName;
     string __insArg;
 
+    // The source line (0 for unknown)
+    size_t __lineNum = 0;
+
 
     // To String
     string __toString() const
@@ -267,18 +289,71 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __CSEValue
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __CSEValue
+{
+    // Friend
+    friend class __Compiler;
+
+
+public:
+
+    // Constructor
+    explicit __CSEValue(size_t valNum = 0, int64_t startIP = -1, int64_t stackDepth = 0, int64_t pushIP = -1):
+        __valNum    (valNum),
+        __startIP   (startIP),
+        __stackDepth(stackDepth),
+        __pushIP    (pushIP) {}
+
+
+private:
+
+    /*
+        __valNum:     Value number
+        __startIP:    The first IP of the pure code computing the value (-1 if the code is not pure)
+        __stackDepth: The SS depth at the __startIP
+        __pushIP:     The IP of the "push" which pushes the value into SS (Only for the values in SS)
+    */
+    size_t __valNum;
+    int64_t __startIP;
+    int64_t __stackDepth;
+    int64_t __pushIP;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class __Compiler
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class __Compiler
 {
+    // Friend
+    friend class __Kernel;
+    friend class __Linker;
+
+
 public:
 
     // Constructor
-    explicit __Compiler(const string &inputFilePath, const string &outputFilePath):
-        __inputFilePath (inputFilePath),
-        __outputFilePath(outputFilePath) {}
+    explicit __Compiler(const string &inputFilePath, const string &outputFilePath, size_t inlineBudget = 0,
+        bool inlineReportBool = false, size_t optLevel = 1, const string &printAfterName = "",
+        bool timePassBool = false, __FuncCache *funcCachePtr = nullptr, bool objectBool = false, size_t wordSize = 32):
+        __inputFilePath   (inputFilePath),
+        __outputFilePath  (outputFilePath),
+        __inlineBudget    (inlineBudget),
+        __inlineReportBool(inlineReportBool),
+        __optLevel        (optLevel),
+        __printAfterName  (printAfterName),
+        __timePassBool    (timePassBool),
+        __objectBool      (objectBool),
+        __wordSize        (wordSize),
+
+        // The reports of an inlining and a pass need the codegen of all the functions, and the SSA passes of -O2 are
+        // not local to a function (The IR inline, the mutable globals and the relayout of the frames)
+        __funcCachePtr(inlineReportBool || !printAfterName.empty() || optLevel >= 2 ? nullptr : funcCachePtr) {}
 
 
     // operator()
@@ -288,6 +363,18 @@ public:
     }
 
 
+    // Compile Source (The source text to the asm text, without any file: The input file path only names the source)
+    const string &__compileSource(const string &sourceStr)
+    {
+        __codeStr = sourceStr;
+        __sourceBool = true;
+
+        __runPhaseList();
+
+        return __asmStr;
+    }
+
+
     // Destructor
     ~__Compiler()
     {
@@ -297,10 +384,24 @@ public:
 
 private:
 
+    // The first line of an object (See __outputObject)
+    static constexpr const char *__OBJECT_VERSION = "cmm-obj/1";
+
+
     // Data
     string __inputFilePath;
     string __outputFilePath;
+    size_t __inlineBudget;
+    bool __inlineReportBool;
+    size_t __optLevel;
+    string __printAfterName;
+    bool __timePassBool;
+    bool __objectBool;
+    size_t __wordSize;
+    __FuncCache *__funcCachePtr;
     string __codeStr;
+    bool __sourceBool = false;
+    string __asmStr;
     const char *__codePtr = nullptr;
     size_t __lineNum = 1;
     __LexerState __lexerState;
@@ -310,9 +411,51 @@ private:
     const __Token *__tokenPtr = nullptr;
     __AST *__astRoot = nullptr;
     unordered_map<string, unordered_map<string, pair<size_t, size_t>>> __symMap;
-    string __curFuncName;
+    unordered_map<string, __AST *> __funcMap;
+    unordered_map<string, size_t> __frameSizeMap;
+    unordered_map<string, unordered_set<string>> __callGraph;
+    unordered_set<string> __inlineSet;
+    unordered_map<string, size_t> __inlineSizeMap;
+    mutable string __curFuncName;
+    mutable size_t __frameBase = 0;
+    mutable size_t __inlineDepth = 0;
+    vector<string> __funcNameList;
+    unordered_map<string, vector<__Instruction>> __codeMap;
+    unordered_map<string, __IRFunction> __irMap;
+    unordered_set<string> __mutableGlobalSet;
+
+    // An object (See __outputObject): The imported functions (Name -> Param number) and global vars
+    unordered_map<string, size_t> __importMap;
+    unordered_set<string> __externSet;
+
+    // An object: The exported functions (Name -> (Param number, The function or its wrapper, see __genCodeExport))
+    unordered_map<string, pair<size_t, string>> __exportMap;
+    __IRFunction *__irFuncPtr = nullptr;
+    size_t __irBlockNum = 0;
+    size_t __irLineNum = 0;
+    vector<unordered_map<string, int64_t>> __irDefList;
+    vector<unordered_map<string, int64_t>> __irIncompleteList;
+    vector<vector<size_t>> __irPredList;
+    vector<bool> __irSealedList;
+    unordered_map<int64_t, const __IRInstruction *> __irDefMap;
+    unordered_set<int64_t> __irTreeSet;
+    unordered_map<int64_t, size_t> __irSlotMap;
     vector<__Instruction> __codeList;
 
+    // (Function name, Function start IP), in the layout order
+    vector<pair<string, size_t>> __funcLayoutList;
+
+    // The functions of __funcCachePtr: The global var layout of the keys, the reused functions, and the key of each
+    // generated one (Stored after the passes)
+    string __globalSigStr;
+    unordered_set<string> __reusedFuncSet;
+    unordered_map<string, string> __funcKeyMap;
+
+    // Statistics: (Phase name, Time (ms)), (Pass name, Time (ms)) and the AST node number
+    vector<pair<string, double>> __phaseTimeList;
+    vector<tuple<string, double>> __passTimeList;
+    size_t __astNodeNum = 0;
+
 
     // Invalid Char
     void __invalidChar(char curChar) const
@@ -667,14 +810,19 @@ private:
     // Construct __tokenList
     void __constructTokenList()
     {
-        ifstream fdIn(__inputFilePath);
-
-        if (!fdIn)
+        // The source text may be given by __compileSource
+        if (!__sourceBool)
         {
-            throw runtime_error("Invalid " + __inputFilePath);
+            ifstream fdIn(__inputFilePath);
+
+            if (!fdIn)
+            {
+                throw runtime_error("Invalid " + __inputFilePath);
+            }
+
+            getline(fdIn, __codeStr, '\0');
         }
 
-        getline(fdIn, __codeStr, '\0');
         __codePtr = __codeStr.data();
 
         for (auto curToken = __nextToken();; curToken = __nextToken())
@@ -728,7 +876,7 @@ private:
                     |---- [__Decl]
                     |...
         */
-        root = new __AST(__TokenType::__Program, "Program", {nullptr});
+        root = new __AST(__TokenType::__Program, "Program", {nullptr}, __tokenPtr->__lineNum);
         __astDecl(root->__subList[0]);
 
         while (__tokenPtr->__tokenType != __TokenType::__End)
@@ -788,7 +936,7 @@ private:
                     |---- __TokenType::__Id
                     |---- [__TokenType::__Number]
         */
-        root = new __AST(__TokenType::__VarDecl, "VarDecl", {nullptr, nullptr});
+        root = new __AST(__TokenType::__VarDecl, "VarDecl", {nullptr, nullptr}, __tokenPtr->__lineNum);
         __astType(root->__subList[0]);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id)
@@ -851,7 +999,8 @@ private:
                     |---- __LocalDecl
                     |---- __StmtList
         */
-        root = new __AST(__TokenType::__FuncDecl, "FuncDecl", {nullptr, nullptr, nullptr, nullptr, nullptr});
+        root = new __AST(__TokenType::__FuncDecl, "FuncDecl", {nullptr, nullptr, nullptr, nullptr, nullptr},
+            __tokenPtr->__lineNum);
         __astType(root->__subList[0]);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id)
@@ -889,7 +1038,7 @@ private:
         */
         if (__tokenPtr->__tokenType == __TokenType::__Int || __tokenPtr->__tokenType == __TokenType::__Void)
         {
-            root = new __AST(__TokenType::__ParamList, "ParamList", {nullptr});
+            root = new __AST(__TokenType::__ParamList, "ParamList", {nullptr}, __tokenPtr->__lineNum);
             __astParam(root->__subList[0]);
 
             while (__tokenPtr->__tokenType == __TokenType::__Comma)
@@ -914,7 +1063,7 @@ private:
                     |---- __Type
                     |---- __TokenType::__Id
         */
-        root = new __AST(__TokenType::__Param, "Param", {nullptr, nullptr});
+        root = new __AST(__TokenType::__Param, "Param", {nullptr, nullptr}, __tokenPtr->__lineNum);
         __astType(root->__subList[0]);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id)
@@ -947,7 +1096,7 @@ private:
                     |---- [__VarDecl]
                     |...
         */
-        root = new __AST(__TokenType::__LocalDecl, "LocalDecl");
+        root = new __AST(__TokenType::__LocalDecl, "LocalDecl", {}, __tokenPtr->__lineNum);
 
         while (__tokenPtr->__tokenType == __TokenType::__Int || __tokenPtr->__tokenType == __TokenType::__Void)
         {
@@ -969,7 +1118,7 @@ private:
                     |---- [__Stmt]
                     |...
         */
-        root = new __AST(__TokenType::__StmtList, "StmtList");
+        root = new __AST(__TokenType::__StmtList, "StmtList", {}, __tokenPtr->__lineNum);
 
         while (__tokenPtr->__tokenType == __TokenType::__Semicolon     ||
             __tokenPtr->__tokenType == __TokenType::__Id               ||
@@ -1059,7 +1208,7 @@ private:
                     |---- __StmtList
                     |---- [__StmtList]
         */
-        root = new __AST(__TokenType::__IfStmt, "IfStmt", {nullptr, nullptr});
+        root = new __AST(__TokenType::__IfStmt, "IfStmt", {nullptr, nullptr}, __tokenPtr->__lineNum);
 
         __matchToken(__TokenType::__If);
         __matchToken(__TokenType::__LeftRoundBracket);
@@ -1092,7 +1241,7 @@ private:
                     |---- __Expr
                     |---- __StmtList
         */
-        root = new __AST(__TokenType::__WhileStmt, "WhileStmt", {nullptr, nullptr});
+        root = new __AST(__TokenType::__WhileStmt, "WhileStmt", {nullptr, nullptr}, __tokenPtr->__lineNum);
 
         __matchToken(__TokenType::__While);
         __matchToken(__TokenType::__LeftRoundBracket);
@@ -1115,7 +1264,7 @@ private:
                 __TokenType::__ReturnStmt
                     |---- [__Expr]
         */
-        root = new __AST(__TokenType::__ReturnStmt, "ReturnStmt");
+        root = new __AST(__TokenType::__ReturnStmt, "ReturnStmt", {}, __tokenPtr->__lineNum);
         __matchToken(__TokenType::__Return);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id               ||
@@ -1146,7 +1295,7 @@ private:
                 __TokenType::__Expr
                     |---- __SimpleExpr
         */
-        root = new __AST(__TokenType::__Expr, "Expr", {nullptr});
+        root = new __AST(__TokenType::__Expr, "Expr", {nullptr}, __tokenPtr->__lineNum);
 
         if (__tokenPtr->__tokenType == __TokenType::__LeftRoundBracket || __tokenPtr->__tokenType == __TokenType::__Number)
         {
@@ -1197,7 +1346,7 @@ private:
                     |---- __TokenType::__Id
                     |---- [__Expr]
         */
-        root = new __AST(__TokenType::__Var, "Var", {nullptr});
+        root = new __AST(__TokenType::__Var, "Var", {nullptr}, __tokenPtr->__lineNum);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id)
         {
@@ -1232,7 +1381,7 @@ private:
                     |---- [__RelOp]
                     |---- [__AddExpr]
         */
-        root = new __AST(__TokenType::__SimpleExpr, "SimpleExpr", {nullptr});
+        root = new __AST(__TokenType::__SimpleExpr, "SimpleExpr", {nullptr}, __tokenPtr->__lineNum);
         __astAddExpr(root->__subList[0]);
 
         if (__tokenPtr->__tokenType == __TokenType::__Less         ||
@@ -1301,7 +1450,7 @@ private:
                     |---- [__Term]
                     |...
         */
-        root = new __AST(__TokenType::__AddExpr, "AddExpr", {nullptr});
+        root = new __AST(__TokenType::__AddExpr, "AddExpr", {nullptr}, __tokenPtr->__lineNum);
         __astTerm(root->__subList[0]);
 
         while (__tokenPtr->__tokenType == __TokenType::__Plus || __tokenPtr->__tokenType == __TokenType::__Minus)
@@ -1351,7 +1500,7 @@ private:
                     |---- [__Factor]
                     |...
         */
-        root = new __AST(__TokenType::__Term, "Term", {nullptr});
+        root = new __AST(__TokenType::__Term, "Term", {nullptr}, __tokenPtr->__lineNum);
         __astFactor(root->__subList[0]);
 
         while (__tokenPtr->__tokenType == __TokenType::__Multiply || __tokenPtr->__tokenType == __TokenType::__Divide)
@@ -1441,7 +1590,7 @@ private:
                     |---- __TokenType::__Id
                     |---- [__ArgList]
         */
-        root = new __AST(__TokenType::__Call, "Call", {nullptr});
+        root = new __AST(__TokenType::__Call, "Call", {nullptr}, __tokenPtr->__lineNum);
 
         if (__tokenPtr->__tokenType == __TokenType::__Id)
         {
@@ -1480,7 +1629,7 @@ private:
                     |---- [__Expr]
                     |...
         */
-        root = new __AST(__TokenType::__ArgList, "ArgList", {nullptr});
+        root = new __AST(__TokenType::__ArgList, "ArgList", {nullptr}, __tokenPtr->__lineNum);
         __astExpr(root->__subList[0]);
 
         while (__tokenPtr->__tokenType == __TokenType::__Comma)
@@ -1532,6 +1681,7 @@ private:
                 size_t varIdx = 0;
                 string funcName = declNodePtr->__subList[1]->__tokenStr;
                 __symMap[funcName];
+                __funcMap[funcName] = declNodePtr;
 
                 if (declNodePtr->__subList[2])
                 {
@@ -1571,6 +1721,9 @@ private:
                     __symMap[funcName][varName] = {varIdx, varSize};
                     varIdx += varSize + 1;
                 }
+
+                // Number of SS slots used by the params and the local vars
+                __frameSizeMap[funcName] = varIdx;
             }
             else
             {
@@ -1589,483 +1742,686 @@ private:
     }
 
 
-    // Generate Code: Number
-    vector<__Instruction> __genCodeNumber(__AST *root) const
+    // Count AST Node
+    size_t __countAstNode(__AST *root) const
     {
-        /*
-            __TokenType::__Number
-        */
-        return {{"ldc", root->__tokenStr}};
-    }
-
+        if (!root)
+        {
+            return 0;
+        }
 
-    // Generate Code: StmtList
-    vector<__Instruction> __genCodeStmtList(__AST *root) const
-    {
-        /*
-            __TokenType::__StmtList
-                |---- [__Stmt]
-                |...
-        */
-        vector<__Instruction> codeList;
+        size_t nodeNum = 1;
 
-        for (auto stmtPtr: root->__subList)
+        for (auto subPtr: root->__subList)
         {
-            auto stmtCodeList = __genCodeStmt(stmtPtr);
-            codeList.insert(codeList.end(), stmtCodeList.begin(), stmtCodeList.end());
+            nodeNum += __countAstNode(subPtr);
         }
 
-        return codeList;
+        return nodeNum;
     }
 
 
-    // Generate Code: Stmt
-    vector<__Instruction> __genCodeStmt(__AST *root) const
+    // Is Builtin
+    bool __isBuiltin(const string &funcName) const
     {
-        /*
-            __ExprStmt | __IfStmt | __WhileStmt | __ReturnStmt
-            __ExprStmt: __Expr | nullptr
-        */
-        if (!root)
-        {
-            return {};
-        }
-
-        switch (root->__tokenType)
-        {
-            case __TokenType::__Expr:
-                return __genCodeExpr(root);
-
-            case __TokenType::__IfStmt:
-                return __genCodeIfStmt(root);
+        return funcName == "input" || funcName == "output" || funcName == "spawn" || funcName == "join" ||
+            funcName == "atomicAdd" || funcName == "atomicCas" || !__getArrayInsName(funcName).empty();
+    }
 
-            case __TokenType::__WhileStmt:
-                return __genCodeWhileStmt(root);
 
-            case __TokenType::__ReturnStmt:
-                return __genCodeReturnStmt(root);
+    // Get Array Instruction (Of an array builtin, "" if it is not one, or a function of the program has its name)
+    string __getArrayInsName(const string &funcName) const
+    {
+        static const unordered_map<string, string> insNameMap {
+            {"fill", "afill"}, {"copy", "acopy"}, {"sum", "asum"}, {"argmin", "amin"}, {"dot", "adot"},
+        };
 
-            default:
-                throw runtime_error("Invalid __TokenType");
-        }
+        return insNameMap.count(funcName) && !__funcMap.count(funcName) ? insNameMap.at(funcName) : "";
     }
 
 
-    // Generate Code: IfStmt
-    vector<__Instruction> __genCodeIfStmt(__AST *root) const
+    // Check Builtin Arg (The arg number of a builtin call)
+    void __checkBuiltinArg(__AST *root) const
     {
         /*
-            __TokenType::__IfStmt
-                |---- __Expr
-                |---- __StmtList
-                |---- [__StmtList]
+            input(), output(X), spawn(F, Arg0, Arg1, ...), join(Handle),
+            atomicAdd(Array, Index, Value), atomicCas(Array, Index, Expect, Desire),
+            fill(Array, Lo, Hi, Value), copy(Dst, Src, N), sum(Array, Lo, Hi), argmin(Array, Lo, Hi), dot(Lhs, Rhs, N)
         */
-        auto codeList   = __genCodeExpr(root->__subList[0]);
-        auto ifCodeList = __genCodeStmtList(root->__subList[1]);
+        static const unordered_map<string, size_t> argNumMap {
+            {"input", 0}, {"output", 1}, {"spawn", 1}, {"join", 1}, {"atomicAdd", 3}, {"atomicCas", 4},
+            {"fill", 4}, {"copy", 3}, {"sum", 3}, {"argmin", 3}, {"dot", 3},
+        };
 
-        if (root->__subList.size() == 2)
-        {
-            /*
-                if ...
-                    jz end
-                    ...
-                end:
-                    ...
-            */
-            codeList.emplace_back("jz", to_string(ifCodeList.size() + 1));
-            codeList.insert(codeList.end(), ifCodeList.begin(), ifCodeList.end());
-        }
-        else
-        {
-            /*
-                if ...
-                    jz else
-                    ...
-                    jmp end
-                else:
-                    ...
-                end:
-                    ...
-            */
-            auto elseCodeList = __genCodeStmtList(root->__subList[2]);
+        string funcName = root->__subList[0]->__tokenStr;
+        size_t argNum = root->__subList.size() == 2 ? root->__subList[1]->__subList.size() : 0;
 
-            ifCodeList.emplace_back("jmp", to_string(elseCodeList.size() + 1));
-            codeList.emplace_back("jz", to_string(ifCodeList.size() + 1));
-            codeList.insert(codeList.end(), ifCodeList.begin(), ifCodeList.end());
-            codeList.insert(codeList.end(), elseCodeList.begin(), elseCodeList.end());
+        if (funcName == "spawn" ? argNum < argNumMap.at(funcName) : argNum != argNumMap.at(funcName))
+        {
+            throw runtime_error((boost::format("Invalid arg number of %s in line %zd") %
+                funcName % root->__lineNum).str());
         }
-
-        return codeList;
     }
 
 
-    // Generate Code: WhileStmt
-    vector<__Instruction> __genCodeWhileStmt(__AST *root) const
+    // Get Spawn Function (The first arg of a spawn call must be the name of a function)
+    string __getSpawnFuncName(__AST *root) const
     {
         /*
-            __TokenType::__WhileStmt
-                |---- __Expr
-                |---- __StmtList
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- __TokenType::__ArgList
+                        |---- __Expr
+                                |---- __SimpleExpr
+                                        |---- __AddExpr
+                                                |---- __Term
+                                                        |---- __Var
+                                                                |---- __TokenType::__Id
         */
-        auto codeList     = __genCodeExpr(root->__subList[0]);
-        auto stmtCodeList = __genCodeStmtList(root->__subList[1]);
+        __AST *argPtr = root->__subList[1]->__subList[0];
 
-        /*
-            while ...
-                jz end
-                ...
-                jmp while
-            end:
-                ...
-        */
-        codeList.emplace_back("jz", to_string(stmtCodeList.size() + 2));
-        codeList.insert(codeList.end(), stmtCodeList.begin(), stmtCodeList.end());
-        codeList.emplace_back("jmp", "-" + to_string(codeList.size()));
+        for (int _ = 0; _ < 4 && argPtr->__subList.size() == 1; _++)
+        {
+            argPtr = argPtr->__subList[0];
+        }
 
-        return codeList;
+        // The function of an object may be imported
+        if (argPtr->__tokenType != __TokenType::__Var || argPtr->__subList.size() != 1 ||
+            (!__funcMap.count(argPtr->__subList[0]->__tokenStr) && !__objectBool))
+        {
+            throw runtime_error((boost::format("Invalid function of spawn in line %zd") % root->__lineNum).str());
+        }
+
+        return argPtr->__subList[0]->__tokenStr;
     }
 
 
-    // Generate Code: ReturnStmt
-    vector<__Instruction> __genCodeReturnStmt(__AST *root) const
+    // Collect Callee
+    void __collectCallee(__AST *root, unordered_set<string> &calleeSet) const
     {
+        if (!root)
+        {
+            return;
+        }
+
         /*
-            __TokenType::__ReturnStmt
-                |---- [__Expr]
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- [__ArgList]
         */
-        if (root->__subList.empty())
+        if (root->__tokenType == __TokenType::__Call)
         {
-            return {};
+            if (!__isBuiltin(root->__subList[0]->__tokenStr))
+            {
+                calleeSet.insert(root->__subList[0]->__tokenStr);
+            }
+            else
+            {
+                __checkBuiltinArg(root);
+
+                // The function of a task is called as well (By the task)
+                if (root->__subList[0]->__tokenStr == "spawn")
+                {
+                    calleeSet.insert(__getSpawnFuncName(root));
+                }
+            }
         }
-        else
+
+        for (auto subPtr: root->__subList)
         {
-            return __genCodeExpr(root->__subList[0]);
+            __collectCallee(subPtr, calleeSet);
         }
     }
 
 
-    // Generate Code: Expr
-    vector<__Instruction> __genCodeExpr(__AST *root) const
+    // Collect Import (The functions called but not defined by an object, with their param numbers)
+    void __collectImport(__AST *root)
     {
-        /*
-            __TokenType::__Expr
-                |---- __Var
-                |---- __Expr
-            ----------------------
-            __TokenType::__Expr
-                |---- __SimpleExpr
-        */
-        if (root->__subList.size() == 1)
+        if (!root)
         {
-            return __genCodeSimpleExpr(root->__subList[0]);
+            return;
         }
-        else
+
+        if (root->__tokenType == __TokenType::__Call)
         {
-            auto codeList       = __genCodeExpr(root->__subList[1]);
-            auto assignCodeList = __genCodeAssign(root->__subList[0]);
+            string funcName = root->__subList[0]->__tokenStr;
+            size_t argNum = root->__subList.size() == 2 ? root->__subList[1]->__subList.size() : 0;
 
-            codeList.insert(codeList.end(), assignCodeList.begin(), assignCodeList.end());
+            // The function of a task gets the args after it
+            if (funcName == "spawn")
+            {
+                funcName = __getSpawnFuncName(root);
+                argNum--;
+            }
 
-            return codeList;
+            if (!__isBuiltin(funcName) && !__funcMap.count(funcName))
+            {
+                if (auto importIter = __importMap.find(funcName); importIter == __importMap.end())
+                {
+                    __importMap[funcName] = argNum;
+                }
+                else if (importIter->second != argNum)
+                {
+                    throw runtime_error((boost::format("Invalid arg number of %s in line %zd (%zu args elsewhere)") %
+                        funcName % root->__lineNum % importIter->second).str());
+                }
+            }
+        }
+
+        for (auto subPtr: root->__subList)
+        {
+            __collectImport(subPtr);
         }
     }
 
 
-    // Generate Code: Var
-    vector<__Instruction> __genCodeVar(__AST *root) const
+    // Collect Extern (The global vars used but not defined by an object)
+    void __collectExtern(__AST *root, const string &funcName)
     {
-        /*
-            __TokenType::__Var
-                |---- __TokenType::__Id
-                |---- [__Expr]
-        */
-        vector<__Instruction> codeList;
+        if (!root)
+        {
+            return;
+        }
 
-        // Local var
-        if (__symMap.at(__curFuncName).count(root->__subList[0]->__tokenStr))
+        if (root->__tokenType == __TokenType::__Var && !__symMap.at(funcName).count(root->__subList[0]->__tokenStr) &&
+            !__symMap.at("__GLOBAL__").count(root->__subList[0]->__tokenStr))
         {
-            codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at(root->__subList[0]->__tokenStr).first));
-            codeList.emplace_back("ld");
+            __externSet.insert(root->__subList[0]->__tokenStr);
         }
-        // Global var
-        else
+
+        // The first arg of a spawn call is a function
+        bool spawnBool = root->__tokenType == __TokenType::__Call && root->__subList[0]->__tokenStr == "spawn";
+
+        for (size_t subIdx = 0; subIdx < root->__subList.size(); subIdx++)
         {
-            codeList.emplace_back("ldc", to_string(__symMap.at("__GLOBAL__").at(root->__subList[0]->__tokenStr).first));
-            codeList.emplace_back("ald");
+            if (spawnBool && subIdx == 1)
+            {
+                for (size_t argIdx = 1; argIdx < root->__subList[1]->__subList.size(); argIdx++)
+                {
+                    __collectExtern(root->__subList[1]->__subList[argIdx], funcName);
+                }
+            }
+            else
+            {
+                __collectExtern(root->__subList[subIdx], funcName);
+            }
         }
+    }
 
-        // Array
-        if (root->__subList.size() == 2)
+
+    // Is Recursive (The function can reach itself in the call graph)
+    bool __isRecursive(const string &funcName) const
+    {
+        unordered_set<string> visitedSet;
+        vector<string> funcStack(__callGraph.at(funcName).begin(), __callGraph.at(funcName).end());
+
+        while (!funcStack.empty())
         {
-            auto exprCodeList = __genCodeExpr(root->__subList[1]);
+            string curFuncName = funcStack.back();
+            funcStack.pop_back();
 
-            codeList.emplace_back("push");
-            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
-            codeList.emplace_back("add");
-            codeList.emplace_back("pop");
-            codeList.emplace_back("ald");
+            if (curFuncName == funcName)
+            {
+                return true;
+            }
+
+            if (visitedSet.insert(curFuncName).second && __callGraph.count(curFuncName))
+            {
+                funcStack.insert(funcStack.end(), __callGraph.at(curFuncName).begin(), __callGraph.at(curFuncName).end());
+            }
         }
 
-        return codeList;
+        return false;
     }
 
 
-    // Generate Code: SimpleExpr
-    vector<__Instruction> __genCodeSimpleExpr(__AST *root) const
+    // Is Inlinable
+    bool __isInlinable(const string &funcName) const
     {
-        /*
-            __TokenType::__SimpleExpr
-                |---- __AddExpr
-                |---- [__RelOp]
-                |---- [__AddExpr]
-        */
-        if (root->__subList.size() == 1)
+        if (funcName == "main" || __isRecursive(funcName))
         {
-            return __genCodeAddExpr(root->__subList[0]);
+            return false;
         }
-        else
+
+        // A local array needs a "lea" relative to the SS top, which is unknown inside an expression
+        for (auto &[_, infoPair]: __symMap.at(funcName))
         {
-            auto codeList      = __genCodeAddExpr(root->__subList[0]);
-            auto midCodeList   = __genCodeRelOp(root->__subList[1]);
-            auto rightCodeList = __genCodeAddExpr(root->__subList[2]);
+            if (infoPair.second)
+            {
+                return false;
+            }
+        }
 
-            codeList.emplace_back("push");
-            codeList.insert(codeList.end(), rightCodeList.begin(), rightCodeList.end());
-            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
-            codeList.emplace_back("pop");
+        /*
+            __TokenType::__FuncDecl
+                |---- __Type
+                |---- __TokenType::__Id
+                |---- __ParamList | nullptr
+                |---- __LocalDecl
+                |---- __StmtList
+        */
+        return __countAstNode(__funcMap.at(funcName)->__subList[4]) <= __inlineBudget;
+    }
 
-            return codeList;
+
+    // Calc Inline Size
+    size_t __calcInlineSize(const string &funcName)
+    {
+        if (__inlineSizeMap.count(funcName))
+        {
+            return __inlineSizeMap.at(funcName);
+        }
+
+        /*
+            All the inlined call sites of a function share one region on the top of its frame,
+            since an inlined callee has finished before the next one starts.
+            (The callees of an inlined callee live inside the frame of the callee itself)
+        */
+        size_t inlineSize = 0;
+
+        for (auto &calleeName: __callGraph.at(funcName))
+        {
+            if (__inlineSet.count(calleeName))
+            {
+                inlineSize = std::max(inlineSize, __frameSizeMap.at(calleeName) + __calcInlineSize(calleeName));
+            }
         }
+
+        __inlineSizeMap[funcName] = inlineSize;
+
+        return inlineSize;
     }
 
 
-    // Generate Code: RelOp
-    vector<__Instruction> __genCodeRelOp(__AST *root) const
+    // Construct __callGraph
+    void __constructCallGraph()
     {
         /*
-            __TokenType::__Less         |
-            __TokenType::__LessEqual    |
-            __TokenType::__Greater      |
-            __TokenType::__GreaterEqual |
-            __TokenType::__Equal        |
-            __TokenType::__NotEqual
+            Function name -> Callee name set
         */
-        switch (root->__tokenType)
+        for (auto &[funcName, funcPtr]: __funcMap)
         {
-            case __TokenType::__Less:
-                return {{"lt"}};
+            __collectCallee(funcPtr->__subList[4], __callGraph[funcName]);
 
-            case __TokenType::__LessEqual:
-                return {{"le"}};
+            for (auto &calleeName: __callGraph.at(funcName))
+            {
+                if (!__funcMap.count(calleeName) && !__objectBool)
+                {
+                    throw runtime_error("Invalid function: " + calleeName);
+                }
+            }
 
-            case __TokenType::__Greater:
-                return {{"gt"}};
+            // Nothing is inlined until the inline pass runs
+            __inlineSizeMap[funcName] = 0;
+        }
 
-            case __TokenType::__GreaterEqual:
-                return {{"ge"}};
+        /*
+            An object calls an imported function by its params only: Its frame is given by the wrapper of its export
+            (See __genCodeExport), and resolved by the linker
+        */
+        if (__objectBool)
+        {
+            for (auto &[funcName, funcPtr]: __funcMap)
+            {
+                __collectImport(funcPtr->__subList[4]);
+                __collectExtern(funcPtr->__subList[4], funcName);
+            }
 
-            case __TokenType::__Equal:
-                return {{"eq"}};
+            for (auto &[funcName, paramNum]: __importMap)
+            {
+                __symMap[funcName];
 
-            case __TokenType::__NotEqual:
-                return {{"ne"}};
+                for (size_t paramIdx = 0; paramIdx < paramNum; paramIdx++)
+                {
+                    __symMap[funcName]["%" + to_string(paramIdx)] = {paramIdx, 0};
+                }
 
-            default:
-                throw runtime_error("Invalid __TokenType");
+                __callGraph[funcName];
+                __frameSizeMap[funcName]  = paramNum;
+                __inlineSizeMap[funcName] = 0;
+            }
+
+            // All the functions are exported
+            for (auto declPtr: __astRoot->__subList)
+            {
+                if (declPtr->__tokenType == __TokenType::__FuncDecl)
+                {
+                    __funcNameList.push_back(declPtr->__subList[1]->__tokenStr);
+                }
+            }
+
+            return;
         }
-    }
 
+        // Only the functions reachable from the "main" function in the call graph (In declaration order)
+        unordered_set<string> reachableSet;
+        vector<string> funcStack {"main"};
+
+        if (!__funcMap.count("main"))
+        {
+            throw runtime_error("Invalid function: main");
+        }
+
+        while (!funcStack.empty())
+        {
+            string funcName = funcStack.back();
+            funcStack.pop_back();
+
+            if (reachableSet.insert(funcName).second)
+            {
+                funcStack.insert(funcStack.end(), __callGraph.at(funcName).begin(), __callGraph.at(funcName).end());
+            }
+        }
 
-    // Generate Code: AddExpr
-    vector<__Instruction> __genCodeAddExpr(__AST *root) const
-    {
         /*
-            __TokenType::__AddExpr
-                |---- __Term
-                |---- [__AddOp]
-                |---- [__Term]
+            __TokenType::__Program
+                |---- __Decl
+                |---- [__Decl]
                 |...
         */
-        auto codeList = __genCodeTerm(root->__subList[0]);
+        for (auto declPtr: __astRoot->__subList)
+        {
+            if (declPtr->__tokenType == __TokenType::__FuncDecl && reachableSet.count(declPtr->__subList[1]->__tokenStr))
+            {
+                __funcNameList.push_back(declPtr->__subList[1]->__tokenStr);
+            }
+        }
+    }
 
-        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+
+    // Construct __inlineSet
+    void __constructInlineSet()
+    {
+        for (auto &[funcName, _]: __funcMap)
         {
-            auto midCodeList   = __genCodeAddOp(root->__subList[idx]);
-            auto rightCodeList = __genCodeTerm(root->__subList[idx + 1]);
+            if (__inlineBudget && __isInlinable(funcName))
+            {
+                __inlineSet.insert(funcName);
+            }
+        }
 
-            codeList.emplace_back("push");
-            codeList.insert(codeList.end(), rightCodeList.begin(), rightCodeList.end());
-            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
-            codeList.emplace_back("pop");
+        __inlineSizeMap.clear();
+
+        for (auto &[funcName, _]: __importMap)
+        {
+            __inlineSizeMap[funcName] = 0;
         }
 
-        return codeList;
+        for (auto &[funcName, _]: __funcMap)
+        {
+            __calcInlineSize(funcName);
+        }
     }
 
 
-    // Generate Code: AddOp
-    vector<__Instruction> __genCodeAddOp(__AST *root) const
+    // Generate Code: Number
+    vector<__Instruction> __genCodeNumber(__AST *root) const
     {
         /*
-            __TokenType::__Plus | __TokenType::__Minus
+            __TokenType::__Number
         */
-        if (root->__tokenType == __TokenType::__Plus)
-        {
-            return {{"add"}};
-        }
-        else
-        {
-            return {{"sub"}};
-        }
+        return {{"ldc", root->__tokenStr}};
     }
 
 
-    // Generate Code: Term
-    vector<__Instruction> __genCodeTerm(__AST *root) const
+    // Generate Code: StmtList
+    vector<__Instruction> __genCodeStmtList(__AST *root) const
     {
         /*
-            __TokenType::__Term
-                |---- __Factor
-                |---- [__MulOp]
-                |---- [__Factor]
+            __TokenType::__StmtList
+                |---- [__Stmt]
                 |...
         */
-        auto codeList = __genCodeFactor(root->__subList[0]);
+        vector<__Instruction> codeList;
 
-        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+        for (auto stmtPtr: root->__subList)
         {
-            auto midCodeList   = __genCodeMulOp(root->__subList[idx]);
-            auto rightCodeList = __genCodeFactor(root->__subList[idx + 1]);
+            auto stmtCodeList = __genCodeStmt(stmtPtr);
+            codeList.insert(codeList.end(), stmtCodeList.begin(), stmtCodeList.end());
 
-            codeList.emplace_back("push");
-            codeList.insert(codeList.end(), rightCodeList.begin(), rightCodeList.end());
-            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
-            codeList.emplace_back("pop");
+            // The statements after a "return" are unreachable
+            if (stmtPtr && stmtPtr->__tokenType == __TokenType::__ReturnStmt)
+            {
+                break;
+            }
         }
 
         return codeList;
     }
 
 
-    // Generate Code: MulOp
-    vector<__Instruction> __genCodeMulOp(__AST *root) const
+    // Set Line Number (Only the instructions without one, the nested statements already have their own ones)
+    static void __setLineNum(vector<__Instruction> &codeList, size_t lineNum)
     {
-        /*
-            __TokenType::__Multiply | __TokenType::__Divide
-        */
-        if (root->__tokenType == __TokenType::__Multiply)
-        {
-            return {{"mul"}};
-        }
-        else
+        for (auto &insObj: codeList)
         {
-            return {{"div"}};
+            if (!insObj.__lineNum)
+            {
+                insObj.__lineNum = lineNum;
+            }
         }
     }
 
 
-    // Generate Code: Factor
-    vector<__Instruction> __genCodeFactor(__AST *root) const
+    // Generate Code: Stmt
+    vector<__Instruction> __genCodeStmt(__AST *root) const
     {
         /*
-            __Expr | __TokenType::__Number | __Call | __Var
+            __ExprStmt | __IfStmt | __WhileStmt | __ReturnStmt
+            __ExprStmt: __Expr | nullptr
         */
+        if (!root)
+        {
+            return {};
+        }
+
+        vector<__Instruction> codeList;
+
         switch (root->__tokenType)
         {
             case __TokenType::__Expr:
-                return __genCodeExpr(root);
+                codeList = __genCodeExpr(root);
+                break;
 
-            case __TokenType::__Number:
-                return __genCodeNumber(root);
+            case __TokenType::__IfStmt:
+                codeList = __genCodeIfStmt(root);
+                break;
 
-            case __TokenType::__Call:
-                return __genCodeCall(root);
+            case __TokenType::__WhileStmt:
+                codeList = __genCodeWhileStmt(root);
+                break;
 
-            case __TokenType::__Var:
-                return __genCodeVar(root);
+            case __TokenType::__ReturnStmt:
+                codeList = __genCodeReturnStmt(root);
+                break;
 
             default:
                 throw runtime_error("Invalid __TokenType");
         }
+
+        __setLineNum(codeList, root->__lineNum);
+
+        return codeList;
     }
 
 
-    // Generate Code: Call
-    vector<__Instruction> __genCodeCall(__AST *root) const
+    // Generate Code: IfStmt
+    vector<__Instruction> __genCodeIfStmt(__AST *root) const
     {
         /*
-            __TokenType::__Call
-                |---- __TokenType::__Id
-                |---- [__ArgList]
+            __TokenType::__IfStmt
+                |---- __Expr
+                |---- __StmtList
+                |---- [__StmtList]
         */
-        // xxx = input();
-        if (root->__subList[0]->__tokenStr == "input")
+        auto codeList   = __genCodeExpr(root->__subList[0]);
+        auto ifCodeList = __genCodeStmtList(root->__subList[1]);
+
+        if (root->__subList.size() == 2)
         {
-            return {{"in"}};
+            /*
+                if ...
+                    jz end
+                    ...
+                end:
+                    ...
+            */
+            codeList.emplace_back("jz", to_string(ifCodeList.size() + 1));
+            codeList.insert(codeList.end(), ifCodeList.begin(), ifCodeList.end());
         }
-        // output(xxx);
-        else if (root->__subList[0]->__tokenStr == "output")
+        else
         {
             /*
-                __TokenType::__ArgList
-                    |---- __Expr
+                if ...
+                    jz else
+                    ...
+                    jmp end
+                else:
+                    ...
+                end:
+                    ...
             */
-            auto codeList = __genCodeExpr(root->__subList[1]->__subList[0]);
-
-            codeList.emplace_back("out");
+            auto elseCodeList = __genCodeStmtList(root->__subList[2]);
 
-            return codeList;
+            ifCodeList.emplace_back("jmp", to_string(elseCodeList.size() + 1));
+            codeList.emplace_back("jz", to_string(ifCodeList.size() + 1));
+            codeList.insert(codeList.end(), ifCodeList.begin(), ifCodeList.end());
+            codeList.insert(codeList.end(), elseCodeList.begin(), elseCodeList.end());
         }
 
-        vector<__Instruction> codeList;
-        vector<pair<string, pair<size_t, size_t>>> pairList(__symMap.at(root->__subList[0]->__tokenStr).size());
+        return codeList;
+    }
 
-        // ..., Local5, Local4, Local3, Param2, Param1, Param0
-        for (auto &mapPair: __symMap.at(root->__subList[0]->__tokenStr))
-        {
-            pairList[pairList.size() - mapPair.second.first - 1] = mapPair;
-        }
 
-        // We only need local var here
-        size_t topIdx = pairList.size() - (root->__subList.size() == 2 ?
+    // Generate Code: WhileStmt
+    vector<__Instruction> __genCodeWhileStmt(__AST *root) const
+    {
+        /*
+            __TokenType::__WhileStmt
+                |---- __Expr
+                |---- __StmtList
+        */
+        auto codeList     = __genCodeExpr(root->__subList[0]);
+        auto stmtCodeList = __genCodeStmtList(root->__subList[1]);
 
-            // Call function by at least one parameter
-            root->__subList[1]->__subList.size() :
+        /*
+            while ...
+                jz end
+                ...
+                jmp while
+            end:
+                ...
+        */
+        codeList.emplace_back("jz", to_string(stmtCodeList.size() + 2));
+        codeList.insert(codeList.end(), stmtCodeList.begin(), stmtCodeList.end());
+        codeList.emplace_back("jmp", "-" + to_string(codeList.size()));
 
-            // Call function without any parameter
-            0);
+        return codeList;
+    }
 
-        // Push local var
-        for (size_t idx = 0; idx < topIdx; idx++)
+
+    // Generate Code: ReturnStmt
+    vector<__Instruction> __genCodeReturnStmt(__AST *root) const
+    {
+        /*
+            __TokenType::__ReturnStmt
+                |---- [__Expr]
+        */
+        vector<__Instruction> codeList;
+
+        if (!root->__subList.empty())
         {
-            // Array
-            if (pairList[idx].second.second)
+            if (auto callPtr = __optLevel ? __getTailCall(root->__subList[0]) : nullptr)
             {
-                // Push array content (by array size times)
-                for (size_t _ = 0; _ < pairList[idx].second.second; _++)
-                {
-                    codeList.emplace_back("push");
-                }
+                return __genCodeTailCall(callPtr);
+            }
 
-                /*
-                    The instruction "lea N" calculate the array start pointer (absolute index in SS).
-                    SS:
-                        ... X X X X X X X X X $
-                            ^     Size = N    ^
-                            |                 |
-                         SP - N               SP
-                */
-                codeList.emplace_back("lea", to_string(pairList[idx].second.second));
-                codeList.emplace_back("push");
+            codeList = __genCodeExpr(root->__subList[0]);
+        }
+
+        /*
+            The return value is already in AX.
+            (The "ret" of the "main" function or an inlined function will be translated to a "jmp" later)
+        */
+        codeList.emplace_back("ret");
+
+        return codeList;
+    }
+
+
+    // Has Local Array
+    bool __hasLocalArray(const string &funcName) const
+    {
+        for (auto &[_, infoPair]: __symMap.at(funcName))
+        {
+            if (infoPair.second)
+            {
+                return true;
             }
-            // Scalar
-            else
+        }
+
+        return false;
+    }
+
+
+    // Get Tail Call
+    __AST *__getTailCall(__AST *root) const
+    {
+        /*
+            __TokenType::__Expr
+                |---- __SimpleExpr
+                        |---- __AddExpr
+                                |---- __Term
+                                        |---- __Call
+        */
+        for (int _ = 0; _ < 4; _++)
+        {
+            if (root->__subList.size() != 1)
             {
-                codeList.emplace_back("push");
+                return nullptr;
             }
+
+            root = root->__subList[0];
         }
 
-        // Push parameter
+        if (root->__tokenType != __TokenType::__Call || __inlineDepth || __curFuncName == "main")
+        {
+            return nullptr;
+        }
+
+        string funcName = root->__subList[0]->__tokenStr;
+
+        if (__isBuiltin(funcName) || __inlineSet.count(funcName))
+        {
+            return nullptr;
+        }
+
+        /*
+            The callee frame must fit in the current frame, and neither of them may have a local array:
+            The array pointers can not be moved with the frame, and the args may point to the current frame.
+        */
+        if (__frameSizeMap.at(funcName) + __inlineSizeMap.at(funcName) >
+            __frameSizeMap.at(__curFuncName) + __inlineSizeMap.at(__curFuncName) ||
+            __hasLocalArray(funcName) || __hasLocalArray(__curFuncName))
+        {
+            return nullptr;
+        }
+
+        return root;
+    }
+
+
+    // Generate Code: TailCall
+    vector<__Instruction> __genCodeTailCall(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- [__ArgList]
+        */
+        auto codeList = __genCodeFrame(root->__subList[0]->__tokenStr, root->__subList.size() == 2 ?
+            root->__subList[1]->__subList.size() : 0);
+
         if (root->__subList.size() == 2)
         {
             auto argListCodeList = __genCodeArgList(root->__subList[1]);
@@ -2074,313 +2430,3735 @@ private:
         }
 
         /*
-            The instruction "CALL N" perform multiple actions:
+            The instruction "TAILCALL N" moves the new frame to the current frame:
+
+            Before:
+                ... Local3 Param2 Param1 Param0 OldBP OldIP Local3' Param1' Param0'
+                                         ^
+                                         BP
+            After:
+                ... Local3 Local3' Param1' Param0' OldBP OldIP
+                                           ^
+                                           BP
+
+            Then IP += N, and the callee returns to the caller of the current function directly.
+            (The caller pops the current frame, which is not smaller than the callee frame)
+        */
+        codeList.emplace_back("tailcall", root->__subList[0]->__tokenStr);
 
-            1. SS.PUSH(BP)
-                Now the SS is like:
-                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
+        return codeList;
+    }
 
-            2. BP = SS.SIZE() - 2
-                Now the SS is like:
-                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
-                                                         ^
-                                                         BP
-            3. SS.PUSH(IP)
-                Now the SS is like:
-                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP OldIP
-                                                         ^
-                                                         BP
-            4. IP += N
-                In addition, the "N" of the "CALL N" is only a function name right now,
-                it will be translated to a number later. (See the function: __translateCall)
+
+    // Generate Code: Expr
+    vector<__Instruction> __genCodeExpr(__AST *root) const
+    {
+        vector<__Instruction> codeList;
+
+        __genCodeExpr(root, codeList);
+
+        return codeList;
+    }
+
+
+    /*
+        The expressions are appended to the codeList of the caller, instead of each level returning its own code,
+        which the level above copies again (Quadratic in the nesting depth)
+    */
+    void __genCodeExpr(__AST *root, vector<__Instruction> &codeList) const
+    {
+        /*
+            __TokenType::__Expr
+                |---- __Var
+                |---- __Expr
+            ----------------------
+            __TokenType::__Expr
+                |---- __SimpleExpr
         */
-        codeList.emplace_back("call", root->__subList[0]->__tokenStr);
+        if (root->__subList.size() == 1)
+        {
+            __genCodeSimpleExpr(root->__subList[0], codeList);
+        }
+        else
+        {
+            __genCodeExpr(root->__subList[1], codeList);
+
+            auto assignCodeList = __genCodeAssign(root->__subList[0]);
+
+            codeList.insert(codeList.end(), assignCodeList.begin(), assignCodeList.end());
+        }
+    }
+
+
+    // Get Global Address (The var number, or "@Name" of an object, which is resolved by the linker)
+    string __getGlobalAddr(const string &varName) const
+    {
+        return __objectBool ? "@" + varName : to_string(__symMap.at("__GLOBAL__").at(varName).first);
+    }
+
+
+    // Generate Code: Var
+    void __genCodeVar(__AST *root, vector<__Instruction> &codeList) const
+    {
+        /*
+            __TokenType::__Var
+                |---- __TokenType::__Id
+                |---- [__Expr]
+        */
+        // Local var
+        if (__symMap.at(__curFuncName).count(root->__subList[0]->__tokenStr))
+        {
+            codeList.emplace_back("ldc", to_string(__frameBase + __symMap.at(__curFuncName).at(root->__subList[0]->__tokenStr).first));
+            codeList.emplace_back("ld");
+        }
+        // Global var
+        else
+        {
+            codeList.emplace_back("ldc", __getGlobalAddr(root->__subList[0]->__tokenStr));
+            codeList.emplace_back("ald");
+        }
 
-        // After call, we need several "POP" to pop all vars.
-        for (auto &[_, mapVal]: __symMap.at(root->__subList[0]->__tokenStr))
+        // Array
+        if (root->__subList.size() == 2)
         {
-            // Any var needs a "POP"
+            codeList.emplace_back("push");
+            __genCodeExpr(root->__subList[1], codeList);
+            codeList.emplace_back("add");
             codeList.emplace_back("pop");
+            codeList.emplace_back("ald");
+        }
+    }
 
-            // Pop array content (by array size times)
-            for (size_t _ = 0; _ < mapVal.second; _++)
-            {
-                codeList.emplace_back("pop");
-            }
+
+    // Generate Code: SimpleExpr
+    void __genCodeSimpleExpr(__AST *root, vector<__Instruction> &codeList) const
+    {
+        /*
+            __TokenType::__SimpleExpr
+                |---- __AddExpr
+                |---- [__RelOp]
+                |---- [__AddExpr]
+        */
+        __genCodeAddExpr(root->__subList[0], codeList);
+
+        if (root->__subList.size() == 3)
+        {
+            auto midCodeList = __genCodeRelOp(root->__subList[1]);
+
+            codeList.emplace_back("push");
+            __genCodeAddExpr(root->__subList[2], codeList);
+            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
+            codeList.emplace_back("pop");
         }
+    }
 
-        return codeList;
+
+    // Generate Code: RelOp
+    vector<__Instruction> __genCodeRelOp(__AST *root) const
+    {
+        /*
+            __TokenType::__Less         |
+            __TokenType::__LessEqual    |
+            __TokenType::__Greater      |
+            __TokenType::__GreaterEqual |
+            __TokenType::__Equal        |
+            __TokenType::__NotEqual
+        */
+        switch (root->__tokenType)
+        {
+            case __TokenType::__Less:
+                return {{"lt"}};
+
+            case __TokenType::__LessEqual:
+                return {{"le"}};
+
+            case __TokenType::__Greater:
+                return {{"gt"}};
+
+            case __TokenType::__GreaterEqual:
+                return {{"ge"}};
+
+            case __TokenType::__Equal:
+                return {{"eq"}};
+
+            case __TokenType::__NotEqual:
+                return {{"ne"}};
+
+            default:
+                throw runtime_error("Invalid __TokenType");
+        }
     }
 
 
-    // Generate Code: ArgList
-    vector<__Instruction> __genCodeArgList(__AST *root) const
+    // Generate Code: AddExpr
+    void __genCodeAddExpr(__AST *root, vector<__Instruction> &codeList) const
     {
         /*
-            __TokenType::__ArgList
-                |---- __Expr
-                |---- [__Expr]
+            __TokenType::__AddExpr
+                |---- __Term
+                |---- [__AddOp]
+                |---- [__Term]
                 |...
         */
-        vector<__Instruction> codeList;
+        __genCodeTerm(root->__subList[0], codeList);
+
+        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+        {
+            auto midCodeList = __genCodeAddOp(root->__subList[idx]);
+
+            codeList.emplace_back("push");
+            __genCodeTerm(root->__subList[idx + 1], codeList);
+            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
+            codeList.emplace_back("pop");
+        }
+    }
+
+
+    // Generate Code: AddOp
+    vector<__Instruction> __genCodeAddOp(__AST *root) const
+    {
+        /*
+            __TokenType::__Plus | __TokenType::__Minus
+        */
+        if (root->__tokenType == __TokenType::__Plus)
+        {
+            return {{"add"}};
+        }
+        else
+        {
+            return {{"sub"}};
+        }
+    }
+
+
+    // Generate Code: Term
+    void __genCodeTerm(__AST *root, vector<__Instruction> &codeList) const
+    {
+        /*
+            __TokenType::__Term
+                |---- __Factor
+                |---- [__MulOp]
+                |---- [__Factor]
+                |...
+        */
+        __genCodeFactor(root->__subList[0], codeList);
+
+        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+        {
+            auto midCodeList = __genCodeMulOp(root->__subList[idx]);
+
+            codeList.emplace_back("push");
+            __genCodeFactor(root->__subList[idx + 1], codeList);
+            codeList.insert(codeList.end(), midCodeList.begin(), midCodeList.end());
+            codeList.emplace_back("pop");
+        }
+    }
+
+
+    // Generate Code: MulOp
+    vector<__Instruction> __genCodeMulOp(__AST *root) const
+    {
+        /*
+            __TokenType::__Multiply | __TokenType::__Divide
+        */
+        if (root->__tokenType == __TokenType::__Multiply)
+        {
+            return {{"mul"}};
+        }
+        else
+        {
+            return {{"div"}};
+        }
+    }
+
+
+    // Generate Code: Factor
+    void __genCodeFactor(__AST *root, vector<__Instruction> &codeList) const
+    {
+        /*
+            __Expr | __TokenType::__Number | __Call | __Var
+        */
+        vector<__Instruction> subCodeList;
+
+        switch (root->__tokenType)
+        {
+            case __TokenType::__Expr:
+                __genCodeExpr(root, codeList);
+                return;
+
+            case __TokenType::__Number:
+                subCodeList = __genCodeNumber(root);
+                break;
+
+            case __TokenType::__Call:
+                subCodeList = __genCodeCall(root);
+                break;
+
+            case __TokenType::__Var:
+                __genCodeVar(root, codeList);
+                return;
+
+            default:
+                throw runtime_error("Invalid __TokenType");
+        }
+
+        codeList.insert(codeList.end(), subCodeList.begin(), subCodeList.end());
+    }
+
+
+    // Generate Code: Call
+    vector<__Instruction> __genCodeCall(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- [__ArgList]
+        */
+        // xxx = input();
+        if (root->__subList[0]->__tokenStr == "input")
+        {
+            return {{"in"}};
+        }
+        // output(xxx);
+        else if (root->__subList[0]->__tokenStr == "output")
+        {
+            /*
+                __TokenType::__ArgList
+                    |---- __Expr
+            */
+            auto codeList = __genCodeExpr(root->__subList[1]->__subList[0]);
+
+            codeList.emplace_back("out");
+
+            return codeList;
+        }
+        // xxx = spawn(F, Arg0, Arg1, ...);
+        else if (root->__subList[0]->__tokenStr == "spawn")
+        {
+            return __genCodeSpawn(root);
+        }
+        // xxx = join(Handle);
+        else if (root->__subList[0]->__tokenStr == "join")
+        {
+            auto codeList = __genCodeExpr(root->__subList[1]->__subList[0]);
+
+            codeList.emplace_back("join");
+
+            return codeList;
+        }
+        // xxx = atomicAdd(Array, Index, Value); xxx = atomicCas(Array, Index, Expect, Desire);
+        else if (root->__subList[0]->__tokenStr == "atomicAdd" || root->__subList[0]->__tokenStr == "atomicCas")
+        {
+            return __genCodeAtomic(root);
+        }
+        // xxx = fill(Array, Lo, Hi, Value); xxx = sum(Array, Lo, Hi); ...
+        else if (!__getArrayInsName(root->__subList[0]->__tokenStr).empty())
+        {
+            return __genCodeArray(root);
+        }
+
+        // Inline
+        if (__inlineSet.count(root->__subList[0]->__tokenStr))
+        {
+            return __genCodeInline(root);
+        }
+
+        // Push local var
+        auto codeList = __genCodeFrame(root->__subList[0]->__tokenStr, root->__subList.size() == 2 ?
+
+            // Call function by at least one parameter
+            root->__subList[1]->__subList.size() :
+
+            // Call function without any parameter
+            0);
+
+        // Push parameter
+        if (root->__subList.size() == 2)
+        {
+            auto argListCodeList = __genCodeArgList(root->__subList[1]);
+
+            codeList.insert(codeList.end(), argListCodeList.begin(), argListCodeList.end());
+        }
+
+        /*
+            The instruction "CALL N" perform multiple actions:
+
+            1. SS.PUSH(BP)
+                Now the SS is like:
+                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
+
+            2. BP = SS.SIZE() - 2
+                Now the SS is like:
+                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
+                                                         ^
+                                                         BP
+            3. SS.PUSH(IP)
+                Now the SS is like:
+                ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP OldIP
+                                                         ^
+                                                         BP
+            4. IP += N
+                In addition, the "N" of the "CALL N" is only a function name right now,
+                it will be translated to a number later. (See the function: __translateCall)
+        */
+        codeList.emplace_back("call", root->__subList[0]->__tokenStr);
+
+        // After call, we need several "POP" to pop all vars (And the array content, the inline region)
+        for (size_t _ = 0; _ < __frameSizeMap.at(root->__subList[0]->__tokenStr) +
+            __inlineSizeMap.at(root->__subList[0]->__tokenStr); _++)
+        {
+            codeList.emplace_back("pop");
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Spawn
+    vector<__Instruction> __genCodeSpawn(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id ("spawn")
+                |---- __ArgList
+                        |---- __Expr (F)
+                        |---- [__Expr]
+                        |...
+        */
+        string funcName = __getSpawnFuncName(root);
+        auto &argList = root->__subList[1]->__subList;
+
+        // The same frame as a call of F
+        auto codeList = __genCodeFrame(funcName, argList.size() - 1);
+
+        for (size_t idx = argList.size() - 1; idx > 0; idx--)
+        {
+            auto exprCodeList = __genCodeExpr(argList[idx]);
+
+            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+            codeList.emplace_back("push");
+        }
+
+        /*
+            The instruction "SPAWN N" moves the frame (AX words on the top of SS) to a new task:
+
+            1. The task runs from IP + N with the frame, the same as a "CALL N", and ends at the "RET" of F
+            2. AX = The handle of the task
+
+            The frame is still popped by the caller.
+        */
+        size_t frameSize = __frameSizeMap.at(funcName) + __inlineSizeMap.at(funcName);
+
+        codeList.emplace_back("ldc", to_string(frameSize));
+        codeList.emplace_back("spawn", funcName);
+
+        for (size_t _ = 0; _ < frameSize; _++)
+        {
+            codeList.emplace_back("pop");
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Atomic
+    vector<__Instruction> __genCodeAtomic(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id ("atomicAdd" | "atomicCas")
+                |---- __ArgList
+                        |---- __Expr (Array)
+                        |---- __Expr (Index)
+                        |---- __Expr (Value | Expect)
+                        |---- [__Expr (Desire)]
+
+            The args are evaluated from the last one, then "AADD" / "ACAS" get the address Array + Index in AX:
+
+            AADD: AX = Old value, Array[Index] += SS.TOP()
+            ACAS: AX = Old value, if (Old value == SS.TOP()) Array[Index] = SS[SS.SIZE() - 2]
+        */
+        auto &argList = root->__subList[1]->__subList;
+        vector<__Instruction> codeList;
+
+        for (size_t idx = argList.size() - 1; idx > 0; idx--)
+        {
+            auto exprCodeList = __genCodeExpr(argList[idx]);
+
+            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+            codeList.emplace_back("push");
+        }
+
+        auto arrayCodeList = __genCodeExpr(argList[0]);
+
+        // Array + Index (The index is on the top of SS)
+        codeList.insert(codeList.end(), arrayCodeList.begin(), arrayCodeList.end());
+        codeList.emplace_back("add");
+        codeList.emplace_back("pop");
+        codeList.emplace_back(root->__subList[0]->__tokenStr == "atomicAdd" ? "aadd" : "acas");
+
+        for (size_t _ = 2; _ < argList.size(); _++)
+        {
+            codeList.emplace_back("pop");
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Array
+    vector<__Instruction> __genCodeArray(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id ("fill" | "copy" | "sum" | "argmin" | "dot")
+                |---- __ArgList
+                        |---- __Expr (Array | Dst | Lhs)
+                        |---- __Expr
+                        |...
+
+            The args are evaluated from the last one, then the instruction gets the first one in AX and the others
+            from the top of SS, and runs a whole loop in the VM (See the class: __ArrayKernel):
+
+            AFILL: Array[Lo, Hi) = Value, AX = Hi - Lo
+            ACOPY: Dst[0, N) = Src[0, N), AX = N
+            ASUM:  AX = Array[Lo] + ... + Array[Hi - 1]
+            AMIN:  AX = The index of the first min of Array[Lo, Hi)
+            ADOT:  AX = Lhs[0] * Rhs[0] + ... + Lhs[N - 1] * Rhs[N - 1]
+        */
+        auto &argList = root->__subList[1]->__subList;
+        vector<__Instruction> codeList;
+
+        for (size_t idx = argList.size() - 1; idx > 0; idx--)
+        {
+            auto exprCodeList = __genCodeExpr(argList[idx]);
+
+            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+            codeList.emplace_back("push");
+        }
+
+        auto arrayCodeList = __genCodeExpr(argList[0]);
+
+        codeList.insert(codeList.end(), arrayCodeList.begin(), arrayCodeList.end());
+        codeList.emplace_back(__getArrayInsName(root->__subList[0]->__tokenStr));
+
+        for (size_t _ = 1; _ < argList.size(); _++)
+        {
+            codeList.emplace_back("pop");
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Frame
+    vector<__Instruction> __genCodeFrame(const string &funcName, size_t paramNum) const
+    {
+        vector<__Instruction> codeList;
+        vector<pair<size_t, size_t>> infoList;
+
+        // We only need local var here
+        for (auto &[_, infoPair]: __symMap.at(funcName))
+        {
+            if (infoPair.first >= paramNum)
+            {
+                infoList.push_back(infoPair);
+            }
+        }
+
+        // ..., Local5, Local4, Local3, (Param2, Param1, Param0)
+        sort(infoList.begin(), infoList.end(), [](const pair<size_t, size_t> &lhs, const pair<size_t, size_t> &rhs)
+        {
+            return lhs.first > rhs.first;
+        });
+
+        // The inline region is on the top of the frame
+        for (size_t _ = 0; _ < __inlineSizeMap.at(funcName); _++)
+        {
+            codeList.emplace_back("push");
+        }
+
+        for (auto &[_, varSize]: infoList)
+        {
+            // Array
+            if (varSize)
+            {
+                // Push array content (by array size times)
+                for (size_t _ = 0; _ < varSize; _++)
+                {
+                    codeList.emplace_back("push");
+                }
+
+                /*
+                    The instruction "lea N" calculate the array start pointer (absolute index in SS).
+                    SS:
+                        ... X X X X X X X X X $
+                            ^     Size = N    ^
+                            |                 |
+                         SP - N               SP
+                */
+                codeList.emplace_back("lea", to_string(varSize));
+                codeList.emplace_back("push");
+            }
+            // Scalar
+            else
+            {
+                codeList.emplace_back("push");
+            }
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Inline
+    vector<__Instruction> __genCodeInline(__AST *root) const
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- [__ArgList]
+        */
+        string funcName = root->__subList[0]->__tokenStr;
+
+        // The callee vars are remapped to the inline region of the current frame
+        size_t inlineBase = __frameBase + __frameSizeMap.at(__curFuncName);
+        vector<__Instruction> codeList;
+
+        if (__inlineReportBool)
+        {
+            fprintf(stderr, "Inline: %s -> %s (line %zu)\n", __curFuncName.c_str(), funcName.c_str(), root->__lineNum);
+        }
+
+        // Push parameter, then save them to the inline region (Param0 is on the top)
+        if (root->__subList.size() == 2)
+        {
+            codeList = __genCodeArgList(root->__subList[1]);
+
+            for (size_t idx = 0; idx < root->__subList[1]->__subList.size(); idx++)
+            {
+                codeList.emplace_back("ldc", to_string(inlineBase + idx));
+                codeList.emplace_back("st");
+                codeList.emplace_back("pop");
+            }
+        }
+
+        auto curFuncNameBak = __curFuncName;
+        auto frameBaseBak   = __frameBase;
+
+        __curFuncName = funcName;
+        __frameBase   = inlineBase;
+        __inlineDepth++;
+
+        /*
+            __TokenType::__FuncDecl
+                |---- __Type
+                |---- __TokenType::__Id
+                |---- __ParamList | nullptr
+                |---- __LocalDecl
+                |---- __StmtList
+        */
+        auto bodyCodeList = __genCodeStmtList(__funcMap.at(funcName)->__subList[4]);
+
+        __curFuncName = curFuncNameBak;
+        __frameBase   = frameBaseBak;
+        __inlineDepth--;
+
+        // A trailing "ret" falls through to the continuation
+        if (!bodyCodeList.empty() && bodyCodeList.back().__insName == "ret")
+        {
+            bodyCodeList.pop_back();
+        }
+
+        // Every "ret" jumps to the continuation (The return value is already in AX)
+        for (size_t IP = 0; IP < bodyCodeList.size(); IP++)
+        {
+            if (bodyCodeList[IP].__insName == "ret")
+            {
+                bodyCodeList[IP] = {"jmp", to_string(bodyCodeList.size() - IP)};
+            }
+        }
+
+        codeList.insert(codeList.end(), bodyCodeList.begin(), bodyCodeList.end());
+
+        return codeList;
+    }
+
+
+    // Generate Code: ArgList
+    vector<__Instruction> __genCodeArgList(__AST *root) const
+    {
+        /*
+            __TokenType::__ArgList
+                |---- __Expr
+                |---- [__Expr]
+                |...
+        */
+        vector<__Instruction> codeList;
+
+        for (int64_t idx = (int64_t)root->__subList.size() - 1; idx >= 0; idx--)
+        {
+            auto exprCodeList = __genCodeExpr(root->__subList[idx]);
+
+            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+            codeList.emplace_back("push");
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Assign
+    vector<__Instruction> __genCodeAssign(__AST *root) const
+    {
+        /*
+            __TokenType::__Expr
+                |---- __Var  -> Root
+                |---- __Expr -> AX
+        */
+        vector<__Instruction> codeList {{"push"}};
+
+        // Local var
+        if (__symMap.at(__curFuncName).count(root->__subList[0]->__tokenStr))
+        {
+            codeList.emplace_back("ldc", to_string(__frameBase + __symMap.at(__curFuncName).at(root->__subList[0]->__tokenStr).first));
+
+            // Scalar
+            if (root->__subList.size() == 1)
+            {
+                codeList.emplace_back("st");
+            }
+            // Array
+            else
+            {
+                auto exprCodeList = __genCodeExpr(root->__subList[1]);
+
+                // Get the (start) pointer (is already an absolute address)
+                codeList.emplace_back("ld");
+                codeList.emplace_back("push");
+                codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+
+                // Pointer[Index] (Pointer + Index)
+                codeList.emplace_back("add");
+                codeList.emplace_back("pop");
+
+                // Save by absolute address
+                codeList.emplace_back("ast");
+            }
+        }
+        // Global var
+        else
+        {
+            codeList.emplace_back("ldc", __getGlobalAddr(root->__subList[0]->__tokenStr));
+
+            // Scalar
+            if (root->__subList.size() == 1)
+            {
+                codeList.emplace_back("ast");
+            }
+            // Array
+            else
+            {
+                auto exprCodeList = __genCodeExpr(root->__subList[1]);
+
+                // Absolute get the (start) pointer (is already an absolute address)
+                codeList.emplace_back("ald");
+                codeList.emplace_back("push");
+                codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+
+                // Pointer[Index] (Pointer + Index)
+                codeList.emplace_back("add");
+                codeList.emplace_back("pop");
+
+                // Save by absolute address
+                codeList.emplace_back("ast");
+            }
+        }
+
+        // The value of an assignment is the value assigned (AX is the address right now)
+        codeList.emplace_back(codeList.back().__insName == "st" ? "ld" : "ald");
+        codeList.emplace_back("pop");
+
+        return codeList;
+    }
+
+
+    // Generate Code: Global Var
+    vector<__Instruction> __genCodeGlobalVar() const
+    {
+        vector<__Instruction> codeList;
+        vector<pair<size_t, size_t>> infoList;
+
+        for (auto &[_, infoPair]: __symMap.at("__GLOBAL__"))
+        {
+            infoList.push_back(infoPair);
+        }
+
+        // The global vars must be pushed in the order of their var numbers
+        sort(infoList.begin(), infoList.end());
+
+        for (auto &infoPair: infoList)
+        {
+            // Array
+            if (infoPair.second)
+            {
+                // Calc the array start address (var number + 1)
+                codeList.emplace_back("ldc", to_string(infoPair.first + 1));
+            }
+
+            // Push the array start address
+            // (Or only a meaningless int for global scalar memeory)
+            codeList.emplace_back("push");
+
+            // Push array content (by array size times)
+            for (size_t _ = 0; _ < infoPair.second; _++)
+            {
+                codeList.emplace_back("push");
+            }
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Begin
+    vector<__Instruction> __genCodeBegin() const
+    {
+        // The "main" function is a special function, so the following code is similar with the function: __genCodeCall
+        // The "main" function has definitely no params
+        auto codeList = __genCodeFrame("main", 0);
+
+        // Call the "main" function automatically
+        codeList.emplace_back("call", "main");
+
+        return codeList;
+    }
+
+
+    // Generate Code: Global (The global vars of an object are pushed by the linker, which calls the "main" function)
+    vector<__Instruction> __genCodeGlobal() const
+    {
+        if (__objectBool)
+        {
+            return __funcMap.count("main") ? __genCodeBegin() : vector<__Instruction>();
+        }
+
+        auto codeList = __genCodeGlobalVar();
+        auto beginCodeList = __genCodeBegin();
+
+        codeList.insert(codeList.end(), beginCodeList.begin(), beginCodeList.end());
+
+        return codeList;
+    }
+
+
+    // Get Jump Target List
+    vector<bool> __getJumpTargetList(const vector<__Instruction> &codeList) const
+    {
+        vector<bool> jmpTargetList(codeList.size() + 1);
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            if (codeList[IP].__insName == "jmp" || codeList[IP].__insName == "jz")
+            {
+                jmpTargetList[IP + stoll(codeList[IP].__insArg)] = true;
+            }
+        }
+
+        return jmpTargetList;
+    }
+
+
+    // Apply Edit
+    vector<__Instruction> __applyEdit(const vector<__Instruction> &codeList, const vector<vector<__Instruction>> &editList) const
+    {
+        /*
+            editList[IP] is the new code of codeList[IP], a "jmp" or a "jz" must be kept as the first one of it.
+            newIPList[IP] is the new IP of codeList[IP] (Or the next alive instruction if it is removed).
+        */
+        vector<int64_t> newIPList(codeList.size() + 1);
+        vector<__Instruction> newCodeList;
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            newIPList[IP] = newCodeList.size();
+            newCodeList.insert(newCodeList.end(), editList[IP].begin(), editList[IP].end());
+        }
+
+        newIPList[codeList.size()] = newCodeList.size();
+
+        // Translate the jump offsets
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            if ((codeList[IP].__insName == "jmp" || codeList[IP].__insName == "jz") && !editList[IP].empty())
+            {
+                newCodeList[newIPList[IP]].__insArg = to_string(newIPList[IP + stoll(codeList[IP].__insArg)] - newIPList[IP]);
+            }
+        }
+
+        return newCodeList;
+    }
+
+
+    // Optimize: Common Subexpression Elimination
+    vector<__Instruction> __optimizeCSE(const vector<__Instruction> &codeList) const
+    {
+        /*
+            Value numbering over the extended basic blocks (A "jz" only leaves a block, a jump target starts a new one).
+
+            A value is "closed" at an IP if the code from its __startIP to the IP is pure and keeps the SS depth,
+            such as "ldc 0, ld, push, ldc 3, ld, add, pop, ald" (numArray[nowIdx]).
+
+            The first closed occurrence of a value is saved to a register by "sr N",
+            the later occurrences in the same block are replaced by "lr N".
+        */
+        static const unordered_set<string> binOpSet {"add", "sub", "mul", "div", "lt", "le", "gt", "ge", "eq", "ne"};
+
+        auto jmpTargetList = __getJumpTargetList(codeList);
+
+        // Expression -> Value number
+        unordered_map<string, size_t> valNumMap;
+
+        // Value number -> Constant
+        unordered_map<size_t, string> constMap;
+
+        // Local var number -> Store version
+        unordered_map<string, size_t> ldVerMap;
+
+        size_t valNum = 0, blockNum = 0, aldVer = 0, verNum = 0;
+        int64_t stackDepth = 0;
+        __CSEValue axVal;
+        vector<__CSEValue> stackValList;
+
+        // (Start IP, End IP, Value number, Block number)
+        vector<tuple<int64_t, int64_t, size_t, size_t>> closedList;
+
+        auto getValNum = [&](const string &expStr)
+        {
+            return valNumMap.emplace(expStr, valNum).second ? valNum++ : valNumMap.at(expStr);
+        };
+
+        auto resetBlock = [&]()
+        {
+            valNumMap.clear();
+            constMap.clear();
+            ldVerMap.clear();
+            stackValList.clear();
+            stackDepth = 0;
+            axVal = __CSEValue(valNum++);
+            blockNum++;
+        };
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            auto &insName = codeList[IP].__insName;
+            auto &insArg  = codeList[IP].__insArg;
+
+            if (jmpTargetList[IP])
+            {
+                resetBlock();
+            }
+
+            if (insName == "ldc")
+            {
+                axVal = __CSEValue(getValNum("ldc " + insArg), IP, stackDepth);
+                constMap[axVal.__valNum] = insArg;
+            }
+            else if (insName == "ld" && constMap.count(axVal.__valNum))
+            {
+                auto &varNum = constMap.at(axVal.__valNum);
+
+                axVal.__valNum = getValNum("ld " + varNum + " " + to_string(ldVerMap[varNum]));
+            }
+            else if (insName == "ald")
+            {
+                axVal.__valNum = getValNum("ald " + to_string(axVal.__valNum) + " " + to_string(aldVer));
+            }
+            else if (insName == "push")
+            {
+                stackValList.emplace_back(axVal.__valNum, axVal.__stackDepth == stackDepth ? axVal.__startIP : -1,
+                    stackDepth, IP);
+
+                stackDepth++;
+                axVal.__startIP = -1;
+            }
+            else if (insName == "pop")
+            {
+                if (!stackValList.empty())
+                {
+                    stackValList.pop_back();
+                }
+
+                stackDepth--;
+            }
+            else if (binOpSet.count(insName) && !stackValList.empty())
+            {
+                // Left: SS top, Right: AX
+                auto &lhsVal = stackValList.back();
+                bool pureBool = lhsVal.__startIP >= 0 && axVal.__startIP == lhsVal.__pushIP + 1 &&
+                    axVal.__stackDepth == stackDepth;
+
+                axVal = __CSEValue(getValNum(insName + " " + to_string(lhsVal.__valNum) + " " + to_string(axVal.__valNum)),
+                    pureBool ? lhsVal.__startIP : -1, lhsVal.__stackDepth);
+            }
+            else if (insName == "st" && constMap.count(axVal.__valNum) && !stackValList.empty())
+            {
+                // Store to a local var, the later load gets the stored value directly
+                auto &varNum = constMap.at(axVal.__valNum);
+
+                ldVerMap[varNum] = ++verNum;
+                valNumMap["ld " + varNum + " " + to_string(verNum)] = stackValList.back().__valNum;
+                axVal.__startIP = -1;
+            }
+            else if (insName == "ast" && !stackValList.empty())
+            {
+                // Store by absolute address may change any array element (Or global var)
+                aldVer = ++verNum;
+                valNumMap["ald " + to_string(axVal.__valNum) + " " + to_string(aldVer)] = stackValList.back().__valNum;
+                axVal.__startIP = -1;
+            }
+            else if (insName == "jz" || insName == "out")
+            {
+                axVal.__startIP = -1;
+            }
+            else if (insName == "in" || insName == "lea")
+            {
+                axVal = __CSEValue(valNum++);
+            }
+            else
+            {
+                // "jmp", "call", "ret", the task instructions and anything unknown
+                resetBlock();
+                continue;
+            }
+
+            if ((insName == "ldc" || insName == "ld" || insName == "ald" || insName == "pop") &&
+                axVal.__startIP >= 0 && axVal.__stackDepth == stackDepth)
+            {
+                closedList.emplace_back(axVal.__startIP, IP, axVal.__valNum, blockNum);
+            }
+        }
+
+        // Value number -> (Occurrence number, Max code size)
+        unordered_map<size_t, pair<size_t, int64_t>> occurMap;
+
+        for (auto &[startIP, endIP, closedValNum, _]: closedList)
+        {
+            occurMap[closedValNum].first++;
+            occurMap[closedValNum].second = std::max(occurMap[closedValNum].second, endIP - startIP + 1);
+        }
+
+        // Outer value first
+        sort(closedList.begin(), closedList.end(), [](const tuple<int64_t, int64_t, size_t, size_t> &lhs,
+            const tuple<int64_t, int64_t, size_t, size_t> &rhs)
+        {
+            return get<0>(lhs) != get<0>(rhs) ? get<0>(lhs) < get<0>(rhs) : get<1>(lhs) > get<1>(rhs);
+        });
+
+        // Value number -> (Register number, Save IP, Use number)
+        unordered_map<size_t, tuple<size_t, int64_t, size_t>> regMap;
+
+        // Block number -> Register number
+        unordered_map<size_t, size_t> regNumMap;
+
+        // (Start IP, End IP, Register number)
+        vector<tuple<int64_t, int64_t, size_t>> replaceList;
+        int64_t replaceEndIP = -1;
+
+        for (auto &[startIP, endIP, closedValNum, closedBlockNum]: closedList)
+        {
+            // Skip the single instruction, the value used only once and the code already replaced
+            if (endIP == startIP || occurMap.at(closedValNum).first < 2 || occurMap.at(closedValNum).second < 3 ||
+                startIP <= replaceEndIP)
+            {
+                continue;
+            }
+
+            if (!regMap.count(closedValNum))
+            {
+                regMap[closedValNum] = {regNumMap[closedBlockNum]++, endIP, 0};
+            }
+            else
+            {
+                replaceList.emplace_back(startIP, endIP, get<0>(regMap.at(closedValNum)));
+                get<2>(regMap.at(closedValNum))++;
+                replaceEndIP = endIP;
+            }
+        }
+
+        vector<vector<__Instruction>> editList;
+
+        for (auto &insObj: codeList)
+        {
+            editList.push_back({insObj});
+        }
+
+        for (auto &[_, regTuple]: regMap)
+        {
+            if (get<2>(regTuple))
+            {
+                editList[get<1>(regTuple)].emplace_back("sr", to_string(get<0>(regTuple)));
+            }
+        }
+
+        for (auto &[startIP, endIP, regNum]: replaceList)
+        {
+            editList[startIP] = {{"lr", to_string(regNum)}};
+
+            for (auto IP = startIP + 1; IP <= endIP; IP++)
+            {
+                editList[IP].clear();
+            }
+        }
+
+        return __applyEdit(codeList, editList);
+    }
+
+
+    // Get Successor List
+    vector<size_t> __getSuccList(const vector<__Instruction> &codeList, size_t IP) const
+    {
+        if (codeList[IP].__insName == "jmp")
+        {
+            return {IP + stoll(codeList[IP].__insArg)};
+        }
+        else if (codeList[IP].__insName == "jz")
+        {
+            return {IP + 1, IP + stoll(codeList[IP].__insArg)};
+        }
+        else if (codeList[IP].__insName == "ret" || codeList[IP].__insName == "tailcall")
+        {
+            return {};
+        }
+        else
+        {
+            return {IP + 1};
+        }
+    }
+
+
+    // Remove Instructions (As __applyEdit, but the kept instructions are moved, and nothing is built for no change)
+    bool __removeIns(vector<__Instruction> &codeList, const vector<bool> &removeList) const
+    {
+        if (std::find(removeList.begin(), removeList.end(), true) == removeList.end())
+        {
+            return false;
+        }
+
+        vector<int64_t> newIPList(codeList.size() + 1);
+        vector<__Instruction> newCodeList;
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            newIPList[IP] = newCodeList.size();
+
+            if (!removeList[IP])
+            {
+                newCodeList.push_back(std::move(codeList[IP]));
+            }
+        }
+
+        newIPList[codeList.size()] = newCodeList.size();
+
+        // Translate the jump offsets
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            if (removeList[IP])
+            {
+                continue;
+            }
+
+            if (auto &insObj = newCodeList[newIPList[IP]]; insObj.__insName == "jmp" || insObj.__insName == "jz")
+            {
+                insObj.__insArg = to_string(newIPList[IP + stoll(insObj.__insArg)] - newIPList[IP]);
+            }
+        }
+
+        codeList = std::move(newCodeList);
+
+        return true;
+    }
+
+
+    // Optimize: Remove Unreachable Code
+    bool __removeUnreachableCode(vector<__Instruction> &codeList) const
+    {
+        vector<bool> reachableList(codeList.size() + 1);
+        vector<size_t> IPStack {0};
+
+        while (!IPStack.empty())
+        {
+            size_t IP = IPStack.back();
+            IPStack.pop_back();
+
+            // Follow the code from IP, only the other targets of the "jz"s are saved
+            while (IP < codeList.size() && !reachableList[IP])
+            {
+                auto &insObj = codeList[IP];
+                reachableList[IP] = true;
+
+                if (insObj.__insName == "jmp")
+                {
+                    IP += stoll(insObj.__insArg);
+                }
+                else if (insObj.__insName == "jz")
+                {
+                    IPStack.push_back(IP + stoll(insObj.__insArg));
+                    IP++;
+                }
+                else if (insObj.__insName == "ret" || insObj.__insName == "tailcall")
+                {
+                    break;
+                }
+                else
+                {
+                    IP++;
+                }
+            }
+        }
+
+        vector<bool> removeList(codeList.size());
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            // A "jmp 1" is also useless
+            removeList[IP] = !reachableList[IP] || (codeList[IP].__insName == "jmp" && codeList[IP].__insArg == "1");
+        }
+
+        return __removeIns(codeList, removeList);
+    }
+
+
+    // Optimize: Remove Dead Code
+    bool __removeDeadCode(vector<__Instruction> &codeList) const
+    {
+        /*
+            Dead store: A local var store "push, ldc N, st, pop" is dead if no "ldc N, ld" can be reached before another
+            store to N. (A local scalar can only be read by "ld", since there is no pointer to a scalar in CMM)
+            The "ldc N" is kept for the AX, and removed as a dead AX write if it is unused.
+
+            Dead AX write: An instruction only writes AX is dead if the AX is overwritten before read on every path,
+            where a read by a dead one does not count. A "push" and its "pop" are dead if all the instructions between
+            them are dead.
+
+            A dead store makes the value stored dead, whose "ld"s may make another store dead, and so on. So both are
+            found by one backward scan of each block from (Is the AX live, The live vars) at its end, which the dead
+            instructions do not change, to a fixpoint over the blocks.
+        */
+        static const unordered_set<string> readSet {
+            "ld", "ald", "st", "ast", "push", "jz", "out", "sr", "call", "tailcall", "ret",
+            "add", "sub", "mul", "div", "lt", "le", "gt", "ge", "eq", "ne",
+            "spawn", "join", "aadd", "acas", "afill", "acopy", "asum", "amin", "adot",
+        };
+
+        static const unordered_set<string> writeSet {
+            "ldc", "ld", "ald", "lr", "in", "lea", "call",
+            "add", "sub", "mul", "div", "lt", "le", "gt", "ge", "eq", "ne",
+            "spawn", "join", "aadd", "acas", "afill", "acopy", "asum", "amin", "adot",
+        };
+
+        static const unordered_set<string> pureSet {
+            "ldc", "ld", "ald", "lr", "lea",
+            "add", "sub", "mul", "div", "lt", "le", "gt", "ge", "eq", "ne",
+        };
+
+        auto jmpTargetList = __getJumpTargetList(codeList);
+
+        // (Reads AX, Writes AX, Pure) of each instruction
+        vector<tuple<bool, bool, bool>> insTypeList;
+
+        for (auto &insObj: codeList)
+        {
+            auto &insName = insObj.__insName;
+            insTypeList.emplace_back(readSet.count(insName), writeSet.count(insName), pureSet.count(insName));
+        }
+
+        // Var number -> Bit index (Only the vars stored by "ldc N, st" may have a dead store)
+        unordered_map<string, size_t> bitIdxMap;
+
+        for (size_t IP = 1; IP < codeList.size(); IP++)
+        {
+            if (codeList[IP].__insName == "st" && codeList[IP - 1].__insName == "ldc")
+            {
+                bitIdxMap.emplace(codeList[IP - 1].__insArg, bitIdxMap.size());
+            }
+        }
+
+        size_t wordNum = (bitIdxMap.size() + 63) / 64;
+
+        // The var of each "ldc N, st" / "ldc N, ld" (-1 for none, -2 for a "ld" of an unknown var, which may read
+        // anything), and whether a "st" is the one of a "push, ldc N, st"
+        vector<int64_t> stBitIdxList(codeList.size(), -1), ldBitIdxList(codeList.size(), -1);
+        vector<bool> storeList(codeList.size());
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            auto &insName = codeList[IP].__insName;
+
+            if (insName != "st" && insName != "ld")
+            {
+                continue;
+            }
+
+            auto &bitIdxList = insName == "st" ? stBitIdxList : ldBitIdxList;
+
+            if (!IP || jmpTargetList[IP] || codeList[IP - 1].__insName != "ldc")
+            {
+                bitIdxList[IP] = insName == "st" ? -1 : -2;
+            }
+            else if (auto bitIter = bitIdxMap.find(codeList[IP - 1].__insArg); bitIter != bitIdxMap.end())
+            {
+                bitIdxList[IP] = bitIter->second;
+            }
+
+            storeList[IP] = stBitIdxList[IP] >= 0 && IP >= 2 && codeList[IP - 2].__insName == "push" &&
+                !jmpTargetList[IP - 1];
+        }
+
+        // Basic blocks: [blockStartList[B], blockStartList[B + 1])
+        vector<size_t> blockStartList, blockIdxList(codeList.size());
+
+        for (size_t IP = 0; IP < codeList.size(); IP++)
+        {
+            if (!IP || jmpTargetList[IP] || codeList[IP - 1].__insName == "jmp" || codeList[IP - 1].__insName == "jz" ||
+                codeList[IP - 1].__insName == "ret" || codeList[IP - 1].__insName == "tailcall")
+            {
+                blockStartList.push_back(IP);
+            }
+
+            blockIdxList[IP] = blockStartList.size() - 1;
+        }
+
+        size_t blockNum = blockStartList.size();
+        blockStartList.push_back(codeList.size());
+
+        vector<vector<size_t>> succBlockListList(blockNum);
+
+        for (size_t blockIdx = 0; blockIdx < blockNum; blockIdx++)
+        {
+            for (auto succIP: __getSuccList(codeList, blockStartList[blockIdx + 1] - 1))
+            {
+                if (succIP < codeList.size())
+                {
+                    succBlockListList[blockIdx].push_back(blockIdxList[succIP]);
+                }
+            }
+        }
+
+        vector<bool> removeList(codeList.size());
+
+        // The "pop"s after the IP not matched yet (IP, Are all the instructions after it so far dead)
+        vector<pair<size_t, bool>> popStack;
+
+        // Scan a block backward from the liveness at its end to the one at its start (The AX as liveSet[wordNum]),
+        // and mark the dead instructions if markBool
+        auto scanBlock = [&](size_t blockIdx, uint64_t *liveSet, bool markBool)
+        {
+            popStack.clear();
+
+            for (size_t IP = blockStartList[blockIdx + 1]; IP-- > blockStartList[blockIdx];)
+            {
+                auto [readBool, writeBool, pureBool] = insTypeList[IP];
+                auto &insName = codeList[IP].__insName;
+                bool deadBool = false;
+
+                if (insName == "pop")
+                {
+                    popStack.emplace_back(IP, true);
+
+                    continue;
+                }
+                else if (insName == "push" && !popStack.empty())
+                {
+                    auto [popIP, cleanBool] = popStack.back();
+                    popStack.pop_back();
+
+                    if (cleanBool)
+                    {
+                        if (markBool)
+                        {
+                            removeList[IP] = removeList[popIP] = true;
+                        }
+
+                        continue;
+                    }
+                }
+                else if (pureBool)
+                {
+                    deadBool = !liveSet[wordNum];
+                }
+                else if (storeList[IP])
+                {
+                    deadBool = !(liveSet[stBitIdxList[IP] / 64] >> (stBitIdxList[IP] % 64) & 1) && !popStack.empty() &&
+                        popStack.back().second;
+                }
+
+                if (deadBool)
+                {
+                    if (markBool)
+                    {
+                        removeList[IP] = true;
+                    }
+
+                    continue;
+                }
+
+                // A kept one
+                if (!popStack.empty())
+                {
+                    popStack.back().second = false;
+                }
+
+                if (stBitIdxList[IP] >= 0)
+                {
+                    liveSet[stBitIdxList[IP] / 64] &= ~(1ULL << (stBitIdxList[IP] % 64));
+                }
+                else if (ldBitIdxList[IP] >= 0)
+                {
+                    liveSet[ldBitIdxList[IP] / 64] |= 1ULL << (ldBitIdxList[IP] % 64);
+                }
+                else if (ldBitIdxList[IP] == -2)
+                {
+                    std::fill(liveSet, liveSet + wordNum, ~0ULL);
+                }
+
+                liveSet[wordNum] = readBool || (!writeBool && liveSet[wordNum]);
+            }
+        };
+
+        // The liveness at the start and the end of each block (wordNum + 1 words per block), to a fixpoint (The blocks
+        // backward at first, then only the predecessors of a changed one)
+        size_t stateSize = wordNum + 1;
+        vector<uint64_t> liveInList(blockNum * stateSize), liveOutList(blockNum * stateSize), liveSet(stateSize);
+        vector<vector<size_t>> predBlockListList(blockNum);
+        vector<size_t> blockStack(blockNum);
+        vector<bool> inStackList(blockNum, true);
+
+        for (size_t blockIdx = 0; blockIdx < blockNum; blockIdx++)
+        {
+            blockStack[blockIdx] = blockIdx;
+
+            for (auto succBlockIdx: succBlockListList[blockIdx])
+            {
+                predBlockListList[succBlockIdx].push_back(blockIdx);
+            }
+        }
+
+        while (!blockStack.empty())
+        {
+            size_t blockIdx = blockStack.back();
+            blockStack.pop_back();
+            inStackList[blockIdx] = false;
+
+            auto liveOutSet = &liveOutList[blockIdx * stateSize];
+
+            for (auto succBlockIdx: succBlockListList[blockIdx])
+            {
+                for (size_t wordIdx = 0; wordIdx < stateSize; wordIdx++)
+                {
+                    liveOutSet[wordIdx] |= liveInList[succBlockIdx * stateSize + wordIdx];
+                }
+            }
+
+            liveSet.assign(liveOutSet, liveOutSet + stateSize);
+            scanBlock(blockIdx, liveSet.data(), false);
+
+            if (!std::equal(liveSet.begin(), liveSet.end(), liveInList.begin() + blockIdx * stateSize))
+            {
+                std::copy(liveSet.begin(), liveSet.end(), liveInList.begin() + blockIdx * stateSize);
+
+                for (auto predBlockIdx: predBlockListList[blockIdx])
+                {
+                    if (!inStackList[predBlockIdx])
+                    {
+                        inStackList[predBlockIdx] = true;
+                        blockStack.push_back(predBlockIdx);
+                    }
+                }
+            }
+        }
+
+        for (size_t blockIdx = 0; blockIdx < blockNum; blockIdx++)
+        {
+            liveSet.assign(liveOutList.begin() + blockIdx * stateSize, liveOutList.begin() + (blockIdx + 1) * stateSize);
+            scanBlock(blockIdx, liveSet.data(), true);
+        }
+
+        // A "jmp" over the dead instructions only is a "jmp 1" now (From the last one, so a "jmp" over such a "jmp" is
+        // also found)
+        for (size_t IP = codeList.size(), nextIP = codeList.size(); IP-- > 0;)
+        {
+            if (!removeList[IP] && codeList[IP].__insName == "jmp" && stoll(codeList[IP].__insArg) > 0 &&
+                IP + stoll(codeList[IP].__insArg) <= nextIP)
+            {
+                removeList[IP] = true;
+            }
+
+            if (!removeList[IP])
+            {
+                nextIP = IP;
+            }
+        }
+
+        return __removeIns(codeList, removeList);
+    }
+
+
+    // Optimize: Dead Code Elimination
+    vector<__Instruction> __optimizeDCE(vector<__Instruction> codeList) const
+    {
+        // Removing the dead code never makes any code unreachable
+        __removeUnreachableCode(codeList);
+        __removeDeadCode(codeList);
+
+        return codeList;
+    }
+
+
+    // Get AST Sig (The lines are relative to the base line, so a function moved by an edit above it keeps its sig)
+    static void __getAstSig(__AST *root, size_t baseLine, string &sigStr)
+    {
+        if (!root)
+        {
+            sigStr += '~';
+            return;
+        }
+
+        sigStr += "(" + to_string((int)root->__tokenType) + " " + to_string(root->__tokenStr.size()) + ":" +
+            root->__tokenStr + "@" + to_string((int64_t)root->__lineNum - (int64_t)baseLine);
+
+        for (auto subPtr: root->__subList)
+        {
+            __getAstSig(subPtr, baseLine, sigStr);
+        }
+
+        sigStr += ')';
+    }
+
+
+    // Get Frame Sig (What a call of the function generates: Its vars and the sizes of its frame and inline region)
+    string __getFrameSig(const string &funcName) const
+    {
+        vector<pair<size_t, size_t>> infoList;
+
+        for (auto &[_, infoPair]: __symMap.at(funcName))
+        {
+            infoList.push_back(infoPair);
+        }
+
+        sort(infoList.begin(), infoList.end());
+
+        string sigStr = "[";
+
+        for (auto &[varIdx, varSize]: infoList)
+        {
+            sigStr += to_string(varIdx) + ":" + to_string(varSize) + " ";
+        }
+
+        return sigStr + to_string(__frameSizeMap.at(funcName)) + " " + to_string(__inlineSizeMap.at(funcName)) + "]";
+    }
+
+
+    // Get Func Sig (The subtree and the frame of the function, the frames of its callees, and the sigs of the inlined
+    // ones, which are never recursive)
+    void __getFuncSig(const string &funcName, size_t baseLine, string &sigStr) const
+    {
+        __getAstSig(__funcMap.at(funcName), baseLine, sigStr);
+
+        sigStr += __getFrameSig(funcName);
+
+        vector<string> calleeList(__callGraph.at(funcName).begin(), __callGraph.at(funcName).end());
+
+        sort(calleeList.begin(), calleeList.end());
+
+        for (auto &calleeName: calleeList)
+        {
+            sigStr += "\n" + calleeName + __getFrameSig(calleeName);
+
+            if (__inlineSet.count(calleeName))
+            {
+                sigStr += " inline ";
+                __getFuncSig(calleeName, baseLine, sigStr);
+            }
+        }
+    }
+
+
+    // Get Func Key (The code of a function only depends on its sig, the global var layout and the compile flags)
+    string __getFuncKey(const string &funcName)
+    {
+        if (__globalSigStr.empty())
+        {
+            vector<tuple<string, size_t, size_t>> globalList;
+
+            for (auto &[varName, infoPair]: __symMap.at("__GLOBAL__"))
+            {
+                globalList.emplace_back(varName, infoPair.first, infoPair.second);
+            }
+
+            sort(globalList.begin(), globalList.end());
+
+            __globalSigStr = "globals";
+
+            for (auto &[varName, varIdx, varSize]: globalList)
+            {
+                __globalSigStr += " " + varName + ":" + to_string(varIdx) + ":" + to_string(varSize);
+            }
+        }
+
+        string sigStr = __globalSigStr + "\n";
+
+        __getFuncSig(funcName, __funcMap.at(funcName)->__lineNum, sigStr);
+
+        return __Cache::__getKey(sigStr, __optLevel, __inlineBudget, __objectBool, __wordSize);
+    }
+
+
+    /*
+        To Func Code Str: A line per instruction, with its line relative to the base line (Empty for 0, the line of
+        the previous instruction):
+
+            Name [Arg]\tLine
+    */
+    static string __toFuncCodeStr(const vector<__Instruction> &codeList, size_t baseLine)
+    {
+        string codeStr;
+
+        for (auto &insObj: codeList)
+        {
+            codeStr += insObj.__toString() + "\t" +
+                (insObj.__lineNum ? to_string((int64_t)insObj.__lineNum - (int64_t)baseLine) : "") + "\n";
+        }
+
+        return codeStr;
+    }
+
+
+    // From Func Code Str
+    static vector<__Instruction> __fromFuncCodeStr(const string &codeStr, size_t baseLine)
+    {
+        vector<__Instruction> codeList;
+
+        for (size_t lineIdx = 0; lineIdx < codeStr.size();)
+        {
+            size_t tabIdx = codeStr.find('\t', lineIdx), endIdx = codeStr.find('\n', tabIdx);
+            size_t spaceIdx = std::min(codeStr.find(' ', lineIdx), tabIdx);
+
+            if (tabIdx == string::npos || endIdx == string::npos)
+            {
+                throw runtime_error("Invalid function code");
+            }
+
+            codeList.emplace_back(codeStr.substr(lineIdx, spaceIdx - lineIdx),
+                spaceIdx < tabIdx ? codeStr.substr(spaceIdx + 1, tabIdx - spaceIdx - 1) : "");
+
+            if (endIdx > tabIdx + 1)
+            {
+                codeList.back().__lineNum = baseLine + stoll(codeStr.substr(tabIdx + 1, endIdx - tabIdx - 1));
+            }
+
+            lineIdx = endIdx + 1;
+        }
+
+        return codeList;
+    }
+
+
+    // Generate Code: Function
+    void __genCodeFunction()
+    {
+        __codeMap["__GLOBAL__"] = __genCodeGlobal();
+
+        for (auto &funcName: __funcNameList)
+        {
+            /*
+                __TokenType::__FuncDecl
+                    |---- __Type
+                    |---- __TokenType::__Id
+                    |---- __ParamList | nullptr
+                    |---- __LocalDecl
+                    |---- __StmtList
+            */
+            // An unchanged function reuses its code after the passes of the last compile
+            if (__funcCachePtr)
+            {
+                string keyStr = __getFuncKey(funcName), codeStr;
+
+                if (__funcCachePtr->__load(keyStr, codeStr))
+                {
+                    __codeMap[funcName] = __fromFuncCodeStr(codeStr, __funcMap.at(funcName)->__lineNum);
+                    __reusedFuncSet.insert(funcName);
+
+                    continue;
+                }
+
+                __funcKeyMap[funcName] = keyStr;
+            }
+
+            __curFuncName = funcName;
+            auto codeList = __genCodeStmtList(__funcMap.at(funcName)->__subList[4]);
+
+            if (__curFuncName == "main")
+            {
+                // The "main" function is the last function, so "return" jumps to the end of code
+                for (size_t IP = 0; IP < codeList.size(); IP++)
+                {
+                    if (codeList[IP].__insName == "ret")
+                    {
+                        codeList[IP].__insName = "jmp";
+                        codeList[IP].__insArg  = to_string(codeList.size() - IP);
+                    }
+                }
+            }
+            else
+            {
+                /*
+                    The instruction "RET" perform multiple actions:
+
+                    1. IP = SS.POP()
+                        Now the SS is like:
+                        ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
+
+                    2. BP = SS.POP()
+                        Now the SS is like:
+                        ... Local5 Local4 Local3 Param2 Param1 Param0
+
+                    So we still need several "POP" to pop all vars. (See the function: __genCodeCall)
+                */
+                codeList.emplace_back("ret");
+            }
+
+            __setLineNum(codeList, __funcMap.at(funcName)->__lineNum);
+            __codeMap[funcName] = codeList;
+        }
+    }
+
+
+    // Remove Dead Function
+    void __removeDeadFunction()
+    {
+        // The inlined functions may be no longer called by anyone
+        unordered_set<string> reachableSet {"__GLOBAL__"};
+        vector<string> funcStack {"__GLOBAL__"};
+
+        while (!funcStack.empty())
+        {
+            string funcName = funcStack.back();
+            funcStack.pop_back();
+
+            for (auto &insObj: __codeMap.at(funcName))
+            {
+                if ((insObj.__insName == "call" || insObj.__insName == "tailcall" || insObj.__insName == "spawn") &&
+                    reachableSet.insert(insObj.__insArg).second)
+                {
+                    funcStack.push_back(insObj.__insArg);
+                }
+            }
+        }
+
+        for (auto codeIter = __codeMap.begin(); codeIter != __codeMap.end();)
+        {
+            codeIter = reachableSet.count(codeIter->first) ? next(codeIter) : __codeMap.erase(codeIter);
+        }
+    }
+
+
+    // Dump __codeMap
+    string __dumpCodeMap() const
+    {
+        string dumpStr;
+        vector<string> funcNameList {"__GLOBAL__"};
+
+        funcNameList.insert(funcNameList.end(), __funcNameList.begin(), __funcNameList.end());
+
+        for (auto &funcName: funcNameList)
+        {
+            if (__codeMap.count(funcName))
+            {
+                dumpStr += funcName + ":\n";
+
+                for (auto &insObj: __codeMap.at(funcName))
+                {
+                    dumpStr += "    " + insObj.__toString() + "\n";
+                }
+            }
+        }
+
+        return dumpStr;
+    }
+
+
+    // Dump __inlineSet
+    string __dumpInlineSet() const
+    {
+        string dumpStr;
+
+        for (auto &funcName: __funcNameList)
+        {
+            if (__inlineSet.count(funcName))
+            {
+                dumpStr += "inline " + funcName + "\n";
+            }
+        }
+
+        return dumpStr;
+    }
+
+
+    // Dump __irMap
+    string __dumpIRMap() const
+    {
+        string dumpStr;
+
+        for (auto &funcName: __funcNameList)
+        {
+            if (__irMap.count(funcName))
+            {
+                dumpStr += __irMap.at(funcName).__toString();
+            }
+        }
+
+        return dumpStr;
+    }
+
+
+    // Collect Mutable Global
+    void __collectMutableGlobal(__AST *root, const string &funcName)
+    {
+        if (!root)
+        {
+            return;
+        }
+
+        /*
+            __TokenType::__Expr
+                |---- __Var
+                        |---- __TokenType::__Id
+                |---- __Expr
+        */
+        if (root->__tokenType == __TokenType::__Expr && root->__subList.size() == 2 &&
+            root->__subList[0]->__subList.size() == 1)
+        {
+            string varName = root->__subList[0]->__subList[0]->__tokenStr;
+
+            if (!__symMap.at(funcName).count(varName) && __symMap.at("__GLOBAL__").at(varName).second)
+            {
+                __mutableGlobalSet.insert(varName);
+            }
+        }
+
+        for (auto subPtr: root->__subList)
+        {
+            __collectMutableGlobal(subPtr, funcName);
+        }
+    }
+
+
+    // IR: New Block
+    size_t __irNewBlock()
+    {
+        __irFuncPtr->__blockList.emplace_back();
+        __irDefList.emplace_back();
+        __irIncompleteList.emplace_back();
+        __irPredList.emplace_back();
+        __irSealedList.push_back(false);
+
+        return __irFuncPtr->__blockList.size() - 1;
+    }
+
+
+    // IR: Emit
+    int64_t __irEmit(const string &opName, const vector<int64_t> &argList = {}, const string &immStr = "")
+    {
+        int64_t valNum = opName == "store" || opName == "out" ? -1 : __irFuncPtr->__newVal();
+
+        __irFuncPtr->__blockList[__irBlockNum].__insList.emplace_back(opName, valNum, argList, immStr);
+        __irFuncPtr->__blockList[__irBlockNum].__insList.back().__lineNum = __irLineNum;
+
+        return valNum;
+    }
+
+
+    // IR: Emit Terminator
+    void __irEmitTerminator(const string &opName, const vector<int64_t> &argList = {},
+        const vector<size_t> &blockList = {})
+    {
+        __irFuncPtr->__blockList[__irBlockNum].__insList.emplace_back(opName, -1, argList, "", blockList);
+        __irFuncPtr->__blockList[__irBlockNum].__insList.back().__lineNum = __irLineNum;
+
+        for (auto succNum: blockList)
+        {
+            __irPredList[succNum].push_back(__irBlockNum);
+        }
+    }
+
+
+    // IR: Is Terminated
+    bool __irIsTerminated() const
+    {
+        auto &insList = __irFuncPtr->__blockList[__irBlockNum].__insList;
+
+        return !insList.empty() && insList.back().__isTerminator();
+    }
+
+
+    // IR: New Phi
+    int64_t __irNewPhi(size_t blockNum)
+    {
+        auto &insList = __irFuncPtr->__blockList[blockNum].__insList;
+        size_t phiNum = 0;
+
+        while (phiNum < insList.size() && insList[phiNum].__opName == "phi")
+        {
+            phiNum++;
+        }
+
+        int64_t valNum = __irFuncPtr->__newVal();
+
+        insList.insert(insList.begin() + phiNum, __IRInstruction("phi", valNum));
+
+        return valNum;
+    }
+
+
+    // IR: Write Var
+    void __irWriteVar(const string &varName, size_t blockNum, int64_t valNum)
+    {
+        __irDefList[blockNum][varName] = valNum;
+    }
+
+
+    // IR: Read Var
+    int64_t __irReadVar(const string &varName, size_t blockNum)
+    {
+        /*
+            Braun et al. "Simple and Efficient Construction of Static Single Assignment Form":
+            The value of a var is looked up in the preds recursively, a phi is placed when they meet.
+        */
+        if (__irDefList[blockNum].count(varName))
+        {
+            return __irDefList[blockNum].at(varName);
+        }
+
+        int64_t valNum;
+
+        if (!__irSealedList[blockNum])
+        {
+            // The preds are not all known yet
+            valNum = __irNewPhi(blockNum);
+            __irIncompleteList[blockNum][varName] = valNum;
+        }
+        else if (__irPredList[blockNum].size() == 1)
+        {
+            valNum = __irReadVar(varName, __irPredList[blockNum][0]);
+        }
+        else
+        {
+            // Break the cycles with the phi itself
+            valNum = __irNewPhi(blockNum);
+            __irWriteVar(varName, blockNum, valNum);
+            __irAddPhiOperand(varName, blockNum, valNum);
+        }
+
+        __irWriteVar(varName, blockNum, valNum);
+
+        return valNum;
+    }
+
+
+    // IR: Add Phi Operand
+    void __irAddPhiOperand(const string &varName, size_t blockNum, int64_t phiNum)
+    {
+        for (auto predNum: __irPredList[blockNum])
+        {
+            int64_t valNum = __irReadVar(varName, predNum);
+
+            for (auto &insObj: __irFuncPtr->__blockList[blockNum].__insList)
+            {
+                if (insObj.__valNum == phiNum)
+                {
+                    insObj.__argList.push_back(valNum);
+                    insObj.__blockList.push_back(predNum);
+                    break;
+                }
+            }
+        }
+    }
+
+
+    // IR: Seal Block (All the preds of the block are known)
+    void __irSealBlock(size_t blockNum)
+    {
+        for (auto &[varName, phiNum]: __irIncompleteList[blockNum])
+        {
+            __irAddPhiOperand(varName, blockNum, phiNum);
+        }
+
+        __irIncompleteList[blockNum].clear();
+        __irSealedList[blockNum] = true;
+    }
+
+
+    // IR: StmtList
+    void __irGenStmtList(__AST *root)
+    {
+        /*
+            __TokenType::__StmtList
+                |---- [__Stmt]
+                |...
+        */
+        for (auto stmtPtr: root->__subList)
+        {
+            __irGenStmt(stmtPtr);
+
+            // The statements after a "return" are unreachable
+            if (stmtPtr && stmtPtr->__tokenType == __TokenType::__ReturnStmt)
+            {
+                break;
+            }
+        }
+    }
+
+
+    // IR: Stmt
+    void __irGenStmt(__AST *root)
+    {
+        /*
+            __ExprStmt | __IfStmt | __WhileStmt | __ReturnStmt
+            __ExprStmt: __Expr | nullptr
+        */
+        if (!root)
+        {
+            return;
+        }
+
+        // The nested statements set their own lines
+        size_t outerLineNum = __irLineNum;
+        __irLineNum = root->__lineNum;
+
+        switch (root->__tokenType)
+        {
+            case __TokenType::__Expr:
+                __irGenExpr(root);
+                break;
+
+            case __TokenType::__IfStmt:
+                __irGenIfStmt(root);
+                break;
+
+            case __TokenType::__WhileStmt:
+                __irGenWhileStmt(root);
+                break;
+
+            case __TokenType::__ReturnStmt:
+                __irGenReturnStmt(root);
+                break;
+
+            default:
+                throw runtime_error("Invalid __TokenType");
+        }
+
+        __irLineNum = outerLineNum;
+    }
+
+
+    // IR: IfStmt
+    void __irGenIfStmt(__AST *root)
+    {
+        /*
+            __TokenType::__IfStmt
+                |---- __Expr
+                |---- __StmtList
+                |---- [__StmtList]
+
+            cur:  cbr %C, then, else (end)
+            then: ... br end
+            else: ... br end
+            end:  ...
+        */
+        int64_t condNum = __irGenExpr(root->__subList[0]);
+        size_t thenNum  = __irNewBlock();
+        size_t elseNum  = root->__subList.size() == 3 ? __irNewBlock() : 0;
+        size_t endNum   = __irNewBlock();
+
+        if (!elseNum)
+        {
+            elseNum = endNum;
+        }
+
+        __irEmitTerminator("cbr", {condNum}, {thenNum, elseNum});
+        __irSealBlock(thenNum);
+
+        __irBlockNum = thenNum;
+        __irGenStmtList(root->__subList[1]);
+
+        if (!__irIsTerminated())
+        {
+            __irEmitTerminator("br", {}, {endNum});
+        }
+
+        if (elseNum != endNum)
+        {
+            __irSealBlock(elseNum);
+
+            __irBlockNum = elseNum;
+            __irGenStmtList(root->__subList[2]);
+
+            if (!__irIsTerminated())
+            {
+                __irEmitTerminator("br", {}, {endNum});
+            }
+        }
+
+        __irSealBlock(endNum);
+        __irBlockNum = endNum;
+    }
+
+
+    // IR: WhileStmt
+    void __irGenWhileStmt(__AST *root)
+    {
+        /*
+            __TokenType::__WhileStmt
+                |---- __Expr
+                |---- __StmtList
+
+            cur:  br head
+            head: cbr %C, body, end
+            body: ... br head
+            end:  ...
+        */
+        size_t headNum = __irNewBlock();
+
+        __irEmitTerminator("br", {}, {headNum});
+        __irBlockNum = headNum;
+
+        int64_t condNum = __irGenExpr(root->__subList[0]);
+        size_t bodyNum  = __irNewBlock();
+        size_t endNum   = __irNewBlock();
+
+        __irEmitTerminator("cbr", {condNum}, {bodyNum, endNum});
+        __irSealBlock(bodyNum);
+        __irSealBlock(endNum);
+
+        __irBlockNum = bodyNum;
+        __irGenStmtList(root->__subList[1]);
+
+        if (!__irIsTerminated())
+        {
+            __irEmitTerminator("br", {}, {headNum});
+        }
+
+        // The back edge is known now
+        __irSealBlock(headNum);
+        __irBlockNum = endNum;
+    }
+
+
+    // IR: ReturnStmt
+    void __irGenReturnStmt(__AST *root)
+    {
+        /*
+            __TokenType::__ReturnStmt
+                |---- [__Expr]
+        */
+        if (root->__subList.empty())
+        {
+            __irEmitTerminator("ret");
+        }
+        else
+        {
+            __irEmitTerminator("ret", {__irGenExpr(root->__subList[0])});
+        }
+    }
+
+
+    // IR: Expr
+    int64_t __irGenExpr(__AST *root)
+    {
+        /*
+            __TokenType::__Expr
+                |---- __Var
+                |---- __Expr
+            ----------------------
+            __TokenType::__Expr
+                |---- __SimpleExpr
+        */
+        if (root->__subList.size() == 1)
+        {
+            return __irGenSimpleExpr(root->__subList[0]);
+        }
+
+        // The value is evaluated before the var (The same as the stack code)
+        int64_t valNum = __irGenExpr(root->__subList[1]);
+        auto varPtr    = root->__subList[0];
+        string varName = varPtr->__subList[0]->__tokenStr;
+
+        // Local scalar (Or a local array pointer)
+        if (__symMap.at(__curFuncName).count(varName) && varPtr->__subList.size() == 1)
+        {
+            __irWriteVar(varName, __irBlockNum, valNum);
+        }
+        // Global scalar
+        else if (varPtr->__subList.size() == 1)
+        {
+            __irEmit("store", {__irEmit("const", {}, to_string(__symMap.at("__GLOBAL__").at(varName).first)), valNum});
+        }
+        // Array element
+        else
+        {
+            int64_t baseNum  = __irGenArrayBase(varName);
+            int64_t indexNum = __irGenExpr(varPtr->__subList[1]);
+
+            __irEmit("store", {__irEmit("add", {baseNum, indexNum}), valNum});
+        }
+
+        return valNum;
+    }
+
+
+    // IR: Array Base
+    int64_t __irGenArrayBase(const string &varName)
+    {
+        // Local array or array param
+        if (__symMap.at(__curFuncName).count(varName))
+        {
+            return __irReadVar(varName, __irBlockNum);
+        }
+
+        auto [varIdx, varSize] = __symMap.at("__GLOBAL__").at(varName);
+
+        // A global array starts right after its pointer, unless the pointer is ever assigned
+        if (varSize && !__mutableGlobalSet.count(varName))
+        {
+            return __irEmit("const", {}, to_string(varIdx + 1));
+        }
+
+        return __irEmit("load", {__irEmit("const", {}, to_string(varIdx))});
+    }
+
+
+    // IR: Var
+    int64_t __irGenVar(__AST *root)
+    {
+        /*
+            __TokenType::__Var
+                |---- __TokenType::__Id
+                |---- [__Expr]
+        */
+        string varName = root->__subList[0]->__tokenStr;
+
+        if (root->__subList.size() == 2)
+        {
+            int64_t baseNum  = __irGenArrayBase(varName);
+            int64_t indexNum = __irGenExpr(root->__subList[1]);
+
+            return __irEmit("load", {__irEmit("add", {baseNum, indexNum})});
+        }
+
+        if (__symMap.at(__curFuncName).count(varName) || __symMap.at("__GLOBAL__").at(varName).second)
+        {
+            return __irGenArrayBase(varName);
+        }
+
+        return __irEmit("load", {__irEmit("const", {}, to_string(__symMap.at("__GLOBAL__").at(varName).first))});
+    }
+
+
+    // IR: SimpleExpr
+    int64_t __irGenSimpleExpr(__AST *root)
+    {
+        /*
+            __TokenType::__SimpleExpr
+                |---- __AddExpr
+                |---- [__RelOp]
+                |---- [__AddExpr]
+        */
+        int64_t valNum = __irGenAddExpr(root->__subList[0]);
+
+        if (root->__subList.size() == 3)
+        {
+            int64_t rhsNum = __irGenAddExpr(root->__subList[2]);
+
+            valNum = __irEmit(__genCodeRelOp(root->__subList[1])[0].__insName, {valNum, rhsNum});
+        }
+
+        return valNum;
+    }
+
+
+    // IR: AddExpr
+    int64_t __irGenAddExpr(__AST *root)
+    {
+        /*
+            __TokenType::__AddExpr
+                |---- __Term
+                |---- [__AddOp]
+                |---- [__Term]
+                |...
+        */
+        int64_t valNum = __irGenTerm(root->__subList[0]);
+
+        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+        {
+            int64_t rhsNum = __irGenTerm(root->__subList[idx + 1]);
+
+            valNum = __irEmit(__genCodeAddOp(root->__subList[idx])[0].__insName, {valNum, rhsNum});
+        }
+
+        return valNum;
+    }
+
+
+    // IR: Term
+    int64_t __irGenTerm(__AST *root)
+    {
+        /*
+            __TokenType::__Term
+                |---- __Factor
+                |---- [__MulOp]
+                |---- [__Factor]
+                |...
+        */
+        int64_t valNum = __irGenFactor(root->__subList[0]);
+
+        for (size_t idx = 1; idx < root->__subList.size(); idx += 2)
+        {
+            int64_t rhsNum = __irGenFactor(root->__subList[idx + 1]);
+
+            valNum = __irEmit(__genCodeMulOp(root->__subList[idx])[0].__insName, {valNum, rhsNum});
+        }
+
+        return valNum;
+    }
+
+
+    // IR: Factor
+    int64_t __irGenFactor(__AST *root)
+    {
+        /*
+            __Expr | __TokenType::__Number | __Call | __Var
+        */
+        switch (root->__tokenType)
+        {
+            case __TokenType::__Expr:
+                return __irGenExpr(root);
+
+            case __TokenType::__Number:
+                return __irEmit("const", {}, root->__tokenStr);
+
+            case __TokenType::__Call:
+                return __irGenCall(root);
+
+            case __TokenType::__Var:
+                return __irGenVar(root);
+
+            default:
+                throw runtime_error("Invalid __TokenType");
+        }
+    }
+
+
+    // IR: Call
+    int64_t __irGenCall(__AST *root)
+    {
+        /*
+            __TokenType::__Call
+                |---- __TokenType::__Id
+                |---- [__ArgList]
+        */
+        string funcName = root->__subList[0]->__tokenStr;
+
+        if (funcName == "input")
+        {
+            return __irEmit("in");
+        }
+        else if (funcName == "output")
+        {
+            // The value of "output(x)" is x
+            int64_t valNum = __irGenExpr(root->__subList[1]->__subList[0]);
+
+            __irEmit("out", {valNum});
+
+            return valNum;
+        }
+        else if (funcName == "join")
+        {
+            return __irEmit("join", {__irGenExpr(root->__subList[1]->__subList[0])});
+        }
+
+        // The args are evaluated from the last one (The same as the stack code)
+        size_t argNum = root->__subList.size() == 2 ? root->__subList[1]->__subList.size() : 0;
+        vector<int64_t> argList(argNum);
+
+        if (funcName == "spawn")
+        {
+            // The first arg is the function of the task
+            for (int64_t idx = (int64_t)argNum - 1; idx > 0; idx--)
+            {
+                argList[idx] = __irGenExpr(root->__subList[1]->__subList[idx]);
+            }
+
+            argList.erase(argList.begin());
+
+            return __irEmit("spawn", argList, __getSpawnFuncName(root));
+        }
+
+        for (int64_t idx = (int64_t)argNum - 1; idx >= 0; idx--)
+        {
+            argList[idx] = __irGenExpr(root->__subList[1]->__subList[idx]);
+        }
+
+        if (funcName == "atomicAdd" || funcName == "atomicCas")
+        {
+            // aadd / acas %Address, %Value / %Expect, [%Desire] (The address Array + Index is computed last)
+            argList[1] = __irEmit("add", {argList[0], argList[1]});
+            argList.erase(argList.begin());
+
+            return __irEmit(funcName == "atomicAdd" ? "aadd" : "acas", argList);
+        }
+
+        // afill / acopy / asum / amin / adot %Array, ... (The same operands as the stack code)
+        if (string insName = __getArrayInsName(funcName); !insName.empty())
+        {
+            return __irEmit(insName, argList);
+        }
+
+        return __irEmit("call", argList, funcName);
+    }
+
+
+    // IR: Function
+    void __irGenFunction(const string &funcName)
+    {
+        /*
+            __TokenType::__FuncDecl
+                |---- __Type
+                |---- __TokenType::__Id
+                |---- __ParamList | nullptr
+                |---- __LocalDecl
+                |---- __StmtList
+        */
+        auto funcPtr    = __funcMap.at(funcName);
+        size_t paramNum = funcPtr->__subList[2] ? funcPtr->__subList[2]->__subList.size() : 0;
+
+        __curFuncName = funcName;
+        __irMap[funcName] = __IRFunction(funcName, paramNum);
+        __irFuncPtr = &__irMap.at(funcName);
+        __irLineNum = funcPtr->__lineNum;
+        __irDefList.clear();
+        __irIncompleteList.clear();
+        __irPredList.clear();
+        __irSealedList.clear();
+
+        __irBlockNum = __irNewBlock();
+        __irSealBlock(__irBlockNum);
+
+        // The params are %0, %1, ..., the local scalars start from 0, the local arrays are their start addresses
+        vector<pair<size_t, string>> varList;
+
+        for (auto &[varName, infoPair]: __symMap.at(funcName))
+        {
+            varList.emplace_back(infoPair.first, varName);
+        }
+
+        sort(varList.begin(), varList.end());
+
+        for (auto &[varIdx, varName]: varList)
+        {
+            if (varIdx < paramNum)
+            {
+                __irWriteVar(varName, 0, __irEmit("param", {}, to_string(varIdx)));
+            }
+            else if (__symMap.at(funcName).at(varName).second)
+            {
+                __irWriteVar(varName, 0, __irEmit("laddr", {}, varName));
+            }
+            else
+            {
+                __irWriteVar(varName, 0, __irEmit("const", {}, "0"));
+            }
+        }
+
+        __irGenStmtList(funcPtr->__subList[4]);
+
+        if (!__irIsTerminated())
+        {
+            __irEmitTerminator("ret");
+        }
+
+        __IRPass::__removeTrivialPhi(*__irFuncPtr);
+    }
+
+
+    // IR: Construct __irMap
+    void __constructIRMap()
+    {
+        for (auto &funcName: __funcNameList)
+        {
+            __collectMutableGlobal(__funcMap.at(funcName)->__subList[4], funcName);
+        }
+
+        for (auto &funcName: __funcNameList)
+        {
+            __irGenFunction(funcName);
+        }
+    }
+
+
+    // Lower: Split Critical Edge
+    void __splitCriticalEdge(__IRFunction &funcObj) const
+    {
+        // The phi copies are placed at the end of the preds, so an edge to a block with phis must be the only succ
+        auto predList = funcObj.__getPredList();
+        size_t blockCount = funcObj.__blockList.size();
+
+        for (size_t blockNum = 0; blockNum < blockCount; blockNum++)
+        {
+            size_t succCount = funcObj.__blockList[blockNum].__getSuccList().size();
+
+            for (size_t idx = 0; idx < succCount && succCount > 1; idx++)
+            {
+                size_t succNum = funcObj.__blockList[blockNum].__getSuccList()[idx];
+                auto &succInsList = funcObj.__blockList[succNum].__insList;
+
+                if (predList[succNum].size() < 2 || succInsList[0].__opName != "phi")
+                {
+                    continue;
+                }
+
+                size_t newNum = funcObj.__blockList.size();
+
+                for (auto &insObj: succInsList)
+                {
+                    if (insObj.__opName == "phi")
+                    {
+                        *find(insObj.__blockList.begin(), insObj.__blockList.end(), blockNum) = newNum;
+                    }
+                }
+
+                funcObj.__blockList.emplace_back();
+                funcObj.__blockList[newNum].__insList.emplace_back("br", -1, vector<int64_t> {}, "",
+                    vector<size_t> {succNum});
+                funcObj.__blockList[blockNum].__getTerminator().__blockList[idx] = newNum;
+            }
+        }
+    }
+
+
+    // Lower: Get Layout List
+    vector<size_t> __getIRLayoutList(const __IRFunction &funcObj) const
+    {
+        /*
+            Depth first, the true succ first:
+            "cbr %C, bbT, bbF" is "jz bbF" and a "jmp bbT", which is removed if bbT is the next block.
+        */
+        vector<size_t> layoutList, blockStack {0};
+        vector<bool> visitedList(funcObj.__blockList.size());
+
+        while (!blockStack.empty())
+        {
+            size_t blockNum = blockStack.back();
+            blockStack.pop_back();
+
+            if (visitedList[blockNum])
+            {
+                continue;
+            }
+
+            visitedList[blockNum] = true;
+            layoutList.push_back(blockNum);
+
+            auto &succList = funcObj.__blockList[blockNum].__getSuccList();
+
+            blockStack.insert(blockStack.end(), succList.rbegin(), succList.rend());
+        }
+
+        return layoutList;
+    }
+
+
+    // Lower: Effect (0: Pure, 1: Read the memory, 2: Write the memory or IO)
+    static int __getIREffect(const __IRInstruction &insObj)
+    {
+        if (insObj.__opName == "load")
+        {
+            return 1;
+        }
+
+        if (insObj.__opName == "store" || insObj.__opName == "in" || insObj.__opName == "out" || insObj.__clobberMemory())
+        {
+            return 2;
+        }
+
+        return 0;
+    }
+
+
+    // Lower: Is Remat (Recomputed at every use)
+    static bool __isIRRemat(const __IRInstruction &insObj)
+    {
+        return insObj.__opName == "const" || insObj.__opName == "param" || insObj.__opName == "laddr";
+    }
+
+
+    // Lower: Get Tree Set
+    unordered_set<int64_t> __getIRTreeSet(const __IRFunction &funcObj) const
+    {
+        /*
+            A value used once by a later instruction of the same block is computed right inside its user,
+            like the stack code of an expression tree, if it can be moved there:
+
+                %3 = load %2                ldc 3
+                %4 = add %3, %1        =>   ald
+                store %0, %4                push
+                                            ...
+
+            The values waiting for their users are kept in a stack. A user takes its args from the top
+            (Skipping the pure ones), and a write or an IO forces the pending reads out of the stack.
+        */
+        auto useCountMap = funcObj.__getUseCount();
+        unordered_set<int64_t> treeSet;
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            unordered_set<int64_t> defSet, candSet;
+
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__opName == "phi")
+                {
+                    continue;
+                }
+
+                for (auto argNum: insObj.__argList)
+                {
+                    if (defSet.count(argNum) && useCountMap.at(argNum) == 1)
+                    {
+                        candSet.insert(argNum);
+                    }
+                }
+
+                if (insObj.__valNum >= 0 && !__isIRRemat(insObj))
+                {
+                    defSet.insert(insObj.__valNum);
+                }
+            }
+
+            // (Value number, Effect)
+            vector<pair<int64_t, int>> pendingList;
+
+            auto findPending = [&](int64_t valNum)
+            {
+                for (size_t idx = 0; idx < pendingList.size(); idx++)
+                {
+                    if (pendingList[idx].first == valNum)
+                    {
+                        return (int64_t)idx;
+                    }
+                }
+
+                return (int64_t)-1;
+            };
+
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__opName == "phi" || __isIRRemat(insObj))
+                {
+                    continue;
+                }
+
+                int insEffect = __getIREffect(insObj);
+                auto evalArgList = insObj.__getEvalArgList();
+
+                for (auto argIter = evalArgList.rbegin(); argIter != evalArgList.rend(); argIter++)
+                {
+                    int64_t pendingIdx = candSet.count(*argIter) ? findPending(*argIter) : -1;
+
+                    if (pendingIdx < 0)
+                    {
+                        continue;
+                    }
+
+                    bool topBool = true;
+
+                    for (size_t idx = pendingIdx + 1; idx < pendingList.size(); idx++)
+                    {
+                        if (pendingList[idx].second)
+                        {
+                            topBool = false;
+                        }
+                    }
+
+                    int argEffect = pendingList[pendingIdx].second;
+
+                    pendingList.erase(pendingList.begin() + pendingIdx);
+
+                    if (!topBool)
+                    {
+                        continue;
+                    }
+
+                    // The reads below a write can not be moved after it
+                    if (argEffect == 2)
+                    {
+                        for (size_t idx = 0; idx < (size_t)pendingIdx;)
+                        {
+                            if (pendingList[idx].second)
+                            {
+                                pendingList.erase(pendingList.begin() + idx);
+                                pendingIdx--;
+                            }
+                            else
+                            {
+                                idx++;
+                            }
+                        }
+                    }
+
+                    treeSet.insert(*argIter);
+                    insEffect = std::max(insEffect, argEffect);
+                }
+
+                // The pending reads and writes can not be moved after a write
+                if (__getIREffect(insObj) == 2)
+                {
+                    for (size_t idx = 0; idx < pendingList.size();)
+                    {
+                        pendingList[idx].second ? (void)pendingList.erase(pendingList.begin() + idx) : (void)idx++;
+                    }
+                }
+
+                // A pending write must be used by the next instruction
+                for (size_t idx = 0; idx < pendingList.size();)
+                {
+                    pendingList[idx].second == 2 ? (void)pendingList.erase(pendingList.begin() + idx) : (void)idx++;
+                }
+
+                if (candSet.count(insObj.__valNum))
+                {
+                    pendingList.emplace_back(insObj.__valNum, insEffect);
+                }
+            }
+        }
+
+        return treeSet;
+    }
+
+
+    // Lower: Get Leaf List (The materialized values read by an instruction)
+    void __getIRLeafList(const __IRInstruction &insObj, const unordered_map<int64_t, const __IRInstruction *> &defMap,
+        const unordered_set<int64_t> &treeSet, vector<int64_t> &leafList) const
+    {
+        if (insObj.__opName == "phi")
+        {
+            return;
+        }
+
+        for (auto argNum: insObj.__argList)
+        {
+            auto argPtr = defMap.at(argNum);
+
+            if (treeSet.count(argNum))
+            {
+                __getIRLeafList(*argPtr, defMap, treeSet, leafList);
+            }
+            else if (!__isIRRemat(*argPtr))
+            {
+                leafList.push_back(argNum);
+            }
+        }
+    }
+
+
+    // Lower: Allocate Slot
+    unordered_map<int64_t, size_t> __allocIRSlot(const __IRFunction &funcObj, const unordered_set<int64_t> &treeSet,
+        size_t &slotNum) const
+    {
+        /*
+            Every value which is neither computed inside its user nor recomputed at its uses gets an SS slot.
+            The values not live at the same time share a slot (Liveness + greedy graph coloring).
+            A phi is defined by the copies at the end of its preds, so it is live-in of its own block.
+        */
+        unordered_map<int64_t, const __IRInstruction *> defMap;
+        auto useCountMap = funcObj.__getUseCount();
+        vector<int64_t> slotValList;
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__valNum >= 0)
+                {
+                    defMap[insObj.__valNum] = &insObj;
+
+                    if (!__isIRRemat(insObj) && !treeSet.count(insObj.__valNum) &&
+                        (useCountMap.count(insObj.__valNum) || insObj.__opName == "phi"))
+                    {
+                        slotValList.push_back(insObj.__valNum);
+                    }
+                }
+            }
+        }
+
+        unordered_set<int64_t> slotValSet(slotValList.begin(), slotValList.end());
+
+        // (Block, Instruction index) -> The materialized values read by it
+        vector<vector<vector<int64_t>>> leafList(funcObj.__blockList.size());
+
+        for (size_t blockNum = 0; blockNum < funcObj.__blockList.size(); blockNum++)
+        {
+            for (auto &insObj: funcObj.__blockList[blockNum].__insList)
+            {
+                leafList[blockNum].emplace_back();
+
+                if (!treeSet.count(insObj.__valNum) && !__isIRRemat(insObj))
+                {
+                    __getIRLeafList(insObj, defMap, treeSet, leafList[blockNum].back());
+                }
+            }
+        }
+
+        vector<unordered_set<int64_t>> liveInList(funcObj.__blockList.size());
+        unordered_map<int64_t, unordered_set<int64_t>> edgeMap;
+
+        auto walkBlock = [&](size_t blockNum, bool edgeBool)
+        {
+            auto &blockObj = funcObj.__blockList[blockNum];
+            unordered_set<int64_t> liveSet;
+
+            auto defVal = [&](int64_t valNum)
+            {
+                if (edgeBool)
+                {
+                    for (auto liveNum: liveSet)
+                    {
+                        if (liveNum != valNum)
+                        {
+                            edgeMap[valNum].insert(liveNum);
+                            edgeMap[liveNum].insert(valNum);
+                        }
+                    }
+                }
+
+                liveSet.erase(valNum);
+            };
+
+            for (auto succNum: blockObj.__getSuccList())
+            {
+                liveSet.insert(liveInList[succNum].begin(), liveInList[succNum].end());
+            }
+
+            // The phi copies: Read all the sources, then write all the phis
+            for (auto succNum: blockObj.__getSuccList())
+            {
+                vector<int64_t> srcList;
+
+                for (auto &insObj: funcObj.__blockList[succNum].__insList)
+                {
+                    if (insObj.__opName == "phi")
+                    {
+                        defVal(insObj.__valNum);
+
+                        for (size_t idx = 0; idx < insObj.__blockList.size(); idx++)
+                        {
+                            if (insObj.__blockList[idx] == blockNum && slotValSet.count(insObj.__argList[idx]))
+                            {
+                                srcList.push_back(insObj.__argList[idx]);
+                            }
+                        }
+                    }
+                }
+
+                liveSet.insert(srcList.begin(), srcList.end());
+            }
+
+            for (int64_t insIdx = (int64_t)blockObj.__insList.size() - 1; insIdx >= 0; insIdx--)
+            {
+                auto &insObj = blockObj.__insList[insIdx];
+
+                if (insObj.__opName == "phi")
+                {
+                    liveSet.insert(insObj.__valNum);
+                    continue;
+                }
+
+                if (slotValSet.count(insObj.__valNum))
+                {
+                    defVal(insObj.__valNum);
+                }
+
+                liveSet.insert(leafList[blockNum][insIdx].begin(), leafList[blockNum][insIdx].end());
+            }
+
+            return liveSet;
+        };
+
+        for (bool changeBool = true; changeBool;)
+        {
+            changeBool = false;
+
+            for (int64_t blockNum = (int64_t)funcObj.__blockList.size() - 1; blockNum >= 0; blockNum--)
+            {
+                auto liveSet = walkBlock(blockNum, false);
+
+                if (liveSet.size() != liveInList[blockNum].size())
+                {
+                    liveInList[blockNum] = std::move(liveSet);
+                    changeBool = true;
+                }
+            }
+        }
+
+        for (size_t blockNum = 0; blockNum < funcObj.__blockList.size(); blockNum++)
+        {
+            walkBlock(blockNum, true);
+        }
+
+        /*
+            A phi and its sources share a slot if they are never live at the same time,
+            then the copy of the phi is omitted. (Value number -> Leader value number)
+        */
+        unordered_map<int64_t, int64_t> leaderMap;
+        unordered_map<int64_t, vector<int64_t>> groupMap;
+
+        for (auto valNum: slotValList)
+        {
+            leaderMap[valNum] = valNum;
+            groupMap[valNum]  = {valNum};
+        }
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__opName != "phi")
+                {
+                    continue;
+                }
+
+                for (auto srcNum: insObj.__argList)
+                {
+                    if (!slotValSet.count(srcNum))
+                    {
+                        continue;
+                    }
+
+                    int64_t phiLeader = leaderMap.at(insObj.__valNum), srcLeader = leaderMap.at(srcNum);
+                    bool edgeBool = phiLeader == srcLeader;
+
+                    for (auto memberNum: groupMap.at(srcLeader))
+                    {
+                        for (auto otherNum: groupMap.at(phiLeader))
+                        {
+                            if (edgeMap.count(memberNum) && edgeMap.at(memberNum).count(otherNum))
+                            {
+                                edgeBool = true;
+                            }
+                        }
+                    }
+
+                    if (edgeBool)
+                    {
+                        continue;
+                    }
+
+                    for (auto memberNum: groupMap.at(srcLeader))
+                    {
+                        leaderMap[memberNum] = phiLeader;
+                        groupMap.at(phiLeader).push_back(memberNum);
+                    }
+
+                    groupMap.erase(srcLeader);
+                }
+            }
+        }
+
+        // Greedy coloring of the groups in the order of the value numbers
+        unordered_map<int64_t, size_t> slotMap;
+
+        sort(slotValList.begin(), slotValList.end());
+        slotNum = 0;
+
+        for (auto valNum: slotValList)
+        {
+            if (slotMap.count(valNum))
+            {
+                continue;
+            }
+
+            unordered_set<size_t> usedSet;
+
+            for (auto memberNum: groupMap.at(leaderMap.at(valNum)))
+            {
+                if (edgeMap.count(memberNum))
+                {
+                    for (auto edgeNum: edgeMap.at(memberNum))
+                    {
+                        if (slotMap.count(edgeNum))
+                        {
+                            usedSet.insert(slotMap.at(edgeNum));
+                        }
+                    }
+                }
+            }
+
+            size_t slotIdx = 0;
+
+            while (usedSet.count(slotIdx))
+            {
+                slotIdx++;
+            }
+
+            for (auto memberNum: groupMap.at(leaderMap.at(valNum)))
+            {
+                slotMap[memberNum] = slotIdx;
+            }
+
+            slotNum = std::max(slotNum, slotIdx + 1);
+        }
+
+        return slotMap;
+    }
+
+
+    // Lower: Relayout Frame
+    void __relayoutFrame(const string &funcName, size_t paramNum, size_t slotNum)
+    {
+        /*
+            Param0, Param1, ..., Slot0, Slot1, ..., Array0 pointer, Array0 content, ...
+        */
+        unordered_map<string, pair<size_t, size_t>> symMap;
+        vector<pair<size_t, string>> arrayList;
+
+        for (auto &[varName, infoPair]: __symMap.at(funcName))
+        {
+            if (infoPair.first < paramNum)
+            {
+                symMap[varName] = infoPair;
+            }
+            else if (infoPair.second)
+            {
+                arrayList.emplace_back(infoPair.first, varName);
+            }
+        }
+
+        for (size_t slotIdx = 0; slotIdx < slotNum; slotIdx++)
+        {
+            symMap["%" + to_string(slotIdx)] = {paramNum + slotIdx, 0};
+        }
+
+        size_t varIdx = paramNum + slotNum;
+
+        sort(arrayList.begin(), arrayList.end());
+
+        for (auto &[_, varName]: arrayList)
+        {
+            symMap[varName] = {varIdx, __symMap.at(funcName).at(varName).second};
+            varIdx += symMap.at(varName).second + 1;
+        }
+
+        __symMap[funcName] = symMap;
+        __frameSizeMap[funcName] = varIdx;
+        __inlineSizeMap[funcName] = 0;
+    }
+
+
+    // Lower: Value (Compute a value into AX)
+    void __lowerValue(int64_t valNum, vector<__Instruction> &codeList) const
+    {
+        auto &insObj = *__irDefMap.at(valNum);
+
+        if (insObj.__opName == "const")
+        {
+            codeList.emplace_back("ldc", insObj.__immStr);
+        }
+        else if (insObj.__opName == "param")
+        {
+            codeList.emplace_back("ldc", insObj.__immStr);
+            codeList.emplace_back("ld");
+        }
+        else if (insObj.__opName == "laddr")
+        {
+            codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at(insObj.__immStr).first));
+            codeList.emplace_back("ld");
+        }
+        else if (__irTreeSet.count(valNum))
+        {
+            __lowerInstruction(insObj, codeList);
+        }
+        else
+        {
+            codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at("%" + to_string(__irSlotMap.at(valNum))).first));
+            codeList.emplace_back("ld");
+        }
+    }
+
+
+    // Lower: Instruction (Compute an instruction into AX)
+    void __lowerInstruction(const __IRInstruction &insObj, vector<__Instruction> &codeList) const
+    {
+        auto &opName  = insObj.__opName;
+        auto &argList = insObj.__argList;
+        size_t startIP = codeList.size();
+
+        if (__IR_BINOP_SET.count(opName))
+        {
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back("push");
+            __lowerValue(argList[1], codeList);
+            codeList.emplace_back(opName);
+            codeList.emplace_back("pop");
+        }
+        else if (opName == "load")
+        {
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back("ald");
+        }
+        else if (opName == "store")
+        {
+            // AX is the value after the "pop"
+            __lowerValue(argList[1], codeList);
+            codeList.emplace_back("push");
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back("ast");
+            codeList.emplace_back("pop");
+        }
+        else if (opName == "call")
+        {
+            auto frameCodeList = __genCodeFrame(insObj.__immStr, argList.size());
+
+            codeList.insert(codeList.end(), frameCodeList.begin(), frameCodeList.end());
+
+            for (auto argIter = argList.rbegin(); argIter != argList.rend(); argIter++)
+            {
+                __lowerValue(*argIter, codeList);
+                codeList.emplace_back("push");
+            }
+
+            codeList.emplace_back("call", insObj.__immStr);
+
+            for (size_t _ = 0; _ < __frameSizeMap.at(insObj.__immStr); _++)
+            {
+                codeList.emplace_back("pop");
+            }
+        }
+        else if (opName == "spawn")
+        {
+            // The same frame as a call (See the function: __genCodeSpawn)
+            auto frameCodeList = __genCodeFrame(insObj.__immStr, argList.size());
+
+            codeList.insert(codeList.end(), frameCodeList.begin(), frameCodeList.end());
+
+            for (auto argIter = argList.rbegin(); argIter != argList.rend(); argIter++)
+            {
+                __lowerValue(*argIter, codeList);
+                codeList.emplace_back("push");
+            }
+
+            codeList.emplace_back("ldc", to_string(__frameSizeMap.at(insObj.__immStr)));
+            codeList.emplace_back("spawn", insObj.__immStr);
+
+            for (size_t _ = 0; _ < __frameSizeMap.at(insObj.__immStr); _++)
+            {
+                codeList.emplace_back("pop");
+            }
+        }
+        else if (opName == "join")
+        {
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back("join");
+        }
+        else if (opName == "aadd" || opName == "acas" || __IR_ARRAY_OP_SET.count(opName))
+        {
+            // The operands are pushed from the last one, the first one is in AX (See the function: __genCodeAtomic)
+            for (size_t argIdx = argList.size() - 1; argIdx > 0; argIdx--)
+            {
+                __lowerValue(argList[argIdx], codeList);
+                codeList.emplace_back("push");
+            }
+
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back(opName);
+
+            for (size_t _ = 1; _ < argList.size(); _++)
+            {
+                codeList.emplace_back("pop");
+            }
+        }
+        else if (opName == "in")
+        {
+            codeList.emplace_back("in");
+        }
+        else if (opName == "out")
+        {
+            __lowerValue(argList[0], codeList);
+            codeList.emplace_back("out");
+        }
+        else
+        {
+            throw runtime_error("Invalid IR: " + insObj.__toString());
+        }
+
+        // A folded tree may come from several lines (The inlined calls, for example)
+        for (size_t IP = startIP; IP < codeList.size(); IP++)
+        {
+            if (!codeList[IP].__lineNum)
+            {
+                codeList[IP].__lineNum = insObj.__lineNum;
+            }
+        }
+    }
+
+
+    // Lower: Is Tail Call
+    bool __isIRTailCall(const __IRInstruction &retObj) const
+    {
+        if (__curFuncName == "main" || retObj.__argList.empty() || !__irTreeSet.count(retObj.__argList[0]))
+        {
+            return false;
+        }
+
+        auto &callObj = *__irDefMap.at(retObj.__argList[0]);
+
+        // The same conditions as the function: __getTailCall
+        return callObj.__opName == "call" &&
+            __frameSizeMap.at(callObj.__immStr) <= __frameSizeMap.at(__curFuncName) &&
+            !__hasLocalArray(callObj.__immStr) && !__hasLocalArray(__curFuncName);
+    }
+
+
+    // Lower: Function
+    vector<__Instruction> __lowerFunction(const __IRFunction &funcObj, const vector<size_t> &layoutList)
+    {
+        vector<__Instruction> codeList;
+
+        // Block number -> Start IP, and the jumps to be fixed: (IP, Block number (-1 for the end of code))
+        unordered_map<size_t, int64_t> blockIPMap;
+        vector<pair<size_t, int64_t>> jumpList;
+
+        __curFuncName = funcObj.__funcName;
+        __irDefMap.clear();
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__valNum >= 0)
+                {
+                    __irDefMap[insObj.__valNum] = &insObj;
+                }
+            }
+        }
+
+        for (auto blockNum: layoutList)
+        {
+            blockIPMap[blockNum] = codeList.size();
+
+            for (auto &insObj: funcObj.__blockList[blockNum].__insList)
+            {
+                if (insObj.__opName == "phi" || __isIRRemat(insObj) || __irTreeSet.count(insObj.__valNum))
+                {
+                    continue;
+                }
+
+                // The phi copies and the jumps get the line of the instruction
+                size_t startIP = codeList.size();
+
+                if (insObj.__opName == "br")
+                {
+                    // Parallel copy through SS: Push all the sources, then pop them into the phis
+                    size_t succNum = insObj.__blockList[0];
+                    vector<int64_t> phiList;
+
+                    for (auto &phiObj: funcObj.__blockList[succNum].__insList)
+                    {
+                        if (phiObj.__opName != "phi")
+                        {
+                            break;
+                        }
+
+                        int64_t srcNum = phiObj.__argList[find(phiObj.__blockList.begin(), phiObj.__blockList.end(),
+                            blockNum) - phiObj.__blockList.begin()];
+
+                        if (__irSlotMap.count(srcNum) && __irSlotMap.at(srcNum) == __irSlotMap.at(phiObj.__valNum))
+                        {
+                            continue;
+                        }
+
+                        __lowerValue(srcNum, codeList);
+                        codeList.emplace_back("push");
+                        phiList.push_back(phiObj.__valNum);
+                    }
+
+                    for (auto phiIter = phiList.rbegin(); phiIter != phiList.rend(); phiIter++)
+                    {
+                        codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at("%" +
+                            to_string(__irSlotMap.at(*phiIter))).first));
+                        codeList.emplace_back("st");
+                        codeList.emplace_back("pop");
+                    }
+
+                    jumpList.emplace_back(codeList.size(), succNum);
+                    codeList.emplace_back("jmp");
+                }
+                else if (insObj.__opName == "cbr")
+                {
+                    __lowerValue(insObj.__argList[0], codeList);
+                    jumpList.emplace_back(codeList.size(), insObj.__blockList[1]);
+                    codeList.emplace_back("jz");
+                    jumpList.emplace_back(codeList.size(), insObj.__blockList[0]);
+                    codeList.emplace_back("jmp");
+                }
+                else if (insObj.__opName == "ret" && __isIRTailCall(insObj))
+                {
+                    auto &callObj = *__irDefMap.at(insObj.__argList[0]);
+                    auto frameCodeList = __genCodeFrame(callObj.__immStr, callObj.__argList.size());
+
+                    codeList.insert(codeList.end(), frameCodeList.begin(), frameCodeList.end());
+
+                    for (auto argIter = callObj.__argList.rbegin(); argIter != callObj.__argList.rend(); argIter++)
+                    {
+                        __lowerValue(*argIter, codeList);
+                        codeList.emplace_back("push");
+                    }
+
+                    codeList.emplace_back("tailcall", callObj.__immStr);
+                }
+                else if (insObj.__opName == "ret")
+                {
+                    if (!insObj.__argList.empty())
+                    {
+                        __lowerValue(insObj.__argList[0], codeList);
+                    }
+
+                    // The "main" function is the last function, so "return" jumps to the end of code
+                    if (__curFuncName == "main")
+                    {
+                        jumpList.emplace_back(codeList.size(), -1);
+                        codeList.emplace_back("jmp");
+                    }
+                    else
+                    {
+                        codeList.emplace_back("ret");
+                    }
+                }
+                else
+                {
+                    __lowerInstruction(insObj, codeList);
+
+                    if (__irSlotMap.count(insObj.__valNum))
+                    {
+                        codeList.emplace_back("push");
+                        codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at("%" +
+                            to_string(__irSlotMap.at(insObj.__valNum))).first));
+                        codeList.emplace_back("st");
+                        codeList.emplace_back("pop");
+                    }
+                }
+
+                for (size_t IP = startIP; IP < codeList.size(); IP++)
+                {
+                    if (!codeList[IP].__lineNum)
+                    {
+                        codeList[IP].__lineNum = insObj.__lineNum;
+                    }
+                }
+            }
+        }
 
-        for (int64_t idx = (int64_t)root->__subList.size() - 1; idx >= 0; idx--)
+        for (auto &[IP, blockNum]: jumpList)
         {
-            auto exprCodeList = __genCodeExpr(root->__subList[idx]);
+            int64_t targetIP = blockNum < 0 ? codeList.size() : blockIPMap.at(blockNum);
 
-            codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
-            codeList.emplace_back("push");
+            codeList[IP].__insArg = to_string(targetIP - (int64_t)IP);
         }
 
         return codeList;
     }
 
 
-    // Generate Code: Assign
-    vector<__Instruction> __genCodeAssign(__AST *root) const
+    // Lower: Construct __codeMap
+    void __lowerIRMap()
     {
-        /*
-            __TokenType::__Expr
-                |---- __Var  -> Root
-                |---- __Expr -> AX
-        */
-        vector<__Instruction> codeList {{"push"}};
+        unordered_map<string, vector<size_t>> layoutMap;
+        unordered_map<string, unordered_set<int64_t>> treeSetMap;
+        unordered_map<string, unordered_map<int64_t, size_t>> slotMapMap;
 
-        // Local var
-        if (__symMap.at(__curFuncName).count(root->__subList[0]->__tokenStr))
+        // All the frames must be known before any call is generated
+        for (auto &[funcName, funcObj]: __irMap)
         {
-            codeList.emplace_back("ldc", to_string(__symMap.at(__curFuncName).at(root->__subList[0]->__tokenStr).first));
+            size_t slotNum;
 
-            // Scalar
-            if (root->__subList.size() == 1)
+            __splitCriticalEdge(funcObj);
+
+            layoutMap[funcName]  = __getIRLayoutList(funcObj);
+            treeSetMap[funcName] = __getIRTreeSet(funcObj);
+            slotMapMap[funcName] = __allocIRSlot(funcObj, treeSetMap.at(funcName), slotNum);
+
+            __relayoutFrame(funcName, funcObj.__paramNum, slotNum);
+        }
+
+        __codeMap["__GLOBAL__"] = __genCodeGlobal();
+
+        for (auto &[funcName, funcObj]: __irMap)
+        {
+            __irTreeSet = treeSetMap.at(funcName);
+            __irSlotMap = slotMapMap.at(funcName);
+
+            __codeMap[funcName] = __lowerFunction(funcObj, layoutMap.at(funcName));
+        }
+    }
+
+
+    // Construct __codeList
+    void __constructCodeList()
+    {
+        __PassManager passManager(__printAfterName, __timePassBool);
+
+        auto dumpCode   = [this]() { return __dumpCodeMap(); };
+        auto dumpInline = [this]() { return __dumpInlineSet(); };
+        auto dumpIR     = [this]() { return __dumpIRMap(); };
+
+        // For each function of __codeMap / __irMap
+        auto forEachCode = [this](auto passFunc)
+        {
+            return [this, passFunc]()
             {
-                codeList.emplace_back("st");
-            }
-            // Array
-            else
+                for (auto &[funcName, codeList]: __codeMap)
+                {
+                    if (funcName != "__GLOBAL__" && !__reusedFuncSet.count(funcName))
+                    {
+                        codeList = passFunc(codeList);
+                    }
+                }
+            };
+        };
+
+        auto forEachIR = [this](bool (*passFunc)(__IRFunction &))
+        {
+            return [this, passFunc]()
             {
-                auto exprCodeList = __genCodeExpr(root->__subList[1]);
+                for (auto &[_, funcObj]: __irMap)
+                {
+                    passFunc(funcObj);
+                }
+            };
+        };
 
-                // Get the (start) pointer (is already an absolute address)
-                codeList.emplace_back("ld");
-                codeList.emplace_back("push");
-                codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+        auto optimizeCSE = forEachCode([this](const vector<__Instruction> &codeList) { return __optimizeCSE(codeList); });
+        auto optimizeDCE = forEachCode([this](const vector<__Instruction> &codeList) { return __optimizeDCE(codeList); });
 
-                // Pointer[Index] (Pointer + Index)
-                codeList.emplace_back("add");
-                codeList.emplace_back("pop");
+        /*
+            -O0: AST -> Stack code
+            -O1: AST (Inline, Tail call) -> Stack code -> CSE -> DCE
+            -O2: AST -> SSA -> Inline -> Simplify CFG -> Const fold -> GVN -> DCE -> Stack code -> DCE
+        */
+        if (__optLevel == 0)
+        {
+            passManager.__addPass("codegen", [this]() { __genCodeFunction(); }, dumpCode);
+        }
+        else if (__optLevel == 1)
+        {
+            passManager.__addPass("inline",    [this]() { __constructInlineSet(); }, dumpInline);
+            passManager.__addPass("codegen",   [this]() { __genCodeFunction(); }, dumpCode);
+            passManager.__addPass("cse",       optimizeCSE, dumpCode);
+            passManager.__addPass("dce",       optimizeDCE, dumpCode);
 
-                // Save by absolute address
-                codeList.emplace_back("ast");
+            // All the functions of an object are exported
+            if (!__objectBool)
+            {
+                passManager.__addPass("globaldce", [this]() { __removeDeadFunction(); }, dumpCode);
             }
         }
-        // Global var
         else
         {
-            codeList.emplace_back("ldc", to_string(__symMap.at("__GLOBAL__").at(root->__subList[0]->__tokenStr).first));
+            passManager.__addPass("ssa", [this]() { __constructIRMap(); }, dumpIR);
 
-            // Scalar
-            if (root->__subList.size() == 1)
+            passManager.__addPass("inline", [this]()
             {
-                codeList.emplace_back("ast");
-            }
-            // Array
-            else
+                __constructInlineSet();
+                __IRPass::__inlineFunction(__irMap, __inlineSet, __inlineReportBool);
+            }, dumpIR);
+
+            passManager.__addPass("simplifycfg", forEachIR(__IRPass::__simplifyCFG),       dumpIR);
+            passManager.__addPass("constfold",   [this]()
             {
-                auto exprCodeList = __genCodeExpr(root->__subList[1]);
+                for (auto &[_, funcObj]: __irMap)
+                {
+                    __IRPass::__foldConst(funcObj, __wordSize);
+                }
+            }, dumpIR);
+            passManager.__addPass("gvn",         forEachIR(__IRPass::__numberValue),       dumpIR);
+            passManager.__addPass("ssa-dce",     forEachIR(__IRPass::__eliminateDeadCode), dumpIR);
+            passManager.__addPass("ssa-cfg",     forEachIR(__IRPass::__simplifyCFG),       dumpIR);
+            passManager.__addPass("lower",       [this]() { __lowerIRMap(); }, dumpCode);
+            passManager.__addPass("dce",         optimizeDCE, dumpCode);
+            passManager.__addPass("globaldce",   [this]() { __removeDeadFunction(); }, dumpCode);
+        }
 
-                // Absolute get the (start) pointer (is already an absolute address)
-                codeList.emplace_back("ald");
-                codeList.emplace_back("push");
-                codeList.insert(codeList.end(), exprCodeList.begin(), exprCodeList.end());
+        passManager();
 
-                // Pointer[Index] (Pointer + Index)
-                codeList.emplace_back("add");
-                codeList.emplace_back("pop");
+        __passTimeList = passManager.__timeList;
 
-                // Save by absolute address
-                codeList.emplace_back("ast");
+        if (__funcCachePtr)
+        {
+            for (auto &[funcName, keyStr]: __funcKeyMap)
+            {
+                if (__codeMap.count(funcName))
+                {
+                    __funcCachePtr->__store(keyStr, __toFuncCodeStr(__codeMap.at(funcName),
+                        __funcMap.at(funcName)->__lineNum));
+                }
             }
-        }
 
-        codeList.emplace_back("pop");
+            __funcCachePtr->__finish();
+        }
 
-        return codeList;
+        if (__objectBool)
+        {
+            __genCodeExport();
+        }
+        else
+        {
+            __layoutCode();
+        }
     }
 
 
-    // Generate Code: Global Var
-    vector<__Instruction> __genCodeGlobalVar() const
-    {
-        vector<__Instruction> codeList;
+    /*
+        Generate Code: Export
 
-        for (auto &[_, infoPair]: __symMap.at("__GLOBAL__"))
+        A caller in another object only knows the params of a function, so it pushes the params only (See
+        __constructCallGraph). A function with more words in its frame (The local vars and the inline region) is
+        exported by a wrapper "F$export", which calls it with the whole frame:
+
+            F$export:
+                (Push the local vars)
+                ldc P-1; ld; push
+                ...
+                ldc 0; ld; push
+                call F
+                pop (Frame size times)
+                ret
+    */
+    void __genCodeExport()
+    {
+        for (auto &funcName: __funcNameList)
         {
-            // Array
-            if (infoPair.second)
+            auto funcPtr = __funcMap.at(funcName);
+            size_t paramNum = funcPtr->__subList[2] ? funcPtr->__subList[2]->__subList.size() : 0;
+
+            if (funcName == "main" || __frameSizeMap.at(funcName) + __inlineSizeMap.at(funcName) == paramNum)
             {
-                // Calc the array start address (var number + 1)
-                codeList.emplace_back("ldc", to_string(infoPair.first + 1));
+                __exportMap[funcName] = {paramNum, funcName};
+                continue;
             }
 
-            // Push the array start address
-            // (Or only a meaningless int for global scalar memeory)
-            codeList.emplace_back("push");
+            auto codeList = __genCodeFrame(funcName, paramNum);
 
-            // Push array content (by array size times)
-            for (size_t _ = 0; _ < infoPair.second; _++)
+            for (size_t paramIdx = paramNum; paramIdx > 0; paramIdx--)
             {
+                codeList.emplace_back("ldc", to_string(paramIdx - 1));
+                codeList.emplace_back("ld");
                 codeList.emplace_back("push");
             }
-        }
 
-        return codeList;
+            codeList.emplace_back("call", funcName);
+
+            for (size_t _ = 0; _ < __frameSizeMap.at(funcName) + __inlineSizeMap.at(funcName); _++)
+            {
+                codeList.emplace_back("pop");
+            }
+
+            codeList.emplace_back("ret");
+
+            __setLineNum(codeList, funcPtr->__lineNum);
+            __codeMap[funcName + "$export"] = codeList;
+            __exportMap[funcName] = {paramNum, funcName + "$export"};
+        }
     }
 
 
-    // Generate Code: Begin
-    vector<__Instruction> __genCodeBegin() const
+    // Layout Code
+    void __layoutCode()
     {
-        // The "main" function is a special function, so the following code is similar with the function: __genCodeCall
-        vector<__Instruction> codeList;
-        vector<pair<string, pair<size_t, size_t>>> pairList(__symMap.at("main").size());
+        // Function name -> Function start IP
+        unordered_map<string, int64_t> funcJmpMap;
+
+        // Global code must be the first part
+        int64_t jmpNum = __codeMap.at("__GLOBAL__").size();
+
+        __codeList.insert(__codeList.end(), __codeMap.at("__GLOBAL__").begin(), __codeMap.at("__GLOBAL__").end());
+        __funcLayoutList.emplace_back("__GLOBAL__", 0);
 
-        // ..., Local2, Local1, Local0
-        for (auto &mapPair: __symMap.at("main"))
+        // Other functions
+        for (auto &funcName: __funcNameList)
         {
-            pairList[pairList.size() - mapPair.second.first - 1] = mapPair;
+            if (__codeMap.count(funcName) && funcName != "main")
+            {
+                __codeList.insert(__codeList.end(), __codeMap.at(funcName).begin(), __codeMap.at(funcName).end());
+                funcJmpMap[funcName] = jmpNum;
+                __funcLayoutList.emplace_back(funcName, jmpNum);
+                jmpNum += __codeMap.at(funcName).size();
+            }
         }
 
-        // The "main" function has definitely no params
-        for (auto &[_, infoPair]: pairList)
+        // The "main" function must be the last function
+        __codeList.insert(__codeList.end(), __codeMap.at("main").begin(), __codeMap.at("main").end());
+
+        funcJmpMap["main"] = jmpNum;
+        __funcLayoutList.emplace_back("main", jmpNum);
+
+        // A virtual "IP"
+        for (size_t IP = 0; IP < __codeList.size(); IP++)
         {
-            if (infoPair.second)
+            if (__codeList[IP].__insName == "call" || __codeList[IP].__insName == "tailcall" ||
+                __codeList[IP].__insName == "spawn")
             {
-                for (size_t _ = 0; _ < infoPair.second; _++)
-                {
-                    codeList.emplace_back("push");
-                }
-
-                codeList.emplace_back("lea", to_string(infoPair.second));
-                codeList.emplace_back("push");
+                __codeList[IP].__insArg = to_string(funcJmpMap.at(__codeList[IP].__insArg) - (int64_t)IP);
             }
-            else
+        }
+
+        // The instructions added by the passes (Such as "lr N") belong to the line of the previous one
+        for (size_t IP = 1; IP < __codeList.size(); IP++)
+        {
+            if (!__codeList[IP].__lineNum)
             {
-                codeList.emplace_back("push");
+                __codeList[IP].__lineNum = __codeList[IP - 1].__lineNum;
             }
         }
+    }
 
-        // Call the "main" function automatically
-        codeList.emplace_back("call", "main");
 
-        return codeList;
-    }
+    /*
+        Output Object (The object text to __asmStr, see __Linker)
 
+            .object cmm-obj/1
+            .file Path
+            .global Name Idx Size       (A global var defined by the object)
+            .extern Name                (A global var used but not defined)
+            .import Name ParamNum       (A function called but not defined)
+            .export Name ParamNum Func  (A function defined, called by the "Func" of the object)
+            .func Name InsNum           (Then the instructions: "Name [Arg]<Tab>[Line]")
 
-    // Generate Code: Global
-    vector<__Instruction> __genCodeGlobal() const
+        The call targets are function names and the global addresses are "@Name", both are resolved by the linker.
+    */
+    void __outputObject()
     {
-        auto codeList = __genCodeGlobalVar();
-        auto beginCodeList = __genCodeBegin();
+        __asmStr += ".object " + string(__OBJECT_VERSION) + "\n.file " + __inputFilePath + "\n";
 
-        codeList.insert(codeList.end(), beginCodeList.begin(), beginCodeList.end());
+        vector<tuple<size_t, string, size_t>> globalList;
 
-        return codeList;
-    }
+        for (auto &[varName, infoPair]: __symMap.at("__GLOBAL__"))
+        {
+            globalList.emplace_back(infoPair.first, varName, infoPair.second);
+        }
 
+        sort(globalList.begin(), globalList.end());
 
-    // Construct __codeList
-    void __constructCodeList()
-    {
-        unordered_map<string, vector<__Instruction>> codeMap
+        for (auto &[varIdx, varName, varSize]: globalList)
         {
-            {"__GLOBAL__", __genCodeGlobal()},
-        };
+            __asmStr += ".global " + varName + " " + to_string(varIdx) + " " + to_string(varSize) + "\n";
+        }
 
-        // Function name -> Function start IP
-        unordered_map<string, int64_t> funcJmpMap;
+        vector<string> externList(__externSet.begin(), __externSet.end());
+        vector<pair<string, size_t>> importList(__importMap.begin(), __importMap.end());
 
-        /*
-            __TokenType::__Program
-                |---- __Decl
-                |---- [__Decl]
-                |...
-        */
-        for (auto declPtr: __astRoot->__subList)
+        sort(externList.begin(), externList.end());
+        sort(importList.begin(), importList.end());
+
+        for (auto &varName: externList)
         {
-            /*
-                __VarDecl | __FuncDecl
-            */
-            if (declPtr->__tokenType == __TokenType::__FuncDecl)
-            {
-                /*
-                    __TokenType::__FuncDecl
-                        |---- __Type
-                        |---- __TokenType::__Id
-                        |---- __ParamList | nullptr
-                        |---- __LocalDecl
-                        |---- __StmtList
-                */
-                __curFuncName = declPtr->__subList[1]->__tokenStr;
-                auto codeList = __genCodeStmtList(declPtr->__subList[4]);
+            __asmStr += ".extern " + varName + "\n";
+        }
 
-                if (__curFuncName != "main")
-                {
-                    /*
-                        The instruction "RET" perform multiple actions:
+        for (auto &[funcName, paramNum]: importList)
+        {
+            __asmStr += ".import " + funcName + " " + to_string(paramNum) + "\n";
+        }
 
-                        1. IP = SS.POP()
-                            Now the SS is like:
-                            ... Local5 Local4 Local3 Param2 Param1 Param0 OldBP
+        vector<string> funcNameList {"__GLOBAL__"};
 
-                        2. BP = SS.POP()
-                            Now the SS is like:
-                            ... Local5 Local4 Local3 Param2 Param1 Param0
+        for (auto &funcName: __funcNameList)
+        {
+            auto &[paramNum, targetName] = __exportMap.at(funcName);
 
-                        So we still need several "POP" to pop all vars. (See the function: __genCodeCall)
-                    */
-                    codeList.emplace_back("ret");
-                }
+            __asmStr += ".export " + funcName + " " + to_string(paramNum) + " " + targetName + "\n";
+
+            funcNameList.push_back(funcName);
 
-                codeMap[__curFuncName] = codeList;
+            if (targetName != funcName)
+            {
+                funcNameList.push_back(targetName);
             }
         }
 
-        // Global code must be the first part
-        int64_t jmpNum = codeMap.at("__GLOBAL__").size();
+        for (auto &funcName: funcNameList)
+        {
+            if (__codeMap.count(funcName) && (funcName != "__GLOBAL__" || !__codeMap.at(funcName).empty()))
+            {
+                __asmStr += ".func " + funcName + " " + to_string(__codeMap.at(funcName).size()) + "\n" +
+                    __toFuncCodeStr(__codeMap.at(funcName), 0);
+            }
+        }
+    }
 
-        __codeList.insert(__codeList.end(), codeMap.at("__GLOBAL__").begin(), codeMap.at("__GLOBAL__").end());
 
-        // Other functions
-        for (auto &[funcName, subCodeList]: codeMap)
+    // Output Result (The asm text to __asmStr, then to the output file if there is one)
+    void __outputResult()
+    {
+        if (__objectBool)
+        {
+            __outputObject();
+        }
+        else
         {
-            if (funcName != "__GLOBAL__" && funcName != "main")
+            for (auto insObj: __codeList)
             {
-                __codeList.insert(__codeList.end(), subCodeList.begin(), subCodeList.end());
-                funcJmpMap[funcName] = jmpNum;
-                jmpNum += subCodeList.size();
+                __asmStr += insObj.__toString() + "\n";
             }
-        }
 
-        // The "main" function must be the last function
-        __codeList.insert(__codeList.end(), codeMap.at("main").begin(), codeMap.at("main").end());
+            // Directives (Not instructions): ".func Name IP" is the start IP of a function
+            for (auto &[funcName, funcIP]: __funcLayoutList)
+            {
+                __asmStr += ".func " + funcName + " " + to_string(funcIP) + "\n";
+            }
 
-        funcJmpMap["main"] = jmpNum;
+            // ".globals N": The SS words [0, N) of the global vars, which are shared by the tasks of spawn
+            size_t globalNum = 0;
 
-        // A virtual "IP"
-        for (size_t IP = 0; IP < __codeList.size(); IP++)
-        {
-            if (__codeList[IP].__insName == "call")
+            for (auto &[_, infoPair]: __symMap.at("__GLOBAL__"))
             {
-                __codeList[IP].__insArg = to_string(funcJmpMap.at(__codeList[IP].__insArg) - (int64_t)IP);
+                globalNum += infoPair.second + 1;
+            }
+
+            __asmStr += ".globals " + to_string(globalNum) + "\n";
+
+            // ".word N": The consts of -O2 are folded in the N-bit word, so the asm only runs on a VM of it
+            if (__optLevel >= 2)
+            {
+                __asmStr += ".word " + to_string(__wordSize) + "\n";
+            }
+
+            // The line table: ".file Path" is the source file, ".line IP Line" is the line from the IP to the next one
+            __asmStr += ".file " + __inputFilePath + "\n";
+
+            for (size_t IP = 0, lineNum = 0; IP < __codeList.size(); IP++)
+            {
+                if (__codeList[IP].__lineNum != lineNum)
+                {
+                    lineNum = __codeList[IP].__lineNum;
+                    __asmStr += ".line " + to_string(IP) + " " + to_string(lineNum) + "\n";
+                }
             }
         }
-    }
 
+        if (__outputFilePath.empty())
+        {
+            return;
+        }
 
-    // Output Result
-    void __outputResult() const
-    {
         FILE *fdOut = fopen(__outputFilePath.c_str(), "w");
 
         if (!fdOut)
@@ -2388,15 +6166,37 @@ private:
             throw runtime_error("Invalid " + __outputFilePath);
         }
 
-        for (auto insObj: __codeList)
-        {
-            fprintf(fdOut, "%s\n", insObj.__toString().c_str());
-        }
-
+        fwrite(__asmStr.data(), 1, __asmStr.size(), fdOut);
         fclose(fdOut);
     }
 
 
+    // Run Phase
+    void __runPhase(const string &phaseName, const function<void()> &phaseFunc)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        phaseFunc();
+
+        __phaseTimeList.emplace_back(phaseName,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+    }
+
+
+    // Run Phase List
+    void __runPhaseList()
+    {
+        __runPhase("__constructTokenList", [this]() { __constructTokenList(); });
+        __runPhase("__constructAst",       [this]() { __constructAst(); });
+        __runPhase("__constructSymMap",    [this]() { __constructSymMap(); });
+        __runPhase("__constructCallGraph", [this]() { __constructCallGraph(); });
+        __runPhase("__constructCodeList",  [this]() { __constructCodeList(); });
+        __runPhase("__outputResult",       [this]() { __outputResult(); });
+
+        __astNodeNum = __countAstNode(__astRoot);
+    }
+
+
     // Main
     void __main()
     {
@@ -2405,11 +6205,7 @@ private:
             return;
         }
 
-        __constructTokenList();
-        __constructAst();
-        __constructSymMap();
-        __constructCodeList();
-        __outputResult();
+        __runPhaseList();
     }
 };
 
@@ -0,0 +1,233 @@
+/*
+    Context.hpp
+    ===========
+        Class template __Context implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include "IO.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::mutex;
+using std::lock_guard;
+using std::atomic;
+using std::runtime_error;
+
+
+template <typename WordT>
+class __TaskGroup;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __WordAllocator (The new words of a resize are left uninitialized)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    The SS of a task starts with the words below its frame, which are never accessed, so they are not even touched.
+*/
+template <typename WordT>
+struct __WordAllocator: std::allocator<WordT>
+{
+    template <typename OtherT>
+    struct rebind
+    {
+        using other = __WordAllocator<OtherT>;
+    };
+
+
+    // Constructor
+    __WordAllocator() = default;
+
+
+    // Constructor (Rebind)
+    template <typename OtherT>
+    __WordAllocator(const __WordAllocator<OtherT> &) {}
+
+
+    // Construct (A default one is left uninitialized)
+    template <typename ObjT, typename... ArgTypes>
+    void construct(ObjT *objPtr, ArgTypes &&... argList)
+    {
+        if constexpr (sizeof...(ArgTypes) == 0)
+        {
+            ::new ((void *)objPtr) ObjT;
+        }
+        else
+        {
+            ::new ((void *)objPtr) ObjT(std::forward<ArgTypes>(argList)...);
+        }
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __Context (All the state of a running program, so a VM can run many of them by slices)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename WordT>
+class __Context
+{
+    // Friend
+    template <typename, typename, typename, typename>
+    friend class __VM;
+
+    template <typename VMType>
+    friend class __Batch;
+
+    template <typename VMType, size_t LaneNum>
+    friend class __LaneVM;
+
+    template <typename VMType>
+    friend class __Server;
+
+    template <typename VMType>
+    friend class __Scheduler;
+
+    template <typename VMType>
+    friend class __Stream;
+
+    template <typename>
+    friend class __TaskGroup;
+
+
+public:
+
+    // Constructor (An empty path means stdin / stdout)
+    explicit __Context(const string &ioInputFilePath = "", const string &ioOutputFilePath = "",
+        bool ioBinaryBool = false, size_t ioBufferSize = __IO::__BUFFER_SIZE):
+        __io(ioInputFilePath, ioOutputFilePath, ioBinaryBool, ioBufferSize) {}
+
+
+private:
+
+    // Attribute
+    size_t __IP = 0;
+    vector<WordT, __WordAllocator<WordT>> __SS;
+    WordT __AX = 0;
+    WordT __BP = 0;
+    vector<WordT> __RS;
+    __IO __io;
+
+    // The instructions it may still execute (UINT64_MAX for unlimited)
+    uint64_t __fuel = UINT64_MAX;
+
+    // The record index of a batch, or the instance id of a stream
+    size_t __id = 0;
+
+    // The task group of a program calling spawn (nullptr in a batch or a stream)
+    __TaskGroup<WordT> *__groupPtr = nullptr;
+
+    // The addresses below __baseIdx (The frame of a task) are the shared global vars of the group, if below __globalNum
+    WordT *__globalPtr = nullptr;
+    size_t __globalNum = 0;
+    size_t __baseIdx = 0;
+
+    // The task spawned by the last slice (Pushed by the scheduler), and the task its "join" waits for (Parked on it)
+    __Context *__spawnPtr = nullptr;
+    __Context *__joinPtr = nullptr;
+
+    // The end of a task (Failed with __errorBool), and the contexts parked on its "join"
+    mutex __taskMutex;
+    atomic<bool> __finishBool {false};
+    bool __errorBool = false;
+    vector<__Context *> __joinerList;
+
+
+    // Reset (A new run of a code)
+    void __reset(size_t RSSize, uint64_t fuel)
+    {
+        __IP = 0;
+        __SS.clear();
+        __AX = 0;
+        __BP = 0;
+        __RS.assign(RSSize, 0);
+        __fuel = fuel;
+        __spawnPtr = nullptr;
+        __joinPtr = nullptr;
+        __finishBool = false;
+        __errorBool = false;
+    }
+
+
+    // Get Shared (The word of an address below the frame of a task)
+    WordT *__getShared(WordT addrIdx) const
+    {
+        if ((size_t)addrIdx >= __globalNum)
+        {
+            throw runtime_error("Invalid access to the stack of another task");
+        }
+
+        return __globalPtr + addrIdx;
+    }
+
+
+    // Park Joiner (ctxPtr waits for this task in its "join", false if the task is finished already)
+    bool __parkJoiner(__Context *ctxPtr)
+    {
+        lock_guard<mutex> taskLock(__taskMutex);
+
+        if (__finishBool)
+        {
+            return false;
+        }
+
+        __joinerList.push_back(ctxPtr);
+
+        return true;
+    }
+
+
+    // Finish Task (The contexts to wake, the SS of a task is freed, only its AX is used after this)
+    vector<__Context *> __finishTask(bool errorBool)
+    {
+        lock_guard<mutex> taskLock(__taskMutex);
+
+        if (__groupPtr)
+        {
+            decltype(__SS)().swap(__SS);
+        }
+
+        vector<__Context *> joinerList;
+
+        joinerList.swap(__joinerList);
+
+        __errorBool  = errorBool;
+        __finishBool = true;
+
+        return joinerList;
+    }
+
+
+    // Flush (The buffered output, the tasks share the output of the main context)
+    void __flush()
+    {
+        if (__groupPtr)
+        {
+            __groupPtr->__flush();
+        }
+        else
+        {
+            __io.__flush();
+        }
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,507 @@
+/*
+    IO.hpp
+    ======
+        Class __IO implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
+#include <cerrno>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::mutex;
+using std::lock_guard;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __IO
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __IO
+{
+    // Friend
+    template <typename WordT, typename BoundsPolicy, typename TracePolicy, typename ProfilePolicy>
+    friend class __VM;
+
+    template <typename WordT>
+    friend class __Context;
+
+    template <typename VMType, size_t LaneNum>
+    friend class __LaneVM;
+
+    template <typename VMType>
+    friend class __Scheduler;
+
+    template <typename VMType>
+    friend class __Stream;
+
+    template <typename WordT>
+    friend class __TaskGroup;
+
+
+public:
+
+    // Constructor (An empty path means stdin / stdout, the buffers may be smaller for the many batch contexts)
+    explicit __IO(const string &inputFilePath = "", const string &outputFilePath = "", bool binaryBool = false,
+        size_t bufferSize = __BUFFER_SIZE):
+        __inputFilePath (inputFilePath),
+        __outputFilePath(outputFilePath),
+        __binaryBool    (binaryBool),
+        __outputBuffer  (bufferSize) {}
+
+
+    // Destructor
+    ~__IO()
+    {
+        try
+        {
+            __flush();
+        }
+        catch (const runtime_error &)
+        {
+        }
+
+        if (__mapPtr)
+        {
+            munmap(__mapPtr, __inputSize);
+        }
+
+        if (__inputFd > STDERR_FILENO)
+        {
+            close(__inputFd);
+        }
+
+        if (__outputFd > STDERR_FILENO)
+        {
+            close(__outputFd);
+        }
+    }
+
+
+private:
+
+    // Buffer Size
+    static constexpr size_t __BUFFER_SIZE = 1 << 20;
+
+
+    // Attribute
+    string __inputFilePath;
+    string __outputFilePath;
+    bool __binaryBool;
+    int __inputFd = STDIN_FILENO;
+    int __outputFd = STDOUT_FILENO;
+    void *__mapPtr = nullptr;
+    vector<char> __inputBuffer;
+    vector<char> __outputBuffer;
+
+    // The output text of a batch record is appended to it instead of being written to __outputFd
+    string *__outputStrPtr = nullptr;
+
+    // Either __inputBuffer, the whole mapped input file or the text of a batch record
+    const char *__inputPtr = nullptr;
+    size_t __inputIdx = 0;
+    size_t __inputSize = 0;
+    size_t __outputSize = 0;
+
+    /*
+        The input of a stream context: Pushed by the host thread to __pendingStr (Under __streamMutex), and taken by the
+        VM thread when __streamInputStr is used up. A read with no pending input sets __waitBool, then the context is
+        parked (__parkBool) until the next push.
+    */
+    bool __streamBool = false;
+    mutex __streamMutex;
+    string __pendingStr;
+    string __streamInputStr;
+    bool __closeBool = false;
+    bool __parkBool = false;
+    bool __waitBool = false;
+
+
+    // Open
+    void __open()
+    {
+        if (!__inputFilePath.empty() && (__inputFd = open(__inputFilePath.c_str(), O_RDONLY)) < 0)
+        {
+            throw runtime_error("Invalid " + __inputFilePath);
+        }
+
+        if (!__outputFilePath.empty() &&
+            (__outputFd = open(__outputFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+        {
+            throw runtime_error("Invalid " + __outputFilePath);
+        }
+
+        // A regular file (Including a redirected stdin) is mapped as a whole, other ones are read into the buffer
+        struct stat statObj;
+
+        if (!fstat(__inputFd, &statObj) && S_ISREG(statObj.st_mode) && statObj.st_size > 0 &&
+            !lseek(__inputFd, 0, SEEK_CUR) &&
+            (__mapPtr = mmap(nullptr, statObj.st_size, PROT_READ, MAP_PRIVATE, __inputFd, 0)) != MAP_FAILED)
+        {
+            madvise(__mapPtr, statObj.st_size, MADV_SEQUENTIAL);
+
+            __inputPtr  = (const char *)__mapPtr;
+            __inputSize = statObj.st_size;
+        }
+        else
+        {
+            __mapPtr = nullptr;
+            __inputBuffer.resize(__outputBuffer.size());
+            __inputPtr = __inputBuffer.data();
+        }
+    }
+
+
+    // Open Memory (A batch record)
+    void __openMemory(const char *inputPtr, size_t inputSize, string *outputStrPtr)
+    {
+        __inputPtr     = inputPtr;
+        __inputIdx     = 0;
+        __inputSize    = inputSize;
+        __outputSize   = 0;
+        __outputStrPtr = outputStrPtr;
+        __streamBool   = false;
+    }
+
+
+    // Open Stream (A stream context: The input is pushed by __pushInput, the output text is appended to outputStrPtr)
+    void __openStream(string *outputStrPtr)
+    {
+        lock_guard<mutex> streamLock(__streamMutex);
+
+        __pendingStr.clear();
+        __streamInputStr.clear();
+        __closeBool = false;
+        __parkBool  = false;
+        __waitBool  = false;
+
+        __inputPtr     = __streamInputStr.data();
+        __inputIdx     = 0;
+        __inputSize    = 0;
+        __outputSize   = 0;
+        __outputStrPtr = outputStrPtr;
+        __streamBool   = true;
+    }
+
+
+    // Push Input (Whole ints only, closeBool for the end of the input, true if the context was parked)
+    bool __pushInput(const char *inputPtr, size_t inputSize, bool closeBool)
+    {
+        lock_guard<mutex> streamLock(__streamMutex);
+
+        __pendingStr.append(inputPtr, inputSize);
+        __closeBool = __closeBool || closeBool;
+
+        bool parkBool = __parkBool;
+        __parkBool = false;
+
+        return parkBool;
+    }
+
+
+    // Park (After a read waits, true if there is still no input, then the next __pushInput wakes it)
+    bool __park()
+    {
+        lock_guard<mutex> streamLock(__streamMutex);
+
+        __waitBool = false;
+        __parkBool = __pendingStr.empty() && !__closeBool;
+
+        return __parkBool;
+    }
+
+
+    // Is Output Full (A stream context yields at an "out", so the host takes the output before the buffer is flushed)
+    bool __isOutputFull() const
+    {
+        return __streamBool && __outputSize + 21 > __outputBuffer.size();
+    }
+
+
+    // Get Digit Pair Table ("00", "01", ..., "99")
+    static const char *__getDigitPairTable()
+    {
+        static const auto digitPairTable = []()
+        {
+            vector<char> digitPairTable(200);
+
+            for (int idx = 0; idx < 100; idx++)
+            {
+                digitPairTable[idx * 2]     = '0' + idx / 10;
+                digitPairTable[idx * 2 + 1] = '0' + idx % 10;
+            }
+
+            return digitPairTable;
+        }();
+
+        return digitPairTable.data();
+    }
+
+
+    // Fill Input
+    bool __fillInput()
+    {
+        if (__streamBool)
+        {
+            return __fillStreamInput();
+        }
+
+        // The mapped input file or the batch record has no more data
+        if (__mapPtr || __outputStrPtr)
+        {
+            return false;
+        }
+
+        // The pending output may be a prompt the other side is waiting for
+        __flush();
+
+        ssize_t readSize;
+
+        while ((readSize = read(__inputFd, __inputBuffer.data(), __inputBuffer.size())) < 0 && errno == EINTR);
+
+        if (readSize < 0)
+        {
+            throw runtime_error("Invalid input");
+        }
+
+        __inputIdx  = 0;
+        __inputSize = readSize;
+
+        return readSize > 0;
+    }
+
+
+    // Fill Stream Input (The pending input, or wait for it if the input is not closed)
+    bool __fillStreamInput()
+    {
+        lock_guard<mutex> streamLock(__streamMutex);
+
+        if (__pendingStr.empty())
+        {
+            __waitBool = !__closeBool;
+
+            return false;
+        }
+
+        __streamInputStr.swap(__pendingStr);
+        __pendingStr.clear();
+
+        __inputPtr  = __streamInputStr.data();
+        __inputIdx  = 0;
+        __inputSize = __streamInputStr.size();
+
+        return true;
+    }
+
+
+    // Read Int (IntT is the VM word: int32_t or int64_t)
+    template <typename IntT>
+    bool __readInt(IntT &intVal)
+    {
+        return __binaryBool ? __readBinaryInt(intVal) : __readTextInt(intVal);
+    }
+
+
+    // Write Int
+    template <typename IntT>
+    void __writeInt(IntT intVal)
+    {
+        __binaryBool ? __writeBinaryInt(intVal) : __writeTextInt(intVal);
+    }
+
+
+    // Read Binary Int (Little-endian, the value is unchanged if there are less than sizeof(IntT) bytes)
+    template <typename IntT>
+    bool __readBinaryInt(IntT &intVal)
+    {
+        std::make_unsigned_t<IntT> uintVal = 0;
+
+        for (size_t byteIdx = 0; byteIdx < sizeof(IntT); byteIdx++, __inputIdx++)
+        {
+            if (__inputIdx == __inputSize && !__fillInput())
+            {
+                return false;
+            }
+
+            uintVal |= (std::make_unsigned_t<IntT>)(unsigned char)__inputPtr[__inputIdx] << byteIdx * 8;
+        }
+
+        intVal = uintVal;
+
+        return true;
+    }
+
+
+    // Write Binary Int (Little-endian)
+    template <typename IntT>
+    void __writeBinaryInt(IntT intVal)
+    {
+        if (__outputSize + sizeof(IntT) > __outputBuffer.size())
+        {
+            __flush();
+        }
+
+        for (size_t byteIdx = 0; byteIdx < sizeof(IntT); byteIdx++)
+        {
+            __outputBuffer[__outputSize++] = (std::make_unsigned_t<IntT>)intVal >> byteIdx * 8;
+        }
+    }
+
+
+    // Read Text Int (The same as scanf("%d"): The value is unchanged if there is no int)
+    template <typename IntT>
+    bool __readTextInt(IntT &intVal)
+    {
+        // Skip the spaces
+        for (;; __inputIdx++)
+        {
+            if (__inputIdx == __inputSize && !__fillInput())
+            {
+                return false;
+            }
+
+            if (!isspace((unsigned char)__inputPtr[__inputIdx]))
+            {
+                break;
+            }
+        }
+
+        bool negBool = false;
+
+        if (__inputPtr[__inputIdx] == '-' || __inputPtr[__inputIdx] == '+')
+        {
+            negBool = __inputPtr[__inputIdx++] == '-';
+
+            if (__inputIdx == __inputSize && !__fillInput())
+            {
+                return false;
+            }
+        }
+
+        if ((unsigned)(__inputPtr[__inputIdx] - '0') > 9)
+        {
+            return false;
+        }
+
+        // The digits may cross the end of the buffer
+        std::make_unsigned_t<IntT> absVal = 0;
+
+        do
+        {
+            const char *charPtr = __inputPtr + __inputIdx, *endPtr = __inputPtr + __inputSize;
+
+            while (charPtr < endPtr && (unsigned)(*charPtr - '0') <= 9)
+            {
+                absVal = absVal * 10 + (*charPtr++ - '0');
+            }
+
+            __inputIdx = charPtr - __inputPtr;
+        }
+        while (__inputIdx == __inputSize && __fillInput());
+
+        intVal = negBool ? -absVal : absVal;
+
+        return true;
+    }
+
+
+    // Write Text Int (The same as printf("%d\n"))
+    template <typename IntT>
+    void __writeTextInt(IntT intVal)
+    {
+        // "-9223372036854775808\n"
+        if (__outputSize + 21 > __outputBuffer.size())
+        {
+            __flush();
+        }
+
+        auto digitPairTable = __getDigitPairTable();
+        char *outputPtr = __outputBuffer.data() + __outputSize;
+        std::make_unsigned_t<IntT> absVal = intVal;
+
+        if (intVal < 0)
+        {
+            *outputPtr++ = '-';
+            absVal = 0u - absVal;
+        }
+
+        // Two digits at a time, from the lowest ones
+        char digitBuffer[20], *digitPtr = digitBuffer + 20;
+
+        while (absVal >= 100)
+        {
+            size_t pairIdx = absVal % 100 * 2;
+            absVal /= 100;
+            *--digitPtr = digitPairTable[pairIdx + 1];
+            *--digitPtr = digitPairTable[pairIdx];
+        }
+
+        if (absVal >= 10)
+        {
+            *--digitPtr = digitPairTable[absVal * 2 + 1];
+            *--digitPtr = digitPairTable[absVal * 2];
+        }
+        else
+        {
+            *--digitPtr = '0' + absVal;
+        }
+
+        memcpy(outputPtr, digitPtr, digitBuffer + 20 - digitPtr);
+        outputPtr += digitBuffer + 20 - digitPtr;
+        *outputPtr++ = '\n';
+
+        __outputSize = outputPtr - __outputBuffer.data();
+    }
+
+
+    // Flush
+    void __flush()
+    {
+        if (__outputStrPtr)
+        {
+            __outputStrPtr->append(__outputBuffer.data(), __outputSize);
+            __outputSize = 0;
+
+            return;
+        }
+
+        for (size_t writeIdx = 0; writeIdx < __outputSize;)
+        {
+            ssize_t writeSize = write(__outputFd, __outputBuffer.data() + writeIdx, __outputSize - writeIdx);
+
+            if (writeSize < 0 && errno != EINTR)
+            {
+                __outputSize = 0;
+                throw runtime_error("Invalid output");
+            }
+
+            writeIdx += writeSize > 0 ? writeSize : 0;
+        }
+
+        __outputSize = 0;
+    }
+};
+
+
+}  // End namespace CMM
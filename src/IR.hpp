@@ -0,0 +1,531 @@
+/*
+    IR.hpp
+    ======
+        Class __IRInstruction, __IRBlock, __IRFunction implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::sort;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// IR Op Set
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const unordered_set<string> __IR_BINOP_SET {"add", "sub", "mul", "div", "lt", "le", "gt", "ge", "eq", "ne"};
+
+// The array builtins (A whole loop over the memory in the VM)
+const unordered_set<string> __IR_ARRAY_OP_SET {"afill", "acopy", "asum", "amin", "adot"};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __IRInstruction
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __IRInstruction
+{
+    // Friend
+    friend class __IRBlock;
+    friend class __IRFunction;
+    friend class __IRPass;
+    friend class __Compiler;
+
+
+public:
+
+    /*
+        %N = const Imm                      Imm
+        %N = param Imm                      The Imm-th param
+        %N = laddr Imm                      The start address of the local array Imm
+        %N = add %L, %R (sub, mul, ...)     %L op %R
+        %N = load %A                        SS[%A]
+        store %A, %V                        SS[%A] = %V
+        %N = call Imm(%0, %1, ...)          Call the function Imm
+        %N = in                             Read an int
+        out %V                              Write an int
+        %N = phi [%V, bbB], ...             SSA phi
+        br bbB                              Jump to bbB
+        cbr %C, bbT, bbF                    Jump to bbT if %C else bbF
+        ret [%V]                            Return
+    */
+    explicit __IRInstruction(const string &opName, int64_t valNum = -1, const vector<int64_t> &argList = {},
+        const string &immStr = "", const vector<size_t> &blockList = {}):
+        __opName   (opName),
+        __valNum   (valNum),
+        __argList  (argList),
+        __immStr   (immStr),
+        __blockList(blockList) {}
+
+
+private:
+
+    // Attribute
+    string __opName;
+    int64_t __valNum;
+    vector<int64_t> __argList;
+    string __immStr;
+    vector<size_t> __blockList;
+
+    // The source line (0 for unknown)
+    size_t __lineNum = 0;
+
+
+    // Is Terminator
+    bool __isTerminator() const
+    {
+        return __opName == "br" || __opName == "cbr" || __opName == "ret";
+    }
+
+
+    // Clobber Memory (A later load can not reuse an earlier one: A call, a task instruction, after which the
+    // global vars may be changed by the other tasks, or an array builtin)
+    bool __clobberMemory() const
+    {
+        return __opName == "call" || __opName == "spawn" || __opName == "join" || __opName == "aadd" ||
+            __opName == "acas" || __IR_ARRAY_OP_SET.count(__opName);
+    }
+
+
+    // Has Side Effect (Can not be removed or reordered with another one)
+    bool __hasSideEffect() const
+    {
+        return __opName == "store" || __opName == "in" || __opName == "out" || __clobberMemory() || __isTerminator();
+    }
+
+
+    // Is Pure (Depends on the args only)
+    bool __isPure() const
+    {
+        return __opName == "const" || __opName == "param" || __opName == "laddr" || __IR_BINOP_SET.count(__opName);
+    }
+
+
+    // Get Eval Arg List (The order in which the stack code evaluates the args)
+    vector<int64_t> __getEvalArgList() const
+    {
+        if (__opName == "call" || __opName == "spawn" || __opName == "aadd" || __opName == "acas" ||
+            __IR_ARRAY_OP_SET.count(__opName))
+        {
+            // ArgN-1, ..., Arg1, Arg0 (Arg0 is on the top of SS, or in AX for aadd / acas and the array builtins)
+            return vector<int64_t>(__argList.rbegin(), __argList.rend());
+        }
+        else if (__opName == "store")
+        {
+            // The value is evaluated before the address
+            return {__argList[1], __argList[0]};
+        }
+        else if (__opName == "phi")
+        {
+            return {};
+        }
+        else
+        {
+            return __argList;
+        }
+    }
+
+
+    // To String
+    string __toString() const
+    {
+        string insStr = __valNum >= 0 ? "%" + to_string(__valNum) + " = " + __opName : __opName;
+
+        if (__opName == "phi")
+        {
+            for (size_t idx = 0; idx < __argList.size(); idx++)
+            {
+                insStr += (idx ? ", [%" : " [%") + to_string(__argList[idx]) + ", bb" + to_string(__blockList[idx]) + "]";
+            }
+
+            return insStr;
+        }
+
+        if (!__immStr.empty())
+        {
+            insStr += " " + __immStr;
+        }
+
+        bool callBool = __opName == "call" || __opName == "spawn";
+
+        if (callBool)
+        {
+            insStr += "(";
+        }
+
+        for (size_t idx = 0; idx < __argList.size(); idx++)
+        {
+            insStr += (idx ? ", %" : (callBool ? "%" : " %")) + to_string(__argList[idx]);
+        }
+
+        if (callBool)
+        {
+            insStr += ")";
+        }
+
+        for (size_t idx = 0; idx < __blockList.size(); idx++)
+        {
+            insStr += (idx || !__argList.empty() ? ", bb" : " bb") + to_string(__blockList[idx]);
+        }
+
+        return insStr;
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __IRBlock
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __IRBlock
+{
+    // Friend
+    friend class __IRFunction;
+    friend class __IRPass;
+    friend class __Compiler;
+
+
+private:
+
+    // Attribute (The phis are the first ones, the terminator is the last one)
+    vector<__IRInstruction> __insList;
+
+
+    // Get Terminator
+    __IRInstruction &__getTerminator()
+    {
+        return __insList.back();
+    }
+
+
+    // Get Terminator (const)
+    const __IRInstruction &__getTerminator() const
+    {
+        return __insList.back();
+    }
+
+
+    // Get Successor List
+    const vector<size_t> &__getSuccList() const
+    {
+        return __getTerminator().__blockList;
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __IRFunction
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __IRFunction
+{
+    // Friend
+    friend class __IRPass;
+    friend class __Compiler;
+
+
+public:
+
+    // Constructor
+    explicit __IRFunction(const string &funcName = "", size_t paramNum = 0):
+        __funcName(funcName),
+        __paramNum(paramNum) {}
+
+
+private:
+
+    // Attribute (bb0 is the entry block)
+    string __funcName;
+    size_t __paramNum;
+    int64_t __valCount = 0;
+    vector<__IRBlock> __blockList;
+
+
+    // New Value
+    int64_t __newVal()
+    {
+        return __valCount++;
+    }
+
+
+    // Get Pred List
+    vector<vector<size_t>> __getPredList() const
+    {
+        vector<vector<size_t>> predList(__blockList.size());
+
+        for (size_t blockNum = 0; blockNum < __blockList.size(); blockNum++)
+        {
+            for (auto succNum: __blockList[blockNum].__getSuccList())
+            {
+                predList[succNum].push_back(blockNum);
+            }
+        }
+
+        return predList;
+    }
+
+
+    // Get Use Count
+    unordered_map<int64_t, size_t> __getUseCount() const
+    {
+        unordered_map<int64_t, size_t> useCountMap;
+
+        for (auto &blockObj: __blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                for (auto argNum: insObj.__argList)
+                {
+                    useCountMap[argNum]++;
+                }
+            }
+        }
+
+        return useCountMap;
+    }
+
+
+    // Replace All Use
+    void __replaceAllUse(const unordered_map<int64_t, int64_t> &replaceMap)
+    {
+        if (replaceMap.empty())
+        {
+            return;
+        }
+
+        for (auto &blockObj: __blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                for (auto &argNum: insObj.__argList)
+                {
+                    // Follow the chain: %1 -> %2 -> %3
+                    while (replaceMap.count(argNum))
+                    {
+                        argNum = replaceMap.at(argNum);
+                    }
+                }
+            }
+        }
+    }
+
+
+    // Get Reverse Post Order
+    vector<size_t> __getRPOList() const
+    {
+        vector<size_t> postOrderList;
+        vector<bool> visitedList(__blockList.size());
+
+        // (Block number, Next successor index)
+        vector<std::pair<size_t, size_t>> blockStack {{0, 0}};
+        visitedList[0] = true;
+
+        while (!blockStack.empty())
+        {
+            auto &[blockNum, succIdx] = blockStack.back();
+            auto &succList = __blockList[blockNum].__getSuccList();
+
+            if (succIdx < succList.size())
+            {
+                size_t succNum = succList[succIdx++];
+
+                if (!visitedList[succNum])
+                {
+                    visitedList[succNum] = true;
+                    blockStack.emplace_back(succNum, 0);
+                }
+            }
+            else
+            {
+                postOrderList.push_back(blockNum);
+                blockStack.pop_back();
+            }
+        }
+
+        return vector<size_t>(postOrderList.rbegin(), postOrderList.rend());
+    }
+
+
+    // Get Immediate Dominator List (Cooper, Harvey, Kennedy. Unreachable blocks get -1)
+    vector<int64_t> __getIdomList() const
+    {
+        auto RPOList  = __getRPOList();
+        auto predList = __getPredList();
+        vector<int64_t> idomList(__blockList.size(), -1);
+        vector<size_t> RPONumList(__blockList.size());
+
+        for (size_t idx = 0; idx < RPOList.size(); idx++)
+        {
+            RPONumList[RPOList[idx]] = idx;
+        }
+
+        auto intersectBlock = [&](int64_t lhsNum, int64_t rhsNum)
+        {
+            while (lhsNum != rhsNum)
+            {
+                while (RPONumList[lhsNum] > RPONumList[rhsNum])
+                {
+                    lhsNum = idomList[lhsNum];
+                }
+
+                while (RPONumList[rhsNum] > RPONumList[lhsNum])
+                {
+                    rhsNum = idomList[rhsNum];
+                }
+            }
+
+            return lhsNum;
+        };
+
+        idomList[0] = 0;
+
+        for (bool changeBool = true; changeBool;)
+        {
+            changeBool = false;
+
+            for (size_t idx = 1; idx < RPOList.size(); idx++)
+            {
+                int64_t newIdom = -1;
+
+                for (auto predNum: predList[RPOList[idx]])
+                {
+                    if (idomList[predNum] >= 0)
+                    {
+                        newIdom = newIdom < 0 ? predNum : intersectBlock(predNum, newIdom);
+                    }
+                }
+
+                if (idomList[RPOList[idx]] != newIdom)
+                {
+                    idomList[RPOList[idx]] = newIdom;
+                    changeBool = true;
+                }
+            }
+        }
+
+        return idomList;
+    }
+
+
+    // Remove Unreachable Block (And renumber the blocks)
+    bool __removeUnreachableBlock()
+    {
+        auto RPOList = __getRPOList();
+
+        if (RPOList.size() == __blockList.size())
+        {
+            return false;
+        }
+
+        // Keep the original order of the reachable blocks
+        vector<int64_t> newNumList(__blockList.size(), -1);
+        vector<__IRBlock> newBlockList;
+
+        sort(RPOList.begin(), RPOList.end());
+
+        for (auto blockNum: RPOList)
+        {
+            newNumList[blockNum] = newBlockList.size();
+            newBlockList.push_back(std::move(__blockList[blockNum]));
+        }
+
+        for (auto &blockObj: newBlockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__opName == "phi")
+                {
+                    // Drop the incoming values of the removed preds
+                    vector<int64_t> argList;
+                    vector<size_t> blockList;
+
+                    for (size_t idx = 0; idx < insObj.__argList.size(); idx++)
+                    {
+                        if (newNumList[insObj.__blockList[idx]] >= 0)
+                        {
+                            argList.push_back(insObj.__argList[idx]);
+                            blockList.push_back(newNumList[insObj.__blockList[idx]]);
+                        }
+                    }
+
+                    insObj.__argList   = argList;
+                    insObj.__blockList = blockList;
+                }
+                else
+                {
+                    for (auto &blockNum: insObj.__blockList)
+                    {
+                        blockNum = newNumList[blockNum];
+                    }
+                }
+            }
+        }
+
+        __blockList = std::move(newBlockList);
+
+        return true;
+    }
+
+
+    // Count Instruction
+    size_t __countInstruction() const
+    {
+        size_t insNum = 0;
+
+        for (auto &blockObj: __blockList)
+        {
+            insNum += blockObj.__insList.size();
+        }
+
+        return insNum;
+    }
+
+
+    // To String
+    string __toString() const
+    {
+        string funcStr = "func " + __funcName + "(";
+
+        for (size_t idx = 0; idx < __paramNum; idx++)
+        {
+            funcStr += (idx ? ", %" : "%") + to_string(idx);
+        }
+
+        funcStr += "):\n";
+
+        for (size_t blockNum = 0; blockNum < __blockList.size(); blockNum++)
+        {
+            funcStr += "bb" + to_string(blockNum) + ":\n";
+
+            for (auto &insObj: __blockList[blockNum].__insList)
+            {
+                funcStr += "    " + insObj.__toString() + "\n";
+            }
+        }
+
+        return funcStr;
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,809 @@
+/*
+    IRPass.hpp
+    ==========
+        Class __IRPass implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+#include <limits>
+#include <cstdio>
+#include "IR.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::pair;
+using std::sort;
+using std::stoll;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __IRPass
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __IRPass
+{
+    // Friend
+    friend class __Compiler;
+
+
+private:
+
+    // Remove Trivial Phi
+    static bool __removeTrivialPhi(__IRFunction &funcObj)
+    {
+        /*
+            %N = phi [%V, bbA], [%N, bbB], [%V, bbC]  =>  %V
+            %N = phi [%N, bbA]                        =>  %N = const 0 (Undefined)
+        */
+        bool resBool = false;
+
+        for (bool changeBool = true; changeBool;)
+        {
+            changeBool = false;
+            unordered_map<int64_t, int64_t> replaceMap;
+
+            for (auto &blockObj: funcObj.__blockList)
+            {
+                vector<__IRInstruction> insList, constList;
+
+                for (auto &insObj: blockObj.__insList)
+                {
+                    if (insObj.__opName != "phi" || replaceMap.count(insObj.__valNum))
+                    {
+                        insList.push_back(insObj);
+                        continue;
+                    }
+
+                    int64_t sameNum = -1;
+                    bool trivialBool = true;
+
+                    for (auto argNum: insObj.__argList)
+                    {
+                        while (replaceMap.count(argNum))
+                        {
+                            argNum = replaceMap.at(argNum);
+                        }
+
+                        if (argNum == insObj.__valNum || argNum == sameNum)
+                        {
+                            continue;
+                        }
+
+                        if (sameNum >= 0)
+                        {
+                            trivialBool = false;
+                            break;
+                        }
+
+                        sameNum = argNum;
+                    }
+
+                    if (!trivialBool)
+                    {
+                        insList.push_back(insObj);
+                    }
+                    else if (sameNum >= 0)
+                    {
+                        replaceMap[insObj.__valNum] = sameNum;
+                        changeBool = true;
+                    }
+                    else
+                    {
+                        constList.emplace_back("const", insObj.__valNum, vector<int64_t> {}, "0");
+                        changeBool = true;
+                    }
+                }
+
+                // The phis must be the first ones
+                size_t phiNum = 0;
+
+                while (phiNum < insList.size() && insList[phiNum].__opName == "phi")
+                {
+                    phiNum++;
+                }
+
+                insList.insert(insList.begin() + phiNum, constList.begin(), constList.end());
+                blockObj.__insList = std::move(insList);
+            }
+
+            funcObj.__replaceAllUse(replaceMap);
+            resBool = resBool || changeBool;
+        }
+
+        return resBool;
+    }
+
+
+    // Fold Binary Op (In the VM word: WordT wraps around by UWordT, false for a division the VM would fail)
+    template <typename WordT, typename UWordT>
+    static bool __foldBinOp(const string &opName, WordT lhsVal, WordT rhsVal, int64_t &resVal)
+    {
+        if (opName == "div" && (!rhsVal || (lhsVal == std::numeric_limits<WordT>::min() && rhsVal == -1)))
+        {
+            return false;
+        }
+
+        if      (opName == "add") resVal = (WordT)((UWordT)lhsVal + (UWordT)rhsVal);
+        else if (opName == "sub") resVal = (WordT)((UWordT)lhsVal - (UWordT)rhsVal);
+        else if (opName == "mul") resVal = (WordT)((UWordT)lhsVal * (UWordT)rhsVal);
+        else if (opName == "div") resVal = lhsVal / rhsVal;
+        else if (opName == "lt")  resVal = lhsVal <  rhsVal;
+        else if (opName == "le")  resVal = lhsVal <= rhsVal;
+        else if (opName == "gt")  resVal = lhsVal >  rhsVal;
+        else if (opName == "ge")  resVal = lhsVal >= rhsVal;
+        else if (opName == "eq")  resVal = lhsVal == rhsVal;
+        else                      resVal = lhsVal != rhsVal;
+
+        return true;
+    }
+
+
+    // Fold Const (The VM computes in int32 or int64 by the word size)
+    static bool __foldConst(__IRFunction &funcObj, size_t wordSize)
+    {
+        bool resBool = false;
+
+        for (bool changeBool = true; changeBool;)
+        {
+            changeBool = false;
+
+            // Value number -> Const
+            unordered_map<int64_t, int64_t> constMap;
+            unordered_map<int64_t, int64_t> replaceMap;
+
+            for (auto &blockObj: funcObj.__blockList)
+            {
+                for (auto &insObj: blockObj.__insList)
+                {
+                    if (insObj.__opName == "const")
+                    {
+                        constMap[insObj.__valNum] = stoll(insObj.__immStr);
+                    }
+                }
+            }
+
+            for (auto &blockObj: funcObj.__blockList)
+            {
+                for (auto &insObj: blockObj.__insList)
+                {
+                    if (!__IR_BINOP_SET.count(insObj.__opName))
+                    {
+                        continue;
+                    }
+
+                    auto &opName = insObj.__opName;
+                    int64_t lhsNum = insObj.__argList[0], rhsNum = insObj.__argList[1];
+                    bool lhsBool = constMap.count(lhsNum), rhsBool = constMap.count(rhsNum);
+
+                    if (lhsBool && rhsBool)
+                    {
+                        int64_t resVal;
+
+                        if (!(wordSize == 64 ?
+                            __foldBinOp<int64_t, uint64_t>(opName, constMap.at(lhsNum), constMap.at(rhsNum), resVal) :
+                            __foldBinOp<int32_t, uint32_t>(opName, constMap.at(lhsNum), constMap.at(rhsNum), resVal)))
+                        {
+                            continue;
+                        }
+
+                        insObj = __IRInstruction("const", insObj.__valNum, {}, to_string(resVal));
+                        constMap[insObj.__valNum] = resVal;
+                        changeBool = true;
+                    }
+                    // x + 0, x - 0, x * 1, x / 1
+                    else if (rhsBool && ((constMap.at(rhsNum) == 0 && (opName == "add" || opName == "sub")) ||
+                        (constMap.at(rhsNum) == 1 && (opName == "mul" || opName == "div"))))
+                    {
+                        replaceMap[insObj.__valNum] = lhsNum;
+                    }
+                    // 0 + x, 1 * x
+                    else if (lhsBool && ((constMap.at(lhsNum) == 0 && opName == "add") ||
+                        (constMap.at(lhsNum) == 1 && opName == "mul")))
+                    {
+                        replaceMap[insObj.__valNum] = rhsNum;
+                    }
+                    // x - x, x == x, ...
+                    else if (lhsNum == rhsNum && (opName == "sub" || opName == "lt" || opName == "gt" || opName == "ne"))
+                    {
+                        insObj = __IRInstruction("const", insObj.__valNum, {}, "0");
+                        changeBool = true;
+                    }
+                    else if (lhsNum == rhsNum && (opName == "le" || opName == "ge" || opName == "eq"))
+                    {
+                        insObj = __IRInstruction("const", insObj.__valNum, {}, "1");
+                        changeBool = true;
+                    }
+                }
+            }
+
+            if (!replaceMap.empty())
+            {
+                // The replaced instructions are removed by the DCE
+                for (auto &blockObj: funcObj.__blockList)
+                {
+                    for (auto &insObj: blockObj.__insList)
+                    {
+                        if (insObj.__valNum >= 0 && replaceMap.count(insObj.__valNum))
+                        {
+                            insObj = __IRInstruction("const", insObj.__valNum, {}, "0");
+                        }
+                    }
+                }
+
+                funcObj.__replaceAllUse(replaceMap);
+                changeBool = true;
+            }
+
+            resBool = resBool || changeBool;
+        }
+
+        return resBool;
+    }
+
+
+    // Simplify CFG
+    static bool __simplifyCFG(__IRFunction &funcObj)
+    {
+        bool resBool = false;
+
+        for (bool changeBool = true; changeBool;)
+        {
+            changeBool = false;
+
+            unordered_map<int64_t, int64_t> constMap;
+
+            for (auto &blockObj: funcObj.__blockList)
+            {
+                for (auto &insObj: blockObj.__insList)
+                {
+                    if (insObj.__opName == "const")
+                    {
+                        constMap[insObj.__valNum] = stoll(insObj.__immStr);
+                    }
+                }
+            }
+
+            // cbr %Const, bbT, bbF  =>  br bbT | br bbF
+            for (size_t blockNum = 0; blockNum < funcObj.__blockList.size(); blockNum++)
+            {
+                auto &termObj = funcObj.__blockList[blockNum].__getTerminator();
+
+                if (termObj.__opName != "cbr" ||
+                    (!constMap.count(termObj.__argList[0]) && termObj.__blockList[0] != termObj.__blockList[1]))
+                {
+                    continue;
+                }
+
+                size_t keepNum = termObj.__blockList[0], dropNum = termObj.__blockList[1];
+
+                if (constMap.count(termObj.__argList[0]) && !constMap.at(termObj.__argList[0]))
+                {
+                    std::swap(keepNum, dropNum);
+                }
+
+                termObj = __IRInstruction("br", -1, {}, "", {keepNum});
+
+                if (keepNum != dropNum)
+                {
+                    __removePhiIncoming(funcObj.__blockList[dropNum], blockNum);
+                }
+
+                changeBool = true;
+            }
+
+            if (funcObj.__removeUnreachableBlock())
+            {
+                changeBool = true;
+            }
+
+            // bbA: ... br bbB, bbB has the only pred bbA  =>  Merge bbB into bbA (All the chains of a round, with one
+            // replace of the phis of the merged blocks at its end)
+            auto predList = funcObj.__getPredList();
+            unordered_map<int64_t, int64_t> replaceMap;
+
+            for (size_t blockNum = 0; blockNum < funcObj.__blockList.size(); blockNum++)
+            {
+                auto &blockObj = funcObj.__blockList[blockNum];
+
+                for (;;)
+                {
+                    auto &termObj = blockObj.__getTerminator();
+
+                    if (termObj.__opName != "br")
+                    {
+                        break;
+                    }
+
+                    size_t succNum = termObj.__blockList[0];
+
+                    // A merged bbB is left as "br bbB", so it is never merged again
+                    if (succNum == blockNum || succNum == 0 || predList[succNum].size() != 1)
+                    {
+                        break;
+                    }
+
+                    auto &succObj = funcObj.__blockList[succNum];
+                    vector<__IRInstruction> insList;
+
+                    for (auto &insObj: succObj.__insList)
+                    {
+                        if (insObj.__opName == "phi")
+                        {
+                            replaceMap[insObj.__valNum] = insObj.__argList[0];
+                        }
+                        else
+                        {
+                            insList.push_back(std::move(insObj));
+                        }
+                    }
+
+                    blockObj.__insList.pop_back();
+                    blockObj.__insList.insert(blockObj.__insList.end(), std::make_move_iterator(insList.begin()),
+                        std::make_move_iterator(insList.end()));
+
+                    // bbB -> bbA in the phis of the successors (Their pred numbers stay the same)
+                    for (auto newSuccNum: blockObj.__getSuccList())
+                    {
+                        for (auto &insObj: funcObj.__blockList[newSuccNum].__insList)
+                        {
+                            if (insObj.__opName == "phi")
+                            {
+                                for (auto &phiBlockNum: insObj.__blockList)
+                                {
+                                    if (phiBlockNum == succNum)
+                                    {
+                                        phiBlockNum = blockNum;
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // bbB is unreachable now
+                    succObj.__insList = {__IRInstruction("br", -1, {}, "", {succNum})};
+                    changeBool = true;
+                }
+            }
+
+            funcObj.__replaceAllUse(replaceMap);
+            funcObj.__removeUnreachableBlock();
+
+            if (__removeTrivialPhi(funcObj))
+            {
+                changeBool = true;
+            }
+
+            resBool = resBool || changeBool;
+        }
+
+        return resBool;
+    }
+
+
+    // Remove Phi Incoming
+    static void __removePhiIncoming(__IRBlock &blockObj, size_t predNum)
+    {
+        for (auto &insObj: blockObj.__insList)
+        {
+            if (insObj.__opName != "phi")
+            {
+                continue;
+            }
+
+            for (size_t idx = 0; idx < insObj.__blockList.size(); idx++)
+            {
+                if (insObj.__blockList[idx] == predNum)
+                {
+                    insObj.__argList.erase(insObj.__argList.begin() + idx);
+                    insObj.__blockList.erase(insObj.__blockList.begin() + idx);
+                    break;
+                }
+            }
+        }
+    }
+
+
+    // Number Value (Global value numbering over the dominator tree)
+    static bool __numberValue(__IRFunction &funcObj)
+    {
+        /*
+            A pure instruction is replaced by an equal one in a dominator.
+            A load is replaced by an equal load (Or the stored value) with the same memory version,
+            a block continues the memory version of its idom only if the idom is its only pred.
+        */
+        auto idomList = funcObj.__getIdomList();
+        auto predList = funcObj.__getPredList();
+        vector<vector<size_t>> childList(funcObj.__blockList.size());
+
+        for (size_t blockNum = 1; blockNum < funcObj.__blockList.size(); blockNum++)
+        {
+            if (idomList[blockNum] >= 0)
+            {
+                childList[idomList[blockNum]].push_back(blockNum);
+            }
+        }
+
+        // Expression -> Value number, and the undo log of each block
+        unordered_map<string, int64_t> valNumMap;
+        vector<vector<string>> undoList(funcObj.__blockList.size());
+        unordered_map<int64_t, int64_t> replaceMap;
+        vector<size_t> endVerList(funcObj.__blockList.size());
+        size_t verNum = 0;
+
+        auto getNum = [&](int64_t argNum)
+        {
+            while (replaceMap.count(argNum))
+            {
+                argNum = replaceMap.at(argNum);
+            }
+
+            return argNum;
+        };
+
+        // (Block number, Is leaving)
+        vector<pair<size_t, bool>> blockStack {{0, false}};
+
+        while (!blockStack.empty())
+        {
+            auto [blockNum, leaveBool] = blockStack.back();
+            blockStack.pop_back();
+
+            if (leaveBool)
+            {
+                for (auto &expStr: undoList[blockNum])
+                {
+                    valNumMap.erase(expStr);
+                }
+
+                continue;
+            }
+
+            blockStack.emplace_back(blockNum, true);
+
+            for (auto childNum: childList[blockNum])
+            {
+                blockStack.emplace_back(childNum, false);
+            }
+
+            size_t memVer = predList[blockNum].size() == 1 && (int64_t)predList[blockNum][0] == idomList[blockNum] ?
+                endVerList[idomList[blockNum]] : ++verNum;
+
+            auto addExp = [&](const string &expStr, int64_t valNum)
+            {
+                if (valNumMap.emplace(expStr, valNum).second)
+                {
+                    undoList[blockNum].push_back(expStr);
+                }
+            };
+
+            for (auto &insObj: funcObj.__blockList[blockNum].__insList)
+            {
+                for (auto &argNum: insObj.__argList)
+                {
+                    argNum = getNum(argNum);
+                }
+
+                string expStr;
+
+                if (insObj.__isPure() && insObj.__opName != "param")
+                {
+                    auto argList = insObj.__argList;
+
+                    if (insObj.__opName == "add" || insObj.__opName == "mul" || insObj.__opName == "eq" ||
+                        insObj.__opName == "ne")
+                    {
+                        sort(argList.begin(), argList.end());
+                    }
+
+                    expStr = insObj.__opName + " " + insObj.__immStr;
+
+                    for (auto argNum: argList)
+                    {
+                        expStr += " %" + to_string(argNum);
+                    }
+                }
+                else if (insObj.__opName == "load")
+                {
+                    expStr = "load %" + to_string(insObj.__argList[0]) + " " + to_string(memVer);
+                }
+                else if (insObj.__opName == "store")
+                {
+                    // The later load of the same address gets the stored value
+                    memVer = ++verNum;
+                    addExp("load %" + to_string(insObj.__argList[0]) + " " + to_string(memVer), insObj.__argList[1]);
+                }
+                else if (insObj.__clobberMemory())
+                {
+                    memVer = ++verNum;
+                }
+
+                if (expStr.empty())
+                {
+                    continue;
+                }
+
+                if (valNumMap.count(expStr))
+                {
+                    replaceMap[insObj.__valNum] = valNumMap.at(expStr);
+                }
+                else
+                {
+                    addExp(expStr, insObj.__valNum);
+                }
+            }
+
+            endVerList[blockNum] = memVer;
+        }
+
+        // The phis in the blocks not dominated by the definition
+        funcObj.__replaceAllUse(replaceMap);
+
+        return !replaceMap.empty();
+    }
+
+
+    // Eliminate Dead Code
+    static bool __eliminateDeadCode(__IRFunction &funcObj)
+    {
+        unordered_map<int64_t, const __IRInstruction *> defMap;
+        unordered_set<int64_t> liveSet;
+        vector<int64_t> valStack;
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            for (auto &insObj: blockObj.__insList)
+            {
+                if (insObj.__valNum >= 0)
+                {
+                    defMap[insObj.__valNum] = &insObj;
+                }
+
+                if (insObj.__hasSideEffect())
+                {
+                    valStack.insert(valStack.end(), insObj.__argList.begin(), insObj.__argList.end());
+                }
+            }
+        }
+
+        while (!valStack.empty())
+        {
+            int64_t valNum = valStack.back();
+            valStack.pop_back();
+
+            if (liveSet.insert(valNum).second && defMap.count(valNum))
+            {
+                auto &argList = defMap.at(valNum)->__argList;
+                valStack.insert(valStack.end(), argList.begin(), argList.end());
+            }
+        }
+
+        bool changeBool = false;
+
+        for (auto &blockObj: funcObj.__blockList)
+        {
+            vector<__IRInstruction> insList;
+
+            for (auto &insObj: blockObj.__insList)
+            {
+                // A param is kept to hold its value number
+                if (insObj.__hasSideEffect() || insObj.__opName == "param" || liveSet.count(insObj.__valNum))
+                {
+                    insList.push_back(insObj);
+                }
+                else
+                {
+                    changeBool = true;
+                }
+            }
+
+            blockObj.__insList = std::move(insList);
+        }
+
+        return changeBool;
+    }
+
+
+    // Inline Function
+    static bool __inlineFunction(unordered_map<string, __IRFunction> &funcMap, const unordered_set<string> &inlineSet,
+        bool reportBool)
+    {
+        bool resBool = false;
+
+        for (auto &[funcName, funcObj]: funcMap)
+        {
+            // The return values of the inlined calls, replaced once at the end
+            unordered_map<int64_t, int64_t> replaceMap;
+
+            // The callee blocks are appended, so one scan of the growing block list also finds the calls of the callees
+            for (size_t blockNum = 0; blockNum < funcObj.__blockList.size(); blockNum++)
+            {
+                vector<size_t> callIdxList;
+
+                for (size_t insIdx = 0; insIdx < funcObj.__blockList[blockNum].__insList.size(); insIdx++)
+                {
+                    auto &insObj = funcObj.__blockList[blockNum].__insList[insIdx];
+
+                    if (insObj.__opName == "call" && insObj.__immStr != funcName && inlineSet.count(insObj.__immStr) &&
+                        funcMap.count(insObj.__immStr))
+                    {
+                        if (reportBool)
+                        {
+                            fprintf(stderr, "Inline: %s -> %s (line %zu)\n", funcName.c_str(), insObj.__immStr.c_str(),
+                                insObj.__lineNum);
+                        }
+
+                        callIdxList.push_back(insIdx);
+                    }
+                }
+
+                // From the last call, so a split only moves the instructions up to the next call
+                for (auto callIter = callIdxList.rbegin(); callIter != callIdxList.rend(); callIter++)
+                {
+                    __inlineCall(funcObj, funcMap.at(funcObj.__blockList[blockNum].__insList[*callIter].__immStr),
+                        blockNum, *callIter, replaceMap);
+                    resBool = true;
+                }
+            }
+
+            funcObj.__replaceAllUse(replaceMap);
+        }
+
+        return resBool;
+    }
+
+
+    // Inline Call
+    static void __inlineCall(__IRFunction &funcObj, const __IRFunction &calleeObj, size_t blockNum, size_t insIdx,
+        unordered_map<int64_t, int64_t> &replaceMap)
+    {
+        /*
+            bbA: ... %N = call F(...) ...  =>  bbA: ... br bbF0
+                                               bbF0...: (The callee blocks, "ret %V" -> "br bbC")
+                                               bbC: %N = phi [%V, ...] ...
+        */
+        auto callObj = funcObj.__blockList[blockNum].__insList[insIdx];
+        size_t contNum = funcObj.__blockList.size(), baseNum = contNum + 1;
+
+        // The continuation block
+        funcObj.__blockList.emplace_back();
+
+        auto &blockList = funcObj.__blockList;
+        auto &callerInsList = blockList[blockNum].__insList;
+
+        blockList[contNum].__insList.assign(std::make_move_iterator(callerInsList.begin() + insIdx + 1),
+            std::make_move_iterator(callerInsList.end()));
+
+        callerInsList.erase(callerInsList.begin() + insIdx, callerInsList.end());
+        callerInsList.emplace_back("br", -1, vector<int64_t> {}, "", vector<size_t> {baseNum});
+
+        // bbA -> bbC in the phis of the successors
+        for (auto succNum: blockList[contNum].__getSuccList())
+        {
+            for (auto &insObj: blockList[succNum].__insList)
+            {
+                if (insObj.__opName == "phi")
+                {
+                    for (auto &phiBlockNum: insObj.__blockList)
+                    {
+                        if (phiBlockNum == blockNum)
+                        {
+                            phiBlockNum = contNum;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Callee value number -> New value number
+        unordered_map<int64_t, int64_t> valMap;
+        vector<int64_t> retValList;
+        vector<size_t> retBlockList, voidRetBlockList;
+
+        for (auto &calleeBlock: calleeObj.__blockList)
+        {
+            for (auto &insObj: calleeBlock.__insList)
+            {
+                if (insObj.__opName == "param")
+                {
+                    valMap[insObj.__valNum] = callObj.__argList[stoll(insObj.__immStr)];
+                }
+                else if (insObj.__valNum >= 0)
+                {
+                    valMap[insObj.__valNum] = funcObj.__newVal();
+                }
+            }
+        }
+
+        for (size_t calleeNum = 0; calleeNum < calleeObj.__blockList.size(); calleeNum++)
+        {
+            __IRBlock blockObj;
+
+            for (auto insObj: calleeObj.__blockList[calleeNum].__insList)
+            {
+                if (insObj.__opName == "param")
+                {
+                    continue;
+                }
+
+                if (insObj.__valNum >= 0)
+                {
+                    insObj.__valNum = valMap.at(insObj.__valNum);
+                }
+
+                for (auto &argNum: insObj.__argList)
+                {
+                    argNum = valMap.at(argNum);
+                }
+
+                for (auto &insBlockNum: insObj.__blockList)
+                {
+                    insBlockNum += baseNum;
+                }
+
+                if (insObj.__opName == "ret")
+                {
+                    if (!insObj.__argList.empty())
+                    {
+                        retValList.push_back(insObj.__argList[0]);
+                        retBlockList.push_back(baseNum + calleeNum);
+                    }
+                    else
+                    {
+                        voidRetBlockList.push_back(baseNum + calleeNum);
+                    }
+
+                    insObj = __IRInstruction("br", -1, {}, "", {contNum});
+                }
+
+                blockObj.__insList.push_back(insObj);
+            }
+
+            funcObj.__blockList.push_back(std::move(blockObj));
+        }
+
+        // The return value (The preds of bbC are the callee blocks of the "ret"s)
+        if (retValList.size() == 1)
+        {
+            replaceMap[callObj.__valNum] = retValList[0];
+        }
+        else if (retValList.empty())
+        {
+            funcObj.__blockList[contNum].__insList.insert(funcObj.__blockList[contNum].__insList.begin(),
+                __IRInstruction("const", callObj.__valNum, {}, "0"));
+        }
+        else
+        {
+            // A "ret" without value leaves an undefined value (Any one of the others)
+            for (auto predNum: voidRetBlockList)
+            {
+                retValList.push_back(retValList[0]);
+                retBlockList.push_back(predNum);
+            }
+
+            funcObj.__blockList[contNum].__insList.insert(funcObj.__blockList[contNum].__insList.begin(),
+                __IRInstruction("phi", callObj.__valNum, retValList, "", retBlockList));
+        }
+    }
+};
+
+
+}  // End namespace CMM
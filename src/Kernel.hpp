@@ -2,9 +2,26 @@
 
 #include <string>
 #include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <chrono>
+#include <type_traits>
+#include <cstdio>
+#include <cerrno>
+#include <memory>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
 #include <boost/program_options.hpp>
 #include "Compiler.hpp"
+#include "Linker.hpp"
+#include "Cache.hpp"
 #include "VM.hpp"
+#include "Batch.hpp"
+#include "Stream.hpp"
+#include "Server.hpp"
+#include "Util.hpp"
 
 namespace CMM
 {
@@ -14,8 +31,15 @@ namespace CMM
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 using std::string;
+using std::to_string;
+using std::vector;
 using std::cout;
+using std::ifstream;
 using std::endl;
+using std::runtime_error;
+using std::get;
+using std::unique_ptr;
+using std::make_unique;
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -41,12 +65,54 @@ public:
 
 private:
 
+    // The quiet time (ms) after the events of a change of --watch
+    static constexpr int __WATCH_QUIET_MS = 50;
+
+
     // Data
     int __Argc;
     char **__Argv;
     string __inputFilePath;
     string __outputFilePath;
     string __asmFilePath;
+    string __ioInputFilePath;
+    string __ioOutputFilePath;
+    string __ioFormat;
+    bool __profileBool;
+    string __foldedStackFilePath;
+    uint64_t __sampleInterval;
+    uint64_t __sampleTimerUs;
+    bool __perfCounterBool;
+    string __statsJsonPath;
+    size_t __wordSize;
+    bool __boundsCheckBool;
+    bool __traceBool;
+    string __arrayKernelName;
+    bool __batchBool;
+    bool __streamBool;
+    string __serveSocketPath;
+    size_t __jobNum;
+    uint64_t __quantum;
+    size_t __laneNum;
+    uint64_t __fuel;
+    size_t __inlineBudget;
+    bool __inlineReportBool;
+    size_t __optLevel;
+    string __printAfterName;
+    bool __timePassBool;
+    bool __cacheBool;
+    string __cacheDirPath;
+    uint64_t __cacheSize;
+    bool __watchBool;
+    bool __objectBool;
+    vector<string> __linkFilePathList;
+
+    // The compile cache (Only with --cache), and the instructions of a cached program
+    unique_ptr<__Cache> __cachePtr;
+    size_t __cacheInsNum = 0;
+
+    // The code of the functions of the last compile (Only with --cache or --watch)
+    unique_ptr<__FuncCache> __funcCachePtr;
 
 
     // Construct Argument
@@ -67,7 +133,112 @@ private:
                 "Output asm file path")
 
             ("asm-file-path,", po::value<string>(&__asmFilePath),
-                "Input asm file path for running");
+                "Input asm file path for running")
+
+            ("input-file,", po::value<string>(&__ioInputFilePath),
+                "Program input file path (Default: stdin)")
+
+            ("output-file,", po::value<string>(&__ioOutputFilePath),
+                "Program output file path (Default: stdout)")
+
+            ("io-format,", po::value<string>(&__ioFormat)->default_value("text"),
+                "Program I/O format: text, binary (Little-endian int32)")
+
+            ("profile,", po::bool_switch(&__profileBool),
+                "Report the executed instructions per function, opcode and IP range to stderr")
+
+            ("folded-stack-file,", po::value<string>(&__foldedStackFilePath),
+                "Write the sampled call stacks in the folded format of the flame graph tools")
+
+            ("sample-interval,", po::value<uint64_t>(&__sampleInterval)->default_value(1000),
+                "Sample the call stack every N instructions")
+
+            ("sample-timer-us,", po::value<uint64_t>(&__sampleTimerUs)->default_value(0),
+                "Sample the call stack every N us of CPU time (SIGPROF) instead, if it is not 0")
+
+            ("perf-counters,", po::bool_switch(&__perfCounterBool),
+                "Report the hardware perf counters of the run (Per function with --profile) to stderr")
+
+            ("stats-json,", po::value<string>(&__statsJsonPath),
+                "Write the compile and run statistics as JSON to the path (\"-\" for stderr)")
+
+            ("word-size,", po::value<size_t>(&__wordSize)->default_value(32),
+                "VM word size: 32, 64 (The binary I/O ints are of the same size)")
+
+            ("bounds-check,", po::bool_switch(&__boundsCheckBool),
+                "Check each SS / RS access of the VM")
+
+            ("trace,", po::bool_switch(&__traceBool),
+                "Trace each executed instruction with AX and the SS size to stderr")
+
+            ("array-kernel,", po::value<string>(&__arrayKernelName)->default_value("auto"),
+                "Kernel of the array builtins: auto (The best one of the CPU), avx2, sse4.2, scalar")
+
+            ("batch,", po::bool_switch(&__batchBool),
+                "Run the program once per line of ints of --input-file, and write a line of outputs per line to "
+                "--output-file in order")
+
+            ("stream,", po::bool_switch(&__streamBool),
+                "Run an instance of the program per id of the lines \"Id Int ...\" of --input-file (\"Id .\" closes "
+                "its input), and write the outputs as lines \"Id Int\" (\"Id .\" at its end) to --output-file")
+
+            ("serve,", po::value<string>(&__serveSocketPath),
+                "Serve the compile and run requests of the clients of the Unix socket path (See bench/client.py) until "
+                "SIGINT / SIGTERM")
+
+            ("jobs,", po::value<size_t>(&__jobNum)->default_value(0),
+                "Worker threads of --batch, --stream, --serve and the tasks of spawn, pinned to the CPUs (Default: one "
+                "per CPU)")
+
+            ("quantum,", po::value<uint64_t>(&__quantum)->default_value(0),
+                "Run the records of --batch as green threads by slices of N instructions on a work-stealing "
+                "scheduler (Default: each record to the end, 10000 for --stream and the tasks of spawn)")
+
+            ("lanes,", po::value<size_t>(&__laneNum)->default_value(0),
+                "Experimental: run the records of --batch by groups of N (8, 16) in lockstep, a word per record in "
+                "each SS slot (Default: one record at a time)")
+
+            ("fuel,", po::value<uint64_t>(&__fuel)->default_value(0),
+                "Max instructions of a run (Of each record or instance with --batch or --stream, and of each task), 0 "
+                "for unlimited")
+
+            ("inline-budget,", po::value<size_t>(&__inlineBudget)->default_value(128),
+                "Max AST node number of an inlined function")
+
+            ("inline-report,", po::bool_switch(&__inlineReportBool),
+                "Report the inlined call sites to stderr")
+
+            ("opt-level,O", po::value<size_t>(&__optLevel)->default_value(1),
+                "Optimization level: 0, 1, 2 (SSA)")
+
+            ("print-after,", po::value<string>(&__printAfterName),
+                "Dump the code after a pass to stderr")
+
+            ("time-passes,", po::bool_switch(&__timePassBool),
+                "Report the time of each pass to stderr")
+
+            ("cache,", po::bool_switch(&__cacheBool),
+                "Reuse the asm of a source compiled before with the same -O and --inline-budget (And --word-size with "
+                "-O2) from --cache-dir (Not with --inline-report, --print-after or --time-passes, which run the "
+                "compiler)")
+
+            ("cache-dir,", po::value<string>(&__cacheDirPath),
+                "Dir of --cache, given alone as well (Default: $XDG_CACHE_HOME/cmm or ~/.cache/cmm)")
+
+            ("cache-size,", po::value<uint64_t>(&__cacheSize)->default_value(64),
+                "Max MiB of --cache-dir, the least recently used programs are evicted beyond it")
+
+            ("watch,", po::bool_switch(&__watchBool),
+                "Compile --input-file-path to --output-file-path again on each change of it, only generating the "
+                "changed functions with -O0 / -O1, until SIGINT / SIGTERM")
+
+            ("object,", po::bool_switch(&__objectBool),
+                "Compile --input-file-path to an object at --output-file-path, whose calls of the functions and uses "
+                "of the global vars of other files are linked by --link-file-path (-O0 / -O1)")
+
+            ("link-file-path,", po::value<vector<string>>(&__linkFilePathList)->multitoken(),
+                "Link the objects (And --input-file-path, compiled as an object first) to the asm at "
+                "--output-file-path");
 
         po::variables_map vm;
         po::store(po::parse_command_line(__Argc, __Argv, desc), vm);
@@ -79,15 +250,583 @@ private:
         }
 
         po::notify(vm);
+
+        if (__ioFormat != "text" && __ioFormat != "binary")
+        {
+            throw runtime_error("Invalid io format: " + __ioFormat);
+        }
+
+        if (__wordSize != 32 && __wordSize != 64)
+        {
+            throw runtime_error("Invalid word size: " + to_string(__wordSize));
+        }
+
+        if (__optLevel > 2)
+        {
+            throw runtime_error("Invalid opt level: " + to_string(__optLevel));
+        }
+
+        __ArrayKernel::__select(__arrayKernelName);
+
+        if (__batchBool && __streamBool)
+        {
+            throw runtime_error("Invalid --batch with --stream");
+        }
+
+        if ((__batchBool || __streamBool) && (__ioFormat != "text" || __profileBool ||
+            !__foldedStackFilePath.empty() || __perfCounterBool))
+        {
+            throw runtime_error(string("Invalid ") + (__batchBool ? "--batch" : "--stream") +
+                " with --io-format=binary, --profile, --folded-stack-file or --perf-counters");
+        }
+
+        if (!__serveSocketPath.empty() && (__batchBool || __streamBool || __ioFormat != "text" || __profileBool ||
+            !__foldedStackFilePath.empty() || __perfCounterBool || !__statsJsonPath.empty() || __traceBool))
+        {
+            throw runtime_error("Invalid --serve with --batch, --stream, --io-format=binary, --profile, "
+                "--folded-stack-file, --perf-counters, --stats-json or --trace");
+        }
+
+        if (__watchBool && (__inputFilePath.empty() || __outputFilePath.empty() || !__asmFilePath.empty() ||
+            __batchBool || __streamBool || !__serveSocketPath.empty() || !__statsJsonPath.empty() ||
+            !__linkFilePathList.empty()))
+        {
+            throw runtime_error("Invalid --watch without --input-file-path and --output-file-path, or with "
+                "--asm-file-path, --batch, --stream, --serve, --stats-json or --link-file-path");
+        }
+
+        // The const folding of the SSA passes needs the addresses of the global vars, which are linked later
+        if (__objectBool && (__inputFilePath.empty() || __outputFilePath.empty() || __optLevel > 1 ||
+            !__linkFilePathList.empty()))
+        {
+            throw runtime_error("Invalid --object without --input-file-path and --output-file-path, or with -O2 or "
+                "--link-file-path");
+        }
+
+        if (!__linkFilePathList.empty() && (__outputFilePath.empty() || __optLevel > 1 || __inlineReportBool ||
+            !__printAfterName.empty()))
+        {
+            throw runtime_error("Invalid --link-file-path without --output-file-path, or with -O2, --inline-report or "
+                "--print-after");
+        }
+
+        if (__cacheBool || !__cacheDirPath.empty())
+        {
+            __cachePtr = make_unique<__Cache>(__cacheDirPath, __cacheSize << 20);
+        }
+
+        if (__cachePtr || __watchBool)
+        {
+            __funcCachePtr = make_unique<__FuncCache>(__cachePtr.get());
+        }
+
+        if (__laneNum && ((__laneNum != 8 && __laneNum != 16) || !__batchBool || __quantum || __traceBool))
+        {
+            throw runtime_error("Invalid --lanes " + to_string(__laneNum) +
+                " (8 or 16, only with --batch, without --quantum or --trace)");
+        }
+    }
+
+
+    // Output Scheduler Stats (Nothing for a batch without a quantum)
+    template <typename VMType>
+    void __outputSchedulerStats(FILE *, const VMType &) const {}
+
+
+    // Output Scheduler Stats (The tasks of a program calling spawn, nothing if there is none)
+    template <typename... PolicyTypes>
+    void __outputSchedulerStats(FILE *fdOut, const __VM<PolicyTypes...> &vmObj) const
+    {
+        if (vmObj.__taskNum)
+        {
+            fprintf(fdOut, "        \"slices\": %lu,\n        \"steals\": %lu,\n        \"tasks\": %zu,\n"
+                "        \"parks\": %lu,\n", vmObj.__sliceCount, vmObj.__stealCount, vmObj.__taskNum,
+                vmObj.__parkCount);
+        }
+    }
+
+
+    // Output Scheduler Stats (The slices, the steals and the parks of the green threads of a stream)
+    template <typename VMType>
+    void __outputSchedulerStats(FILE *fdOut, const __Stream<VMType> &streamObj) const
+    {
+        fprintf(fdOut, "        \"slices\": %lu,\n        \"steals\": %lu,\n        \"instances\": %zu,\n"
+            "        \"parks\": %lu,\n", streamObj.__sliceCount, streamObj.__stealCount, streamObj.__instanceNum,
+            streamObj.__parkCount);
+    }
+
+
+    // Output Scheduler Stats (The slices and the steals of the green threads of a batch, the lockstep steps, the
+    // divergences and the fallbacks of its lanes)
+    template <typename VMType>
+    void __outputSchedulerStats(FILE *fdOut, const __Batch<VMType> &batchObj) const
+    {
+        if (__quantum)
+        {
+            fprintf(fdOut, "        \"slices\": %lu,\n        \"steals\": %lu,\n", batchObj.__sliceCount,
+                batchObj.__stealCount);
+        }
+
+        if (__laneNum)
+        {
+            fprintf(fdOut, "        \"lane_steps\": %lu,\n        \"lane_divergences\": %lu,\n"
+                "        \"lane_fallbacks\": %lu,\n", batchObj.__laneStepCount, batchObj.__laneDivergeCount,
+                batchObj.__laneFallbackCount);
+        }
+    }
+
+
+    /*
+        Output Stats (The schema is "cmm-stats/1", the fields are only added in the later versions):
+
+        {
+            "schema": "cmm-stats/1",
+            "compile": null | {
+                "source": str, "opt_level": int,
+                "phases_ms": {"__constructTokenList": float, ...},
+                "passes_ms": [{"name": str, "ms": float}, ...],
+                "tokens": int, "ast_nodes": int, "instructions": int,
+                "cache_hits": int, "cache_misses": int (Only with --cache, no phases / passes / tokens / AST nodes
+                for a hit),
+                "functions": int, "functions_reused": int (Only with --cache for a miss, with -O0 / -O1),
+                "wall_ms": float
+            },
+            "run": null | {
+                "asm": str, "guest_instructions": int, "calls": int, "peak_ss_depth": int,
+                "slices": int, "steals": int (Only for --batch with --quantum, --stream and a program calling spawn),
+                "instances": int (Only for --stream), "tasks": int (Only for a program calling spawn),
+                "parks": int (Only for --stream and a program calling spawn),
+                "lane_steps": int, "lane_divergences": int, "lane_fallbacks": int (Only for --batch with --lanes),
+                "wall_ms": float
+            },
+            "peak_rss_kb": int,
+            "wall_ms": float
+        }
+    */
+    template <typename VMType>
+    void __outputStats(const __Compiler &compilerObj, double compileTime, const VMType &vmObj, double runTime,
+        double wallTime) const
+    {
+        FILE *fdOut = __statsJsonPath == "-" ? stderr : fopen(__statsJsonPath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            throw runtime_error("Invalid " + __statsJsonPath);
+        }
+
+        rusage usageObj;
+        getrusage(RUSAGE_SELF, &usageObj);
+
+        fprintf(fdOut, "{\n    \"schema\": \"cmm-stats/1\",\n");
+
+        bool cacheHitBool = __cachePtr && __cachePtr->__hitCount;
+
+        if (compilerObj.__phaseTimeList.empty() && !cacheHitBool)
+        {
+            fprintf(fdOut, "    \"compile\": null,\n");
+        }
+        else
+        {
+            fprintf(fdOut, "    \"compile\": {\n        \"source\": %s,\n        \"opt_level\": %zu,\n",
+                __Util::__toJsonStr(__inputFilePath).c_str(), __optLevel);
+
+            fprintf(fdOut, "        \"phases_ms\": {");
+
+            for (size_t idx = 0; idx < compilerObj.__phaseTimeList.size(); idx++)
+            {
+                fprintf(fdOut, "%s\"%s\": %.3f", idx ? ", " : "", compilerObj.__phaseTimeList[idx].first.c_str(),
+                    compilerObj.__phaseTimeList[idx].second);
+            }
+
+            fprintf(fdOut, "},\n        \"passes_ms\": [");
+
+            for (size_t idx = 0; idx < compilerObj.__passTimeList.size(); idx++)
+            {
+                fprintf(fdOut, "%s{\"name\": \"%s\", \"ms\": %.3f}", idx ? ", " : "",
+                    get<0>(compilerObj.__passTimeList[idx]).c_str(), get<1>(compilerObj.__passTimeList[idx]));
+            }
+
+            fprintf(fdOut, "],\n        \"tokens\": %zu,\n        \"ast_nodes\": %zu,\n"
+                "        \"instructions\": %zu,\n", compilerObj.__tokenList.size(), compilerObj.__astNodeNum,
+                cacheHitBool ? __cacheInsNum : compilerObj.__objectBool ? __countInstruction(compilerObj.__asmStr) :
+                compilerObj.__codeList.size());
+
+            if (__cachePtr)
+            {
+                fprintf(fdOut, "        \"cache_hits\": %lu,\n        \"cache_misses\": %lu,\n",
+                    (unsigned long)__cachePtr->__hitCount, (unsigned long)__cachePtr->__missCount);
+            }
+
+            if (compilerObj.__funcCachePtr && !cacheHitBool)
+            {
+                fprintf(fdOut, "        \"functions\": %zu,\n        \"functions_reused\": %zu,\n",
+                    compilerObj.__funcNameList.size(), compilerObj.__reusedFuncSet.size());
+            }
+
+            fprintf(fdOut, "        \"wall_ms\": %.3f\n    },\n", compileTime);
+        }
+
+        if (__asmFilePath.empty())
+        {
+            fprintf(fdOut, "    \"run\": null,\n");
+        }
+        else
+        {
+            fprintf(fdOut, "    \"run\": {\n        \"asm\": %s,\n        \"guest_instructions\": %lu,\n"
+                "        \"calls\": %lu,\n        \"peak_ss_depth\": %zu,\n",
+                __Util::__toJsonStr(__asmFilePath).c_str(), vmObj.__insCount, vmObj.__callCount, vmObj.__maxSSSize);
+
+            __outputSchedulerStats(fdOut, vmObj);
+
+            fprintf(fdOut, "        \"wall_ms\": %.3f\n    },\n", runTime);
+        }
+
+        fprintf(fdOut, "    \"peak_rss_kb\": %ld,\n    \"wall_ms\": %.3f\n}\n", usageObj.ru_maxrss, wallTime);
+
+        if (fdOut != stderr)
+        {
+            fclose(fdOut);
+        }
+    }
+
+
+    // Run Server (Only the instantiations of --serve: Not traced, with the run statistics of each request)
+    template <typename WordT, typename BoundsPolicy, typename TracePolicy, typename ProfilePolicy>
+    void __runServer()
+    {
+        if constexpr (std::is_same_v<TracePolicy, __NoTrace> && std::is_same_v<ProfilePolicy, __StatProfile>)
+        {
+            __Server<__VM<WordT, BoundsPolicy, TracePolicy, ProfilePolicy>> serverObj(__serveSocketPath, __jobNum,
+                __fuel ? __fuel : UINT64_MAX, __inlineBudget, __optLevel, __cachePtr.get());
+
+            serverObj();
+        }
+    }
+
+
+    /*
+        Run VM: Choose the policy types of __VM from the flags one by one, then run the instantiation
+
+        WordT         <- --word-size
+        BoundsPolicy  <- --bounds-check
+        TracePolicy   <- --trace
+        ProfilePolicy <- --profile / --folded-stack-file (Full), --stats-json / --perf-counters (Stat)
+    */
+    template <typename... PolicyTypes>
+    void __runVM(const __Compiler &compilerObj, double compileTime, std::chrono::steady_clock::time_point startTime)
+    {
+        constexpr size_t policyNum = sizeof...(PolicyTypes);
+
+        if constexpr (policyNum == 0)
+        {
+            if (__wordSize == 64)
+            {
+                __runVM<int64_t>(compilerObj, compileTime, startTime);
+            }
+            else
+            {
+                __runVM<int32_t>(compilerObj, compileTime, startTime);
+            }
+        }
+        else if constexpr (policyNum == 1)
+        {
+            if (__boundsCheckBool)
+            {
+                __runVM<PolicyTypes..., __CheckedBounds>(compilerObj, compileTime, startTime);
+            }
+            else
+            {
+                __runVM<PolicyTypes..., __UncheckedBounds>(compilerObj, compileTime, startTime);
+            }
+        }
+        else if constexpr (policyNum == 2)
+        {
+            if (__traceBool)
+            {
+                __runVM<PolicyTypes..., __StderrTrace>(compilerObj, compileTime, startTime);
+            }
+            else
+            {
+                __runVM<PolicyTypes..., __NoTrace>(compilerObj, compileTime, startTime);
+            }
+        }
+        else if constexpr (policyNum == 3)
+        {
+            if (__profileBool || !__foldedStackFilePath.empty())
+            {
+                __runVM<PolicyTypes..., __FullProfile>(compilerObj, compileTime, startTime);
+            }
+            else if (!__statsJsonPath.empty() || __perfCounterBool || !__serveSocketPath.empty())
+            {
+                __runVM<PolicyTypes..., __StatProfile>(compilerObj, compileTime, startTime);
+            }
+            else
+            {
+                __runVM<PolicyTypes..., __NoProfile>(compilerObj, compileTime, startTime);
+            }
+        }
+        else if (!__serveSocketPath.empty())
+        {
+            __runServer<PolicyTypes...>();
+        }
+        else if (__batchBool)
+        {
+            auto runStartTime = std::chrono::steady_clock::now();
+
+            __Batch<__VM<PolicyTypes...>> batchObj(__asmFilePath, __ioInputFilePath, __ioOutputFilePath, __jobNum,
+                __quantum, __fuel ? __fuel : UINT64_MAX, __laneNum);
+
+            batchObj();
+
+            double runTime = __Util::__getTime(runStartTime);
+
+            if (!__statsJsonPath.empty())
+            {
+                __outputStats(compilerObj, compileTime, batchObj, runTime, __Util::__getTime(startTime));
+            }
+        }
+        else if (__streamBool)
+        {
+            auto runStartTime = std::chrono::steady_clock::now();
+
+            __Stream<__VM<PolicyTypes...>> streamObj(__asmFilePath, __ioInputFilePath, __ioOutputFilePath, __jobNum,
+                __quantum, __fuel ? __fuel : UINT64_MAX);
+
+            streamObj();
+
+            double runTime = __Util::__getTime(runStartTime);
+
+            if (!__statsJsonPath.empty())
+            {
+                __outputStats(compilerObj, compileTime, streamObj, runTime, __Util::__getTime(startTime));
+            }
+        }
+        else
+        {
+            auto runStartTime = std::chrono::steady_clock::now();
+
+            __VM<PolicyTypes...> vmObj(__asmFilePath, __ioInputFilePath, __ioOutputFilePath, __ioFormat == "binary",
+                __profileBool, __foldedStackFilePath, __sampleInterval, __sampleTimerUs, __perfCounterBool,
+                __fuel ? __fuel : UINT64_MAX, __jobNum, __quantum);
+
+            vmObj();
+
+            double runTime = __Util::__getTime(runStartTime);
+
+            if (!__statsJsonPath.empty())
+            {
+                __outputStats(compilerObj, compileTime, vmObj, runTime, __Util::__getTime(startTime));
+            }
+        }
+    }
+
+
+    // Count Instruction (The lines of an asm or an object not of the directives)
+    static size_t __countInstruction(const string &asmStr)
+    {
+        size_t insNum = 0;
+
+        for (size_t lineIdx = 0; lineIdx < asmStr.size(); lineIdx = asmStr.find('\n', lineIdx) + 1)
+        {
+            if (asmStr[lineIdx] != '.')
+            {
+                insNum++;
+            }
+        }
+
+        return insNum;
+    }
+
+
+    // Compile Cached (The asm of the cache for a hit, else the compiler's, stored to the cache)
+    void __compileCached(__Compiler &compilerObj)
+    {
+        ifstream fdIn(__inputFilePath);
+
+        if (!fdIn)
+        {
+            throw runtime_error("Invalid " + __inputFilePath);
+        }
+
+        string sourceStr, asmStr;
+
+        getline(fdIn, sourceStr, '\0');
+
+        string keyStr = __Cache::__getKey(sourceStr, __optLevel, __inlineBudget, __objectBool, __wordSize);
+
+        if (!__cachePtr->__load(keyStr, __inputFilePath, asmStr))
+        {
+            __cachePtr->__store(keyStr, compilerObj.__compileSource(sourceStr));
+            return;
+        }
+
+        __cacheInsNum = __countInstruction(asmStr);
+
+        FILE *fdOut = fopen(__outputFilePath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            throw runtime_error("Invalid " + __outputFilePath);
+        }
+
+        fwrite(asmStr.data(), 1, asmStr.size(), fdOut);
+        fclose(fdOut);
+    }
+
+
+    // Compile (From the cache if there is one)
+    void __compile(__Compiler &compilerObj)
+    {
+        // The reports of the compiler need a run of it
+        if (__cachePtr && !__inputFilePath.empty() && !__outputFilePath.empty() && !__inlineReportBool &&
+            __printAfterName.empty() && !__timePassBool)
+        {
+            __compileCached(compilerObj);
+        }
+        else
+        {
+            compilerObj();
+        }
+    }
+
+
+    // Watch Compile (A compile error is reported, then the next change is waited for)
+    void __watchCompile()
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        uint64_t hitCount = __cachePtr ? (uint64_t)__cachePtr->__hitCount : 0;
+
+        try
+        {
+            __Compiler compilerObj(__inputFilePath, __outputFilePath, __inlineBudget, __inlineReportBool, __optLevel,
+                __printAfterName, __timePassBool, __funcCachePtr.get(), __objectBool, __wordSize);
+
+            __compile(compilerObj);
+
+            fprintf(stderr, "Compiled %s in %.3f ms ", __inputFilePath.c_str(), __Util::__getTime(startTime));
+
+            if (__cachePtr && __cachePtr->__hitCount != hitCount)
+            {
+                fprintf(stderr, "(Cache hit)\n");
+            }
+            else if (compilerObj.__funcCachePtr)
+            {
+                fprintf(stderr, "(%zu functions, %zu reused)\n", compilerObj.__funcNameList.size(),
+                    compilerObj.__reusedFuncSet.size());
+            }
+            else
+            {
+                fprintf(stderr, "(%zu functions)\n", compilerObj.__funcNameList.size());
+            }
+        }
+        catch (const std::exception &errObj)
+        {
+            fprintf(stderr, "Error: %s\n", errObj.what());
+        }
+    }
+
+
+    // Watch (The dir of the input file is watched, as an editor may replace the file by a rename)
+    void __watch()
+    {
+        auto slashIdx = __inputFilePath.rfind('/');
+        string dirPath = slashIdx == string::npos ? "." : __inputFilePath.substr(0, slashIdx + 1);
+        string fileName = __inputFilePath.substr(slashIdx == string::npos ? 0 : slashIdx + 1);
+        int inotifyFd = inotify_init1(IN_CLOEXEC);
+
+        if (inotifyFd < 0 || inotify_add_watch(inotifyFd, dirPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            throw runtime_error("Invalid --watch of " + dirPath);
+        }
+
+        pollfd pollObj {inotifyFd, POLLIN, 0};
+
+        for (;;)
+        {
+            __watchCompile();
+
+            // A save may be many events: They are drained until the dir is quiet for a while
+            for (bool changeBool = false; !changeBool || poll(&pollObj, 1, __WATCH_QUIET_MS) > 0;)
+            {
+                alignas(inotify_event) char eventBuffer[4096];
+                ssize_t readSize = read(inotifyFd, eventBuffer, sizeof(eventBuffer));
+
+                if (readSize < 0 && errno != EINTR)
+                {
+                    throw runtime_error("Invalid --watch of " + dirPath);
+                }
+
+                for (ssize_t eventIdx = 0; eventIdx < readSize;)
+                {
+                    auto eventPtr = (const inotify_event *)(eventBuffer + eventIdx);
+
+                    if (eventPtr->len && fileName == eventPtr->name)
+                    {
+                        changeBool = true;
+                    }
+
+                    eventIdx += sizeof(inotify_event) + eventPtr->len;
+                }
+            }
+        }
+    }
+
+
+    // Link (--input-file-path is compiled as an object in memory, then linked first)
+    void __link()
+    {
+        __Linker linkerObj(__linkFilePathList, __outputFilePath);
+
+        if (!__inputFilePath.empty())
+        {
+            ifstream fdIn(__inputFilePath);
+            string sourceStr;
+
+            if (!fdIn)
+            {
+                throw runtime_error("Invalid " + __inputFilePath);
+            }
+
+            getline(fdIn, sourceStr, '\0');
+
+            __Compiler compilerObj(__inputFilePath, "", __inlineBudget, false, __optLevel, "", __timePassBool,
+                nullptr, true);
+
+            linkerObj.__addObject(compilerObj.__compileSource(sourceStr), __inputFilePath);
+        }
+
+        linkerObj();
     }
 
 
     // Main
     void __main()
     {
+        auto startTime = std::chrono::steady_clock::now();
+
         __constructArgument();
-        __Compiler(__inputFilePath, __outputFilePath)();
-        (__VM(__asmFilePath))();
+
+        if (__watchBool)
+        {
+            __watch();
+            return;
+        }
+
+        // A link runs the linker instead of the compiler (See __link)
+        __Compiler compilerObj(__linkFilePathList.empty() ? __inputFilePath : "", __outputFilePath, __inlineBudget,
+            __inlineReportBool, __optLevel, __printAfterName, __timePassBool, __funcCachePtr.get(), __objectBool,
+            __wordSize);
+
+        if (__linkFilePathList.empty())
+        {
+            __compile(compilerObj);
+        }
+        else
+        {
+            __link();
+        }
+
+        __runVM(compilerObj, __Util::__getTime(startTime), startTime);
     }
 };
 
@@ -0,0 +1,954 @@
+/*
+    LaneVM.hpp
+    ==========
+        Class template __LaneVM implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include "Code.hpp"
+#include "Context.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::unordered_map;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __LaneVM
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Run a program over LaneNum batch records at once (SPMD): the lanes share the instruction and the control state
+    (IP, BP, SS size), and AX, each SS slot and each RS register hold a word per lane (The slot K of the lane L is
+    __SS[K * LaneNum + L]), so an instruction is a loop over the lanes, vectorized by the compiler.
+
+    The lanes at the same (IP, BP, SS size) are a group. A "jz" with a mixed condition (Or a "ret" to different call
+    sites) splits the running group, and the other groups wait. The running group is always the deepest one (The max
+    BP), then the one with the min IP, so the groups of an if / while merge again at its end (The MinSP-PC policy).
+
+    Once the lanes diverge too far (Too many groups, or too few lanes per step), the groups stop waiting for each other
+    and each one runs to its end. Whatever the lockstep run can not do as the scalar VM (An instruction it does not
+    know, a runtime error of a lane or a lane out of fuel) moves each lane into its context before the instruction and
+    runs it on the scalar VM from there, so the results are always the same as a scalar run.
+*/
+template <typename VMType, size_t LaneNum>
+class __LaneVM
+{
+    // Friend
+    friend class __Kernel;
+
+    template <typename>
+    friend class __Batch;
+
+
+public:
+
+    // The context type of the records it runs
+    using __ContextType = typename VMType::__ContextType;
+
+
+    // Constructor
+    explicit __LaneVM(const shared_ptr<const __Code> &codePtr):
+        __codePtr(codePtr),
+        __vm     (codePtr)
+    {
+        __decode();
+    }
+
+
+private:
+
+    using WordT     = typename VMType::__WordType;
+    using __MaskType = uint64_t;
+
+    static_assert(LaneNum >= 2 && LaneNum <= 64, "Invalid lane number");
+
+    // All the lanes
+    static constexpr __MaskType __FULL_MASK = LaneNum == 64 ? ~(__MaskType)0 : ((__MaskType)1 << LaneNum) - 1;
+
+    // The groups stop merging with more groups than this
+    static constexpr size_t __MAX_GROUP_NUM = LaneNum / 2;
+
+    // Or with less lanes per step than this on average, after __MIN_STEP_NUM steps
+    static constexpr uint64_t __MIN_LANE_NUM = 2;
+    static constexpr uint64_t __MIN_STEP_NUM = 1 << 12;
+
+
+    // The instructions of the lockstep run (__Scalar: Any other one, run by the scalar VM)
+    enum class __OpType
+    {
+        __Ldc, __Ld, __Ald, __St, __Ast, __Push, __Pop, __Jmp, __Jz,
+        __Add, __Sub, __Mul, __Div, __Lt, __Le, __Gt, __Ge, __Eq, __Ne,
+        __In, __Out, __Lea, __Call, __Sr, __Lr, __Tailcall, __Ret, __Scalar,
+    };
+
+
+    // A decoded instruction
+    struct __LaneInstruction
+    {
+        __OpType __opType;
+        int64_t __immVal;
+    };
+
+
+    // The lanes at the same control state
+    struct __LaneGroup
+    {
+        __MaskType __mask;
+        size_t __IP;
+        int64_t __BP;
+        size_t __SSSize;
+    };
+
+
+    // Attribute
+    shared_ptr<const __Code> __codePtr;
+    vector<__LaneInstruction> __insList;
+
+    // The scalar VM of the fallback
+    VMType __vm;
+
+    // The contexts of the records (nullptr for a lane without a record), for the I/O and the fallback
+    __ContextType *__ctxList[LaneNum];
+
+    // The words of all the lanes
+    vector<WordT> __SS;
+    WordT __AX[LaneNum];
+    vector<WordT> __RS;
+
+    // The AX of the running lanes is the same one (After a "ldc" or a "lea"), so a "ld" / "st" reads a whole slot
+    bool __uniformBool = false;
+    WordT __uniformVal = 0;
+
+    // The running group and the waiting ones
+    __LaneGroup __curGroup;
+    vector<__LaneGroup> __waitList;
+
+    // The min IP of the waiting groups in the same frame after the running one (Where it may merge with them)
+    size_t __syncIP = SIZE_MAX;
+
+    // The groups run to their ends without merging
+    bool __divergeBool = false;
+
+    // The steps of the running group, and the max steps before a lane of it is out of fuel
+    uint64_t __groupStep = 0;
+    uint64_t __stepLimit = UINT64_MAX;
+
+    // The executed instructions of each lane
+    uint64_t __laneInsList[LaneNum];
+
+    // The steps and the executed lane instructions of the current records
+    uint64_t __recordStepNum = 0;
+    uint64_t __recordInsNum = 0;
+
+    // Run statistics (The same names as the __VM ones, the steps, the divergences and the fallbacks are only of the
+    // lockstep run)
+    uint64_t __insCount = 0;
+    uint64_t __callCount = 0;
+    size_t __maxSSSize = 0;
+    uint64_t __stepCount = 0;
+    uint64_t __divergeCount = 0;
+    uint64_t __fallbackCount = 0;
+
+
+    // Decode (The instruction strings of the code)
+    void __decode()
+    {
+        static const unordered_map<string, __OpType> opTypeMap {
+            {"ldc", __OpType::__Ldc}, {"ld", __OpType::__Ld}, {"ald", __OpType::__Ald}, {"st", __OpType::__St},
+            {"ast", __OpType::__Ast}, {"push", __OpType::__Push}, {"pop", __OpType::__Pop},
+            {"jmp", __OpType::__Jmp}, {"jz", __OpType::__Jz}, {"add", __OpType::__Add}, {"sub", __OpType::__Sub},
+            {"mul", __OpType::__Mul}, {"div", __OpType::__Div}, {"lt", __OpType::__Lt}, {"le", __OpType::__Le},
+            {"gt", __OpType::__Gt}, {"ge", __OpType::__Ge}, {"eq", __OpType::__Eq}, {"ne", __OpType::__Ne},
+            {"in", __OpType::__In}, {"out", __OpType::__Out}, {"lea", __OpType::__Lea}, {"call", __OpType::__Call},
+            {"sr", __OpType::__Sr}, {"lr", __OpType::__Lr}, {"tailcall", __OpType::__Tailcall},
+            {"ret", __OpType::__Ret},
+        };
+
+        for (auto &insStr: __codePtr->__CS)
+        {
+            size_t spaceIdx = insStr.find(' ');
+            auto opIter = opTypeMap.find(insStr.substr(0, spaceIdx));
+
+            if (opIter == opTypeMap.end())
+            {
+                __insList.push_back({__OpType::__Scalar, 0});
+            }
+            else
+            {
+                __insList.push_back({opIter->second, spaceIdx == string::npos ? 0 : stoll(insStr.substr(spaceIdx + 1))});
+            }
+        }
+    }
+
+
+    // For Each Lane (Of mask: A plain loop for all the lanes, so the compiler can vectorize it)
+    template <typename FuncT>
+    static void __forEachLane(__MaskType mask, FuncT &&laneFunc)
+    {
+        if (mask == __FULL_MASK)
+        {
+            for (size_t laneIdx = 0; laneIdx < LaneNum; laneIdx++)
+            {
+                laneFunc(laneIdx);
+            }
+        }
+        else
+        {
+            for (; mask; mask &= mask - 1)
+            {
+                laneFunc(__builtin_ctzll(mask));
+            }
+        }
+    }
+
+
+    // Reserve Slot (The SS has at least slotNum slots)
+    void __reserveSlot(size_t slotNum)
+    {
+        if (__SS.size() < slotNum * LaneNum)
+        {
+            __SS.resize(std::max(slotNum, __SS.size() / LaneNum * 2) * LaneNum);
+        }
+
+        __maxSSSize = std::max(__maxSSSize, slotNum);
+    }
+
+
+    // Start Group (__curGroup starts to run)
+    void __startGroup()
+    {
+        __groupStep = 0;
+        __stepLimit = UINT64_MAX;
+        __uniformBool = false;
+
+        __forEachLane(__curGroup.__mask, [this](size_t laneIdx)
+        {
+            if (__ctxList[laneIdx]->__fuel != UINT64_MAX)
+            {
+                __stepLimit = std::min(__stepLimit, __ctxList[laneIdx]->__fuel - __laneInsList[laneIdx]);
+            }
+        });
+
+        __computeSyncIP();
+    }
+
+
+    // Compute __syncIP (A waiting group at the same IP is only counted if the running one can merge with it)
+    void __computeSyncIP()
+    {
+        __syncIP = SIZE_MAX;
+
+        if (__divergeBool)
+        {
+            return;
+        }
+
+        for (auto &groupObj: __waitList)
+        {
+            if (groupObj.__BP == __curGroup.__BP && (groupObj.__IP > __curGroup.__IP ||
+                (groupObj.__IP == __curGroup.__IP && groupObj.__SSSize == __curGroup.__SSSize)))
+            {
+                __syncIP = std::min(__syncIP, groupObj.__IP);
+            }
+        }
+    }
+
+
+    // Flush Group (The steps of __curGroup are counted to its lanes)
+    void __flushGroup()
+    {
+        __forEachLane(__curGroup.__mask, [this](size_t laneIdx)
+        {
+            __laneInsList[laneIdx] += __groupStep;
+        });
+
+        __recordStepNum += __groupStep;
+        __recordInsNum  += __groupStep * __builtin_popcountll(__curGroup.__mask);
+        __groupStep = 0;
+    }
+
+
+    // Switch Group (The deepest waiting group, then the one with the min IP, and the ones it merges with, runs)
+    bool __switchGroup()
+    {
+        if (__waitList.empty())
+        {
+            return false;
+        }
+
+        size_t bestIdx = 0;
+
+        for (size_t groupIdx = 1; groupIdx < __waitList.size(); groupIdx++)
+        {
+            auto &groupObj = __waitList[groupIdx], &bestObj = __waitList[bestIdx];
+
+            if (groupObj.__BP > bestObj.__BP || (groupObj.__BP == bestObj.__BP && groupObj.__IP < bestObj.__IP))
+            {
+                bestIdx = groupIdx;
+            }
+        }
+
+        __curGroup = __waitList[bestIdx];
+        __waitList[bestIdx] = __waitList.back();
+        __waitList.pop_back();
+
+        for (size_t groupIdx = 0; groupIdx < __waitList.size();)
+        {
+            auto &groupObj = __waitList[groupIdx];
+
+            if (groupObj.__IP == __curGroup.__IP && groupObj.__BP == __curGroup.__BP &&
+                groupObj.__SSSize == __curGroup.__SSSize)
+            {
+                __curGroup.__mask |= groupObj.__mask;
+                groupObj = __waitList.back();
+                __waitList.pop_back();
+            }
+            else
+            {
+                groupIdx++;
+            }
+        }
+
+        __startGroup();
+
+        return true;
+    }
+
+
+    // Is Divergent (The groups should run to their ends)
+    bool __isDivergent() const
+    {
+        return !__divergeBool && (__waitList.size() >= __MAX_GROUP_NUM ||
+            (__recordStepNum >= __MIN_STEP_NUM && __recordInsNum < __recordStepNum * __MIN_LANE_NUM));
+    }
+
+
+    // Split Group (The lanes of __curGroup go to the IP / BP of each one, after its instruction)
+    template <typename FuncT>
+    void __splitGroup(FuncT &&getTarget)
+    {
+        __groupStep++;
+        __flushGroup();
+
+        size_t firstIdx = __waitList.size();
+
+        __forEachLane(__curGroup.__mask, [&](size_t laneIdx)
+        {
+            auto [IP, BP] = getTarget(laneIdx);
+            size_t groupIdx = firstIdx;
+
+            while (groupIdx < __waitList.size() && (__waitList[groupIdx].__IP != IP || __waitList[groupIdx].__BP != BP))
+            {
+                groupIdx++;
+            }
+
+            if (groupIdx == __waitList.size())
+            {
+                __waitList.push_back({0, IP, BP, __curGroup.__SSSize});
+            }
+
+            __waitList[groupIdx].__mask |= (__MaskType)1 << laneIdx;
+        });
+
+        __switchGroup();
+    }
+
+
+    // Check Slot (Every lane of the running group has the slot of the word in its SS)
+    template <typename FuncT>
+    bool __checkSlot(FuncT &&getSlot) const
+    {
+        bool validBool = true;
+        int64_t SSSize = __curGroup.__SSSize;
+
+        __forEachLane(__curGroup.__mask, [&](size_t laneIdx)
+        {
+            int64_t slotIdx = getSlot(laneIdx);
+
+            validBool &= slotIdx >= 0 && slotIdx < SSSize;
+        });
+
+        return validBool;
+    }
+
+
+    // Load (AX = The word of the slot of each lane, slot = baseIdx + signVal * AX)
+    bool __load(int64_t baseIdx, int64_t signVal)
+    {
+        auto &groupObj = __curGroup;
+        WordT *SSPtr = __SS.data();
+
+        if (__uniformBool)
+        {
+            int64_t slotIdx = baseIdx + signVal * __uniformVal;
+
+            if (slotIdx < 0 || slotIdx >= (int64_t)groupObj.__SSSize)
+            {
+                return false;
+            }
+
+            WordT *slotPtr = SSPtr + slotIdx * LaneNum;
+
+            __forEachLane(groupObj.__mask, [&](size_t laneIdx) { __AX[laneIdx] = slotPtr[laneIdx]; });
+        }
+        else
+        {
+            if (!__checkSlot([&](size_t laneIdx) { return baseIdx + signVal * __AX[laneIdx]; }))
+            {
+                return false;
+            }
+
+            __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+            {
+                __AX[laneIdx] = SSPtr[(baseIdx + signVal * __AX[laneIdx]) * LaneNum + laneIdx];
+            });
+        }
+
+        __uniformBool = false;
+
+        return true;
+    }
+
+
+    // Store (The slot of each lane = The SS top, slot = baseIdx + signVal * AX)
+    bool __store(int64_t baseIdx, int64_t signVal)
+    {
+        auto &groupObj = __curGroup;
+        WordT *SSPtr = __SS.data();
+
+        if (!groupObj.__SSSize)
+        {
+            return false;
+        }
+
+        WordT *topPtr = SSPtr + (groupObj.__SSSize - 1) * LaneNum;
+
+        if (__uniformBool)
+        {
+            int64_t slotIdx = baseIdx + signVal * __uniformVal;
+
+            if (slotIdx < 0 || slotIdx >= (int64_t)groupObj.__SSSize)
+            {
+                return false;
+            }
+
+            WordT *slotPtr = SSPtr + slotIdx * LaneNum;
+
+            __forEachLane(groupObj.__mask, [&](size_t laneIdx) { slotPtr[laneIdx] = topPtr[laneIdx]; });
+        }
+        else
+        {
+            if (!__checkSlot([&](size_t laneIdx) { return baseIdx + signVal * __AX[laneIdx]; }))
+            {
+                return false;
+            }
+
+            __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+            {
+                SSPtr[(baseIdx + signVal * __AX[laneIdx]) * LaneNum + laneIdx] = topPtr[laneIdx];
+            });
+        }
+
+        return true;
+    }
+
+
+    // Bin Op (AX = The SS top op AX)
+    template <typename FuncT>
+    bool __binOp(FuncT &&opFunc)
+    {
+        if (!__curGroup.__SSSize)
+        {
+            return false;
+        }
+
+        WordT *topPtr = __SS.data() + (__curGroup.__SSSize - 1) * LaneNum;
+
+        __forEachLane(__curGroup.__mask, [&](size_t laneIdx)
+        {
+            __AX[laneIdx] = opFunc(topPtr[laneIdx], __AX[laneIdx]);
+        });
+
+        __uniformBool = false;
+
+        return true;
+    }
+
+
+    // Set AX (To the same word for each lane)
+    void __setAX(WordT wordVal)
+    {
+        __forEachLane(__curGroup.__mask, [&](size_t laneIdx) { __AX[laneIdx] = wordVal; });
+
+        __uniformBool = true;
+        __uniformVal  = wordVal;
+    }
+
+
+    // Step (Exec the instruction of __curGroup, false to fall back before it)
+    bool __step(const __LaneInstruction &insObj)
+    {
+        auto &groupObj = __curGroup;
+
+        switch (insObj.__opType)
+        {
+            case __OpType::__Ldc:
+                __setAX(insObj.__immVal);
+                break;
+
+            case __OpType::__Ld:
+                if (!__load(groupObj.__BP, -1))
+                {
+                    return false;
+                }
+
+                break;
+
+            case __OpType::__Ald:
+                if (!__load(0, 1))
+                {
+                    return false;
+                }
+
+                break;
+
+            case __OpType::__St:
+                if (!__store(groupObj.__BP, -1))
+                {
+                    return false;
+                }
+
+                break;
+
+            case __OpType::__Ast:
+                if (!__store(0, 1))
+                {
+                    return false;
+                }
+
+                break;
+
+            case __OpType::__Push:
+            {
+                __reserveSlot(groupObj.__SSSize + 1);
+
+                WordT *slotPtr = __SS.data() + groupObj.__SSSize * LaneNum;
+
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx) { slotPtr[laneIdx] = __AX[laneIdx]; });
+                groupObj.__SSSize++;
+
+                break;
+            }
+
+            case __OpType::__Pop:
+                if (!groupObj.__SSSize)
+                {
+                    return false;
+                }
+
+                groupObj.__SSSize--;
+                break;
+
+            case __OpType::__Jmp:
+                groupObj.__IP += insObj.__immVal;
+                __groupStep++;
+
+                return true;
+
+            case __OpType::__Jz:
+            {
+                __MaskType zeroMask = 0;
+
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+                {
+                    zeroMask |= (__MaskType)!__AX[laneIdx] << laneIdx;
+                });
+
+                if (zeroMask == groupObj.__mask)
+                {
+                    groupObj.__IP += insObj.__immVal;
+                    __groupStep++;
+
+                    return true;
+                }
+
+                if (zeroMask)
+                {
+                    size_t IP = groupObj.__IP;
+
+                    __splitGroup([&](size_t laneIdx)
+                    {
+                        return std::make_pair(zeroMask >> laneIdx & 1 ? IP + insObj.__immVal : IP + 1, groupObj.__BP);
+                    });
+
+                    return true;
+                }
+
+                break;
+            }
+
+            case __OpType::__Add:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal + rhsVal); }) && __next();
+
+            case __OpType::__Sub:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal - rhsVal); }) && __next();
+
+            case __OpType::__Mul:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal * rhsVal); }) && __next();
+
+            case __OpType::__Div:
+            {
+                bool zeroBool = false;
+
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx) { zeroBool |= !__AX[laneIdx]; });
+
+                // The scalar VM reports the division by zero of the lane
+                if (zeroBool)
+                {
+                    return false;
+                }
+
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal / rhsVal); }) && __next();
+            }
+
+            case __OpType::__Lt:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal < rhsVal); }) && __next();
+
+            case __OpType::__Le:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal <= rhsVal); }) && __next();
+
+            case __OpType::__Gt:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal > rhsVal); }) && __next();
+
+            case __OpType::__Ge:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal >= rhsVal); }) && __next();
+
+            case __OpType::__Eq:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal == rhsVal); }) && __next();
+
+            case __OpType::__Ne:
+                return __binOp([](WordT lhsVal, WordT rhsVal) { return (WordT)(lhsVal != rhsVal); }) && __next();
+
+            case __OpType::__In:
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+                {
+                    __ctxList[laneIdx]->__io.__readInt(__AX[laneIdx]);
+                });
+
+                __uniformBool = false;
+                break;
+
+            case __OpType::__Out:
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+                {
+                    __ctxList[laneIdx]->__io.__writeInt(__AX[laneIdx]);
+                });
+
+                break;
+
+            case __OpType::__Lea:
+                __setAX(groupObj.__SSSize - insObj.__immVal);
+                break;
+
+            case __OpType::__Call:
+            {
+                // The same frame as the scalar VM: ... Param0 OldBP OldIP, BP is at Param0
+                __reserveSlot(groupObj.__SSSize + 2);
+
+                WordT *slotPtr = __SS.data() + groupObj.__SSSize * LaneNum;
+                WordT BP = groupObj.__BP, IP = groupObj.__IP;
+
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+                {
+                    slotPtr[laneIdx] = BP;
+                    slotPtr[LaneNum + laneIdx] = IP;
+                });
+
+                groupObj.__BP = groupObj.__SSSize - 1;
+                groupObj.__SSSize += 2;
+                groupObj.__IP += insObj.__immVal;
+                __groupStep++;
+                __callCount += __builtin_popcountll(groupObj.__mask);
+                __computeSyncIP();
+
+                return true;
+            }
+
+            case __OpType::__Sr:
+            case __OpType::__Lr:
+            {
+                if (insObj.__immVal < 0 || (size_t)insObj.__immVal * LaneNum >= __RS.size())
+                {
+                    return false;
+                }
+
+                WordT *regPtr = __RS.data() + insObj.__immVal * LaneNum;
+
+                if (insObj.__opType == __OpType::__Sr)
+                {
+                    __forEachLane(groupObj.__mask, [&](size_t laneIdx) { regPtr[laneIdx] = __AX[laneIdx]; });
+                }
+                else
+                {
+                    __forEachLane(groupObj.__mask, [&](size_t laneIdx) { __AX[laneIdx] = regPtr[laneIdx]; });
+                    __uniformBool = false;
+                }
+
+                break;
+            }
+
+            case __OpType::__Tailcall:
+            {
+                // Move the new frame (Above the OldBP and the OldIP) to the current frame
+                int64_t frameSize = (int64_t)groupObj.__SSSize - groupObj.__BP - 3;
+
+                if (frameSize < 0 || groupObj.__BP - frameSize + 1 < 0)
+                {
+                    return false;
+                }
+
+                WordT *SSPtr = __SS.data();
+
+                for (int64_t idx = 0; idx < frameSize; idx++)
+                {
+                    WordT *dstPtr = SSPtr + (groupObj.__BP - idx) * LaneNum;
+                    WordT *srcPtr = SSPtr + (groupObj.__SSSize - idx - 1) * LaneNum;
+
+                    __forEachLane(groupObj.__mask, [&](size_t laneIdx) { dstPtr[laneIdx] = srcPtr[laneIdx]; });
+                }
+
+                groupObj.__SSSize = groupObj.__BP + 3;
+                groupObj.__IP += insObj.__immVal;
+                __groupStep++;
+                __callCount += __builtin_popcountll(groupObj.__mask);
+
+                return true;
+            }
+
+            case __OpType::__Ret:
+            {
+                if (groupObj.__SSSize < 2)
+                {
+                    return false;
+                }
+
+                WordT *IPPtr = __SS.data() + (groupObj.__SSSize - 1) * LaneNum;
+                WordT *BPPtr = IPPtr - LaneNum;
+                size_t firstIdx = __builtin_ctzll(groupObj.__mask);
+                bool uniformBool = true;
+
+                __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+                {
+                    uniformBool &= IPPtr[laneIdx] == IPPtr[firstIdx] && BPPtr[laneIdx] == BPPtr[firstIdx];
+                });
+
+                groupObj.__SSSize -= 2;
+
+                if (!uniformBool)
+                {
+                    __splitGroup([&](size_t laneIdx)
+                    {
+                        return std::make_pair((size_t)IPPtr[laneIdx] + 1, (int64_t)BPPtr[laneIdx]);
+                    });
+
+                    return true;
+                }
+
+                groupObj.__IP = IPPtr[firstIdx] + 1;
+                groupObj.__BP = BPPtr[firstIdx];
+                __groupStep++;
+
+                // A waiting group may be deeper now
+                if (!__waitList.empty() && !__divergeBool)
+                {
+                    __flushGroup();
+                    __waitList.push_back(groupObj);
+                    __switchGroup();
+                }
+
+                return true;
+            }
+
+            default:
+                return false;
+        }
+
+        return __next();
+    }
+
+
+    // Next (The running group goes on to the next instruction)
+    bool __next()
+    {
+        __curGroup.__IP++;
+        __groupStep++;
+
+        return true;
+    }
+
+
+    // Run (The lockstep run of all the lanes, false if they must fall back to the scalar VM)
+    bool __run()
+    {
+        size_t insNum = __insList.size();
+
+        while (true)
+        {
+            auto &groupObj = __curGroup;
+
+            // The lanes of the group are finished
+            if (groupObj.__IP >= insNum)
+            {
+                __flushGroup();
+
+                if (!__switchGroup())
+                {
+                    return true;
+                }
+            }
+            // The group reaches a waiting one, which may run first or merge with it
+            else if (groupObj.__IP >= __syncIP)
+            {
+                __flushGroup();
+                __waitList.push_back(groupObj);
+                __switchGroup();
+            }
+            // A lane is out of fuel (The scalar VM reports it)
+            else if (__groupStep == __stepLimit)
+            {
+                return false;
+            }
+            else
+            {
+                size_t groupNum = __waitList.size();
+
+                if (!__step(__insList[groupObj.__IP]))
+                {
+                    return false;
+                }
+
+                if (__waitList.size() == groupNum)
+                {
+                    continue;
+                }
+            }
+
+            if (__isDivergent())
+            {
+                __divergeBool = true;
+                __syncIP = SIZE_MAX;
+                __divergeCount++;
+            }
+        }
+    }
+
+
+    // Fall Back (Each lane of each group runs to the end on the scalar VM, from its context)
+    void __fallBack(vector<string> &errorList)
+    {
+        __flushGroup();
+        __waitList.push_back(__curGroup);
+        __fallbackCount++;
+
+        for (auto &groupObj: __waitList)
+        {
+            __forEachLane(groupObj.__mask, [&](size_t laneIdx)
+            {
+                auto &ctxObj = *__ctxList[laneIdx];
+
+                ctxObj.__IP = groupObj.__IP;
+                ctxObj.__BP = groupObj.__BP;
+                ctxObj.__AX = __AX[laneIdx];
+
+                // All the slots of the lane (Then the SS size), as an unchecked access past the SS top is in its
+                // capacity, the same as a reused scalar context
+                ctxObj.__SS.resize(__SS.size() / LaneNum);
+
+                for (size_t slotIdx = 0; slotIdx < ctxObj.__SS.size(); slotIdx++)
+                {
+                    ctxObj.__SS[slotIdx] = __SS[slotIdx * LaneNum + laneIdx];
+                }
+
+                ctxObj.__SS.resize(groupObj.__SSSize);
+
+                for (size_t regIdx = 0; regIdx < ctxObj.__RS.size(); regIdx++)
+                {
+                    ctxObj.__RS[regIdx] = __RS[regIdx * LaneNum + laneIdx];
+                }
+
+                if (ctxObj.__fuel != UINT64_MAX)
+                {
+                    ctxObj.__fuel -= __laneInsList[laneIdx];
+                }
+
+                try
+                {
+                    __vm.__execAll(ctxObj);
+                }
+                catch (const runtime_error &errObj)
+                {
+                    errorList[laneIdx] = errObj.what();
+                }
+            });
+        }
+
+        __waitList.clear();
+    }
+
+
+    // Exec All (The started contexts of at most LaneNum records to the end, the error of each one to errorList)
+    void __execAll(const vector<__ContextType *> &ctxPtrList, vector<string> &errorList)
+    {
+        __MaskType liveMask = 0;
+
+        for (size_t laneIdx = 0; laneIdx < LaneNum; laneIdx++)
+        {
+            __ctxList[laneIdx] = laneIdx < ctxPtrList.size() ? ctxPtrList[laneIdx] : nullptr;
+            __AX[laneIdx] = 0;
+            __laneInsList[laneIdx] = 0;
+
+            if (__ctxList[laneIdx])
+            {
+                liveMask |= (__MaskType)1 << laneIdx;
+            }
+        }
+
+        __RS.assign(__codePtr->__RSSize * LaneNum, 0);
+        __waitList.clear();
+        __curGroup = {liveMask, 0, 0, 0};
+        __recordStepNum = 0;
+        __recordInsNum = 0;
+        __divergeBool = false;
+
+        __startGroup();
+
+        if (liveMask && !__run())
+        {
+            __fallBack(errorList);
+        }
+
+        __insCount += __recordInsNum;
+        __stepCount += __recordStepNum;
+    }
+};
+
+
+}  // End namespace CMM
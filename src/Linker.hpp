@@ -0,0 +1,486 @@
+/*
+    Linker.hpp
+    ==========
+        Class __Linker implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstdio>
+#include "Compiler.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::tuple;
+using std::pair;
+using std::ifstream;
+using std::istringstream;
+using std::get;
+using std::sort;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __Linker
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Link the objects of --object (See __Compiler::__outputObject) to an asm file, the same as the compile of the whole
+    program:
+
+    1. The global vars of the objects are laid out one object after another, so "@Name" is the base of its object
+       plus its var number, and the global code pushes them all, then calls the "main" function (Of exactly one object)
+    2. A call of a function of the same object is kept, a call of an import is translated to its export
+    3. The functions unreachable from the global code are removed, then the "main" function is put last, and the call
+       targets are translated to the relative IPs (See __Compiler::__layoutCode)
+
+    The line table has a ".file" per object, and each ".line" belongs to the last ".file" before it.
+*/
+class __Linker
+{
+    // Friend
+    friend class __Kernel;
+
+
+public:
+
+    // Constructor
+    explicit __Linker(const vector<string> &objectFilePathList, const string &outputFilePath):
+        __objectFilePathList(objectFilePathList),
+        __outputFilePath    (outputFilePath) {}
+
+
+    // Add Object (An object text in memory, linked before the object files)
+    void __addObject(const string &objectStr, const string &objectName)
+    {
+        __parseObject(objectStr, objectName);
+    }
+
+
+    // operator()
+    void operator()()
+    {
+        __main();
+    }
+
+
+private:
+
+    // An object
+    struct __Object
+    {
+        string __filePath;
+
+        // (Name, Var number, Array size) of the global vars, and the base address of them
+        vector<tuple<string, size_t, size_t>> __globalList;
+        size_t __globalBase;
+
+        vector<string> __externList;
+        vector<pair<string, size_t>> __importList;
+
+        // (Name, Param number, The function or its wrapper) of the exported functions
+        vector<tuple<string, size_t, string>> __exportList;
+
+        // (Name, Code) of the functions in order
+        vector<pair<string, vector<__Instruction>>> __funcList;
+    };
+
+
+    // Attribute
+    vector<string> __objectFilePathList;
+    string __outputFilePath;
+    vector<__Object> __objectList;
+
+    // Global var name -> (Address, Array size)
+    unordered_map<string, pair<size_t, size_t>> __globalMap;
+    size_t __globalNum = 0;
+
+    // Exported function name -> (Param number, The function or its wrapper, Object index)
+    unordered_map<string, tuple<size_t, string, size_t>> __exportMap;
+
+    // Function name -> (Code, Object index) of all the objects, and the names in order
+    unordered_map<string, pair<vector<__Instruction>, size_t>> __codeMap;
+    vector<string> __funcNameList;
+
+    // The linked code and the object index of each IP
+    vector<__Instruction> __codeList;
+    vector<size_t> __objectIdxList;
+    vector<pair<string, size_t>> __funcLayoutList;
+    string __asmStr;
+
+
+    // Parse Object
+    void __parseObject(const string &objectStr, const string &objectName)
+    {
+        istringstream fdIn(objectStr);
+        string line;
+
+        if (!getline(fdIn, line) || line != ".object " + string(__Compiler::__OBJECT_VERSION))
+        {
+            throw runtime_error("Invalid object " + objectName);
+        }
+
+        __Object objectObj {objectName, {}, 0, {}, {}, {}, {}};
+
+        while (getline(fdIn, line))
+        {
+            istringstream lineStream(line);
+            string directiveStr, nameStr;
+
+            lineStream >> directiveStr >> nameStr;
+
+            if (directiveStr == ".file")
+            {
+                objectObj.__filePath = line.substr(6);
+            }
+            else if (directiveStr == ".global")
+            {
+                size_t varIdx, varSize;
+
+                lineStream >> varIdx >> varSize;
+                objectObj.__globalList.emplace_back(nameStr, varIdx, varSize);
+            }
+            else if (directiveStr == ".extern")
+            {
+                objectObj.__externList.push_back(nameStr);
+            }
+            else if (directiveStr == ".import")
+            {
+                size_t paramNum;
+
+                lineStream >> paramNum;
+                objectObj.__importList.emplace_back(nameStr, paramNum);
+            }
+            else if (directiveStr == ".export")
+            {
+                size_t paramNum;
+                string targetName;
+
+                lineStream >> paramNum >> targetName;
+                objectObj.__exportList.emplace_back(nameStr, paramNum, targetName);
+            }
+            else if (directiveStr == ".func")
+            {
+                size_t insNum;
+                string codeStr;
+
+                lineStream >> insNum;
+
+                for (size_t _ = 0; _ < insNum && getline(fdIn, line); _++)
+                {
+                    codeStr += line + "\n";
+                }
+
+                objectObj.__funcList.emplace_back(nameStr, __Compiler::__fromFuncCodeStr(codeStr, 0));
+
+                if (objectObj.__funcList.back().second.size() != insNum)
+                {
+                    throw runtime_error("Invalid object " + objectName + " (Function " + nameStr + ")");
+                }
+            }
+            else
+            {
+                throw runtime_error("Invalid object " + objectName + " (" + line + ")");
+            }
+
+            if (lineStream.fail())
+            {
+                throw runtime_error("Invalid object " + objectName + " (" + line + ")");
+            }
+        }
+
+        __objectList.push_back(std::move(objectObj));
+    }
+
+
+    // Collect Symbol (The global vars and the exported functions of all the objects, each one defined once)
+    void __collectSymbol()
+    {
+        for (size_t objectIdx = 0; objectIdx < __objectList.size(); objectIdx++)
+        {
+            auto &objectObj = __objectList[objectIdx];
+
+            objectObj.__globalBase = __globalNum;
+
+            for (auto &[varName, varIdx, varSize]: objectObj.__globalList)
+            {
+                if (!__globalMap.try_emplace(varName, objectObj.__globalBase + varIdx, varSize).second)
+                {
+                    throw runtime_error("Invalid duplicate global var " + varName + " in " + objectObj.__filePath);
+                }
+
+                __globalNum = std::max(__globalNum, objectObj.__globalBase + varIdx + varSize + 1);
+            }
+
+            for (auto &[funcName, paramNum, targetName]: objectObj.__exportList)
+            {
+                if (!__exportMap.try_emplace(funcName, paramNum, targetName, objectIdx).second)
+                {
+                    throw runtime_error("Invalid duplicate function " + funcName + " in " + objectObj.__filePath);
+                }
+            }
+
+            for (auto &[funcName, codeList]: objectObj.__funcList)
+            {
+                __codeMap[funcName] = {std::move(codeList), objectIdx};
+                __funcNameList.push_back(funcName);
+            }
+        }
+
+        if (!__exportMap.count("main") || !__codeMap.count("__GLOBAL__"))
+        {
+            throw runtime_error("Invalid function: main");
+        }
+
+        for (auto &objectObj: __objectList)
+        {
+            for (auto &varName: objectObj.__externList)
+            {
+                if (!__globalMap.count(varName))
+                {
+                    throw runtime_error("Invalid undefined global var " + varName + " in " + objectObj.__filePath);
+                }
+            }
+
+            for (auto &[funcName, paramNum]: objectObj.__importList)
+            {
+                if (!__exportMap.count(funcName))
+                {
+                    throw runtime_error("Invalid undefined function " + funcName + " in " + objectObj.__filePath);
+                }
+
+                if (get<0>(__exportMap.at(funcName)) != paramNum)
+                {
+                    throw runtime_error("Invalid arg number of " + funcName + " in " + objectObj.__filePath + " (" +
+                        to_string(get<0>(__exportMap.at(funcName))) + " params in " +
+                        __objectList[get<2>(__exportMap.at(funcName))].__filePath + ")");
+                }
+            }
+        }
+    }
+
+
+    // Resolve Symbol (The call targets to the functions, and the global addresses to the numbers)
+    void __resolveSymbol()
+    {
+        for (auto &[funcName, codePair]: __codeMap)
+        {
+            auto &objectObj = __objectList[codePair.second];
+
+            for (auto &insObj: codePair.first)
+            {
+                if ((insObj.__insName == "call" || insObj.__insName == "tailcall" || insObj.__insName == "spawn") &&
+                    (!__codeMap.count(insObj.__insArg) || __codeMap.at(insObj.__insArg).second != codePair.second))
+                {
+                    // A function of another object: Only its export is called
+                    insObj.__insArg = get<1>(__exportMap.at(insObj.__insArg));
+                }
+                else if (insObj.__insName == "ldc" && !insObj.__insArg.empty() && insObj.__insArg[0] == '@')
+                {
+                    string varName = insObj.__insArg.substr(1);
+
+                    if (!__globalMap.count(varName))
+                    {
+                        throw runtime_error("Invalid undefined global var " + varName + " in " + objectObj.__filePath);
+                    }
+
+                    insObj.__insArg = to_string(__globalMap.at(varName).first);
+                }
+            }
+        }
+    }
+
+
+    // Generate Code: Global (The same as __Compiler::__genCodeGlobalVar, then the code calling the "main" function)
+    void __genCodeGlobal()
+    {
+        vector<pair<size_t, size_t>> infoList;
+        vector<__Instruction> codeList;
+
+        for (auto &[_, infoPair]: __globalMap)
+        {
+            infoList.push_back(infoPair);
+        }
+
+        sort(infoList.begin(), infoList.end());
+
+        // The global vars must be pushed in the order of their addresses
+        for (auto &[varIdx, varSize]: infoList)
+        {
+            // Array: The start address
+            if (varSize)
+            {
+                codeList.emplace_back("ldc", to_string(varIdx + 1));
+            }
+
+            codeList.emplace_back("push");
+
+            for (size_t _ = 0; _ < varSize; _++)
+            {
+                codeList.emplace_back("push");
+            }
+        }
+
+        auto &beginCodeList = __codeMap.at("__GLOBAL__").first;
+
+        codeList.insert(codeList.end(), beginCodeList.begin(), beginCodeList.end());
+        beginCodeList = codeList;
+    }
+
+
+    // Layout Code (Only the functions reachable from the global code, the "main" function is the last one)
+    void __layoutCode()
+    {
+        unordered_set<string> reachableSet {"__GLOBAL__"};
+        vector<string> funcStack {"__GLOBAL__"};
+
+        while (!funcStack.empty())
+        {
+            string funcName = funcStack.back();
+            funcStack.pop_back();
+
+            for (auto &insObj: __codeMap.at(funcName).first)
+            {
+                if ((insObj.__insName == "call" || insObj.__insName == "tailcall" || insObj.__insName == "spawn") &&
+                    reachableSet.insert(insObj.__insArg).second)
+                {
+                    funcStack.push_back(insObj.__insArg);
+                }
+            }
+        }
+
+        vector<string> funcNameList {"__GLOBAL__"};
+
+        for (auto &funcName: __funcNameList)
+        {
+            if (reachableSet.count(funcName) && funcName != "__GLOBAL__" && funcName != "main")
+            {
+                funcNameList.push_back(funcName);
+            }
+        }
+
+        funcNameList.push_back("main");
+
+        // Function name -> Function start IP
+        unordered_map<string, int64_t> funcJmpMap;
+
+        for (auto &funcName: funcNameList)
+        {
+            auto &[codeList, objectIdx] = __codeMap.at(funcName);
+
+            funcJmpMap[funcName] = __codeList.size();
+            __funcLayoutList.emplace_back(funcName, __codeList.size());
+            __codeList.insert(__codeList.end(), codeList.begin(), codeList.end());
+            __objectIdxList.insert(__objectIdxList.end(), codeList.size(), objectIdx);
+        }
+
+        for (size_t IP = 0; IP < __codeList.size(); IP++)
+        {
+            if (__codeList[IP].__insName == "call" || __codeList[IP].__insName == "tailcall" ||
+                __codeList[IP].__insName == "spawn")
+            {
+                __codeList[IP].__insArg = to_string(funcJmpMap.at(__codeList[IP].__insArg) - (int64_t)IP);
+            }
+        }
+
+        // The instructions added by the passes (Such as "lr N") belong to the line of the previous one
+        for (size_t IP = 1; IP < __codeList.size(); IP++)
+        {
+            if (!__codeList[IP].__lineNum)
+            {
+                __codeList[IP].__lineNum = __codeList[IP - 1].__lineNum;
+                __objectIdxList[IP]      = __objectIdxList[IP - 1];
+            }
+        }
+    }
+
+
+    // Output Result (The same as __Compiler::__outputResult, with a ".file" per object)
+    void __outputResult()
+    {
+        for (auto &insObj: __codeList)
+        {
+            __asmStr += insObj.__toString() + "\n";
+        }
+
+        for (auto &[funcName, funcIP]: __funcLayoutList)
+        {
+            __asmStr += ".func " + funcName + " " + to_string(funcIP) + "\n";
+        }
+
+        __asmStr += ".globals " + to_string(__globalNum) + "\n";
+
+        for (size_t IP = 0, lineNum = 0, objectIdx = __objectList.size(); IP < __codeList.size(); IP++)
+        {
+            if (__codeList[IP].__lineNum != lineNum || (lineNum && __objectIdxList[IP] != objectIdx))
+            {
+                if (__objectIdxList[IP] != objectIdx)
+                {
+                    objectIdx = __objectIdxList[IP];
+                    __asmStr += ".file " + __objectList[objectIdx].__filePath + "\n";
+                }
+
+                lineNum = __codeList[IP].__lineNum;
+                __asmStr += ".line " + to_string(IP) + " " + to_string(lineNum) + "\n";
+            }
+        }
+
+        FILE *fdOut = fopen(__outputFilePath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            throw runtime_error("Invalid " + __outputFilePath);
+        }
+
+        fwrite(__asmStr.data(), 1, __asmStr.size(), fdOut);
+        fclose(fdOut);
+    }
+
+
+    // Main
+    void __main()
+    {
+        for (auto &objectFilePath: __objectFilePathList)
+        {
+            ifstream fdIn(objectFilePath);
+            string objectStr;
+
+            if (!fdIn)
+            {
+                throw runtime_error("Invalid " + objectFilePath);
+            }
+
+            getline(fdIn, objectStr, '\0');
+
+            __parseObject(objectStr, objectFilePath);
+        }
+
+        __collectSymbol();
+        __resolveSymbol();
+        __genCodeGlobal();
+        __layoutCode();
+        __outputResult();
+    }
+};
+
+
+}  // End namespace CMM
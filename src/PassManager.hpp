@@ -0,0 +1,149 @@
+/*
+    PassManager.hpp
+    ===============
+        Class __PassManager implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <functional>
+#include <chrono>
+#include <stdexcept>
+#include <cstdio>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::tuple;
+using std::get;
+using std::function;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __PassManager
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __PassManager
+{
+    // Friend
+    friend class __Compiler;
+
+
+public:
+
+    // Constructor
+    explicit __PassManager(const string &printAfterName = "", bool timePassBool = false):
+        __printAfterName(printAfterName),
+        __timePassBool  (timePassBool) {}
+
+
+    // operator()
+    void operator()()
+    {
+        __main();
+    }
+
+
+private:
+
+    // Data
+    string __printAfterName;
+    bool __timePassBool;
+
+    // (Pass name, Pass function, Dump function)
+    vector<tuple<string, function<void()>, function<string()>>> __passList;
+
+    // (Pass name, Time (ms))
+    vector<tuple<string, double>> __timeList;
+
+
+    // Add Pass
+    void __addPass(const string &passName, const function<void()> &passFunc, const function<string()> &dumpFunc)
+    {
+        __passList.emplace_back(passName, passFunc, dumpFunc);
+    }
+
+
+    // Check Print After
+    void __checkPrintAfter() const
+    {
+        if (__printAfterName.empty())
+        {
+            return;
+        }
+
+        for (auto &passTuple: __passList)
+        {
+            if (get<0>(passTuple) == __printAfterName)
+            {
+                return;
+            }
+        }
+
+        throw runtime_error("Invalid pass: " + __printAfterName);
+    }
+
+
+    // Run Pass
+    void __runPass()
+    {
+        for (auto &[passName, passFunc, dumpFunc]: __passList)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+
+            passFunc();
+
+            __timeList.emplace_back(passName,
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+
+            if (passName == __printAfterName)
+            {
+                fprintf(stderr, "*** Dump After %s ***\n%s", passName.c_str(), dumpFunc().c_str());
+            }
+        }
+    }
+
+
+    // Print Time
+    void __printTime() const
+    {
+        if (!__timePassBool)
+        {
+            return;
+        }
+
+        double totalTime = 0.;
+
+        fprintf(stderr, "%-16s%12s\n", "Pass", "Time (ms)");
+
+        for (auto &[passName, passTime]: __timeList)
+        {
+            fprintf(stderr, "%-16s%12.3f\n", passName.c_str(), passTime);
+            totalTime += passTime;
+        }
+
+        fprintf(stderr, "%-16s%12.3f\n", "Total", totalTime);
+    }
+
+
+    // Main
+    void __main()
+    {
+        __checkPrintAfter();
+        __runPass();
+        __printTime();
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,272 @@
+/*
+    PerfCounter.hpp
+    ===============
+        Class __PerfCounter implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::tuple;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Perf Event List: (Name, Type, Config)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const vector<tuple<string, uint32_t, uint64_t>> __PERF_EVENT_LIST
+{
+    {"task-clock (ns)",       PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {"cycles",                PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions",          PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branches",              PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+
+    {"L1-dcache-load-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D                |
+                                                  PERF_COUNT_HW_CACHE_OP_READ << 8       |
+                                                  PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+
+    {"LLC-load-misses",       PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL                 |
+                                                  PERF_COUNT_HW_CACHE_OP_READ << 8       |
+                                                  PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __PerfCounter
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __PerfCounter
+{
+    // Friend
+    template <typename WordT, typename BoundsPolicy, typename TracePolicy, typename ProfilePolicy>
+    friend class __VM;
+    friend class __Profiler;
+
+
+public:
+
+    // Constructor
+    explicit __PerfCounter(bool enableBool = false):
+        __enableBool(enableBool) {}
+
+
+    // Destructor
+    ~__PerfCounter()
+    {
+        for (auto fd: __fdList)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+    }
+
+
+private:
+
+    // Attribute
+    bool __enableBool;
+    string __errorStr;
+
+    // Event index -> Perf event fd (-1 if the event is unavailable)
+    vector<int> __fdList;
+
+    // Event index -> Counter value (Scaled if the counters were multiplexed)
+    vector<uint64_t> __valueList;
+
+
+    // Is Available
+    bool __isAvailable() const
+    {
+        for (auto fd: __fdList)
+        {
+            if (fd >= 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    // Open (Only the user space of this process, the unavailable events are skipped)
+    void __open()
+    {
+        if (!__enableBool)
+        {
+            return;
+        }
+
+        for (auto &[eventName, eventType, eventConfig]: __PERF_EVENT_LIST)
+        {
+            perf_event_attr attrObj;
+
+            memset(&attrObj, 0, sizeof(attrObj));
+
+            attrObj.size           = sizeof(attrObj);
+            attrObj.type           = eventType;
+            attrObj.config         = eventConfig;
+            attrObj.disabled       = 1;
+            attrObj.exclude_kernel = 1;
+            attrObj.exclude_hv     = 1;
+            attrObj.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = syscall(__NR_perf_event_open, &attrObj, 0, -1, -1, 0);
+
+            if (fd < 0 && __errorStr.empty())
+            {
+                __errorStr = eventName + ": " + strerror(errno);
+            }
+
+            __fdList.push_back(fd);
+        }
+
+        __valueList.assign(__fdList.size(), 0);
+    }
+
+
+    // Start
+    void __start()
+    {
+        for (auto fd: __fdList)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+
+    // Read (Value, Time enabled, Time running)
+    vector<uint64_t> __read() const
+    {
+        vector<uint64_t> valueList(__fdList.size());
+
+        for (size_t eventIdx = 0; eventIdx < __fdList.size(); eventIdx++)
+        {
+            uint64_t readList[3];
+
+            if (__fdList[eventIdx] >= 0 && read(__fdList[eventIdx], readList, sizeof(readList)) == sizeof(readList))
+            {
+                // The counters may be multiplexed if there are not enough hardware counters
+                valueList[eventIdx] = readList[2] && readList[2] < readList[1] ?
+                    (uint64_t)((double)readList[0] * readList[1] / readList[2]) : readList[0];
+            }
+        }
+
+        return valueList;
+    }
+
+
+    // Stop
+    void __stop()
+    {
+        for (auto fd: __fdList)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        __valueList = __read();
+    }
+
+
+    // Get Value (-1 if the event is unavailable)
+    double __getValue(const string &eventName) const
+    {
+        for (size_t eventIdx = 0; eventIdx < __fdList.size(); eventIdx++)
+        {
+            if (std::get<0>(__PERF_EVENT_LIST[eventIdx]) == eventName && __fdList[eventIdx] >= 0)
+            {
+                return __valueList[eventIdx];
+            }
+        }
+
+        return -1.;
+    }
+
+
+    // Print Ratio
+    void __printRatio(const char *ratioName, double lhsVal, double rhsVal, double scaleVal = 1.) const
+    {
+        if (lhsVal >= 0. && rhsVal > 0.)
+        {
+            fprintf(stderr, "%-32s%16.3f\n", ratioName, lhsVal * scaleVal / rhsVal);
+        }
+        else
+        {
+            fprintf(stderr, "%-32s%16s\n", ratioName, "-");
+        }
+    }
+
+
+    // Report
+    void __report(uint64_t guestInsCount) const
+    {
+        if (!__enableBool)
+        {
+            return;
+        }
+
+        if (!__isAvailable())
+        {
+            fprintf(stderr, "*** Perf counters are unavailable (%s) ***\n", __errorStr.c_str());
+            return;
+        }
+
+        fprintf(stderr, "*** Perf Counters ***\n");
+        fprintf(stderr, "%-32s%16s\n", "Counter", "Value");
+
+        for (size_t eventIdx = 0; eventIdx < __fdList.size(); eventIdx++)
+        {
+            if (__fdList[eventIdx] >= 0)
+            {
+                fprintf(stderr, "%-32s%16lu\n", std::get<0>(__PERF_EVENT_LIST[eventIdx]).c_str(), __valueList[eventIdx]);
+            }
+            else
+            {
+                fprintf(stderr, "%-32s%16s\n", std::get<0>(__PERF_EVENT_LIST[eventIdx]).c_str(), "<not supported>");
+            }
+        }
+
+        fprintf(stderr, "%-32s%16lu\n", "guest-instructions", guestInsCount);
+        fprintf(stderr, "\n");
+
+        __printRatio("IPC", __getValue("instructions"), __getValue("cycles"));
+        __printRatio("Host ins / Guest ins", __getValue("instructions"), guestInsCount);
+        __printRatio("Host cycles / Guest ins", __getValue("cycles"), guestInsCount);
+        __printRatio("Branch miss rate (%)", __getValue("branch-misses"), __getValue("branches"), 100.);
+        __printRatio("L1D misses / 1K Guest ins", __getValue("L1-dcache-load-misses"), guestInsCount, 1000.);
+        __printRatio("LLC misses / 1K Guest ins", __getValue("LLC-load-misses"), guestInsCount, 1000.);
+    }
+};
+
+
+}  // End namespace CMM
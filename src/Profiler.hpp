@@ -0,0 +1,572 @@
+/*
+    Profiler.hpp
+    ============
+        Class __Profiler implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <csignal>
+#include <sys/time.h>
+#include "PerfCounter.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::map;
+using std::pair;
+using std::function;
+using std::runtime_error;
+using std::sort;
+using std::stable_sort;
+using std::find_if;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class __Profiler
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class __Profiler
+{
+    // Friend
+    template <typename WordT, typename BoundsPolicy, typename TracePolicy, typename ProfilePolicy>
+    friend class __VM;
+
+
+public:
+
+    // Constructor (Sample every sampleInterval instructions, or every sampleTimerUs us of CPU time if it is not 0)
+    explicit __Profiler(bool reportBool = false, const string &foldedStackFilePath = "", uint64_t sampleInterval = 1000,
+        uint64_t sampleTimerUs = 0):
+        __reportBool         (reportBool),
+        __foldedStackFilePath(foldedStackFilePath),
+        __sampleInterval     (sampleInterval ? sampleInterval : 1),
+        __sampleTimerUs      (sampleTimerUs) {}
+
+
+private:
+
+    // Hot Range Number
+    static constexpr size_t __HOT_RANGE_NUM = 10;
+
+
+    // Attribute
+    bool __reportBool;
+    string __foldedStackFilePath;
+    uint64_t __sampleInterval;
+    uint64_t __sampleTimerUs;
+    const vector<string> *__CSPtr = nullptr;
+
+    // IP -> "File:Line" ("" if there is no line table)
+    function<string(size_t)> __getSource;
+
+    // Per function perf counters (Exclusive): Function index -> Event index -> Value
+    const __PerfCounter *__perfCounterPtr = nullptr;
+    vector<vector<uint64_t>> __perfValueList;
+    vector<uint64_t> __lastPerfValueList;
+
+    // (Function name, Function start IP), sorted by the IP
+    vector<pair<string, size_t>> __funcList;
+
+    // IP -> Function index
+    vector<size_t> __funcIdxList;
+
+    // Executed count of each IP
+    vector<uint64_t> __IPCountList;
+    uint64_t __insCount = 0;
+
+    // Function index -> Call count, Inclusive count, Active frame number (For the recursion)
+    vector<uint64_t> __callCountList;
+    vector<uint64_t> __inclusiveCountList;
+    vector<size_t> __activeNumList;
+
+    // Shadow call stack: (Function index, __insCount at the entry)
+    vector<pair<size_t, uint64_t>> __shadowStack;
+
+    // Sampling: Function index list (From the root) -> Sample count
+    map<vector<size_t>, uint64_t> __foldedStackMap;
+    uint64_t __nextSampleCount = UINT64_MAX;
+    static inline volatile sig_atomic_t __timerFlag = 0;
+
+
+    // Is Enabled
+    bool __isEnabled() const
+    {
+        return __reportBool || !__foldedStackFilePath.empty();
+    }
+
+
+    // Init
+    void __init(const vector<string> &CS, vector<pair<string, size_t>> funcList,
+        const function<string(size_t)> &getSource, const __PerfCounter *perfCounterPtr = nullptr)
+    {
+        __CSPtr          = &CS;
+        __getSource      = getSource;
+        __perfCounterPtr = perfCounterPtr;
+
+        // Without the ".func" directives, the functions are the call targets
+        if (funcList.empty())
+        {
+            funcList.emplace_back("__GLOBAL__", 0);
+
+            for (size_t IP = 0; IP < CS.size(); IP++)
+            {
+                if (!CS[IP].compare(0, 5, "call ") || !CS[IP].compare(0, 9, "tailcall "))
+                {
+                    size_t funcIP = IP + stoll(CS[IP].substr(CS[IP].find(' ') + 1));
+                    funcList.emplace_back("func@" + to_string(funcIP), funcIP);
+                }
+            }
+        }
+
+        sort(funcList.begin(), funcList.end(), [](auto &lhs, auto &rhs) { return lhs.second < rhs.second; });
+
+        for (auto &funcPair: funcList)
+        {
+            if (__funcList.empty() || __funcList.back().second != funcPair.second)
+            {
+                __funcList.push_back(funcPair);
+            }
+        }
+
+        __funcIdxList.resize(CS.size());
+
+        for (size_t IP = 0, funcIdx = 0; IP < CS.size(); IP++)
+        {
+            while (funcIdx + 1 < __funcList.size() && __funcList[funcIdx + 1].second <= IP)
+            {
+                funcIdx++;
+            }
+
+            __funcIdxList[IP] = funcIdx;
+        }
+
+        __IPCountList.assign(CS.size(), 0);
+        __callCountList.assign(__funcList.size(), 0);
+        __inclusiveCountList.assign(__funcList.size(), 0);
+        __activeNumList.assign(__funcList.size(), 0);
+
+        if (__perfCounterPtr)
+        {
+            __perfValueList.assign(__funcList.size(), vector<uint64_t>(__PERF_EVENT_LIST.size()));
+        }
+
+        // The global code is the root
+        __enterFunction(0);
+
+        if (!__foldedStackFilePath.empty())
+        {
+            __startSample();
+        }
+    }
+
+
+    // Start Sample
+    void __startSample()
+    {
+        if (!__sampleTimerUs)
+        {
+            __nextSampleCount = __sampleInterval;
+            return;
+        }
+
+        signal(SIGPROF, [](int) { __timerFlag = 1; });
+
+        itimerval timerObj;
+
+        timerObj.it_interval.tv_sec  = __sampleTimerUs / 1000000;
+        timerObj.it_interval.tv_usec = __sampleTimerUs % 1000000;
+        timerObj.it_value            = timerObj.it_interval;
+
+        setitimer(ITIMER_PROF, &timerObj, nullptr);
+    }
+
+
+    // Stop Sample
+    void __stopSample()
+    {
+        if (__sampleTimerUs && !__foldedStackFilePath.empty())
+        {
+            itimerval timerObj {};
+
+            setitimer(ITIMER_PROF, &timerObj, nullptr);
+            signal(SIGPROF, SIG_DFL);
+        }
+    }
+
+
+    // Sample
+    void __sample()
+    {
+        vector<size_t> funcIdxList;
+
+        for (auto &funcPair: __shadowStack)
+        {
+            funcIdxList.push_back(funcPair.first);
+        }
+
+        __foldedStackMap[funcIdxList]++;
+    }
+
+
+    // Exec
+    void __exec(size_t IP)
+    {
+        __IPCountList[IP]++;
+        __insCount++;
+
+        if (__insCount == __nextSampleCount)
+        {
+            __sample();
+            __nextSampleCount += __sampleInterval;
+        }
+        else if (__timerFlag)
+        {
+            __sample();
+            __timerFlag = 0;
+        }
+    }
+
+
+    // Account Perf Counter (The counters since the last call / ret belong to the function on the top)
+    void __accountPerfCounter()
+    {
+        if (!__perfCounterPtr)
+        {
+            return;
+        }
+
+        auto perfValueList = __perfCounterPtr->__read();
+
+        if (!__shadowStack.empty() && !__lastPerfValueList.empty())
+        {
+            for (size_t eventIdx = 0; eventIdx < perfValueList.size(); eventIdx++)
+            {
+                __perfValueList[__shadowStack.back().first][eventIdx] +=
+                    perfValueList[eventIdx] - __lastPerfValueList[eventIdx];
+            }
+        }
+
+        __lastPerfValueList = perfValueList;
+    }
+
+
+    // Enter Function
+    void __enterFunction(size_t IP)
+    {
+        __accountPerfCounter();
+
+        size_t funcIdx = __funcIdxList[IP];
+
+        __callCountList[funcIdx]++;
+        __activeNumList[funcIdx]++;
+        __shadowStack.emplace_back(funcIdx, __insCount);
+    }
+
+
+    // Leave Function
+    void __leaveFunction()
+    {
+        if (__shadowStack.empty())
+        {
+            return;
+        }
+
+        __accountPerfCounter();
+
+        auto [funcIdx, entryCount] = __shadowStack.back();
+        __shadowStack.pop_back();
+
+        // Only the outermost frame of a recursive function is counted
+        if (!--__activeNumList[funcIdx])
+        {
+            __inclusiveCountList[funcIdx] += __insCount - entryCount;
+        }
+    }
+
+
+    // Get Percent
+    double __getPercent(uint64_t countNum) const
+    {
+        return __insCount ? countNum * 100. / __insCount : 0.;
+    }
+
+
+    // Report Function
+    void __reportFunction() const
+    {
+        vector<uint64_t> exclusiveCountList(__funcList.size());
+        vector<size_t> funcIdxList(__funcList.size());
+
+        for (size_t IP = 0; IP < __IPCountList.size(); IP++)
+        {
+            exclusiveCountList[__funcIdxList[IP]] += __IPCountList[IP];
+        }
+
+        for (size_t funcIdx = 0; funcIdx < __funcList.size(); funcIdx++)
+        {
+            funcIdxList[funcIdx] = funcIdx;
+        }
+
+        stable_sort(funcIdxList.begin(), funcIdxList.end(), [&](size_t lhsIdx, size_t rhsIdx)
+        {
+            return exclusiveCountList[lhsIdx] > exclusiveCountList[rhsIdx];
+        });
+
+        fprintf(stderr, "%-24s%12s%16s%10s%16s%10s\n", "Function", "Calls", "Exclusive", "(%)", "Inclusive", "(%)");
+
+        for (auto funcIdx: funcIdxList)
+        {
+            if (__callCountList[funcIdx])
+            {
+                fprintf(stderr, "%-24s%12lu%16lu%10.2f%16lu%10.2f\n", __funcList[funcIdx].first.c_str(),
+                    __callCountList[funcIdx], exclusiveCountList[funcIdx], __getPercent(exclusiveCountList[funcIdx]),
+                    __inclusiveCountList[funcIdx], __getPercent(__inclusiveCountList[funcIdx]));
+            }
+        }
+    }
+
+
+    // Report Perf Counter
+    void __reportPerfCounter() const
+    {
+        if (!__perfCounterPtr)
+        {
+            return;
+        }
+
+        fprintf(stderr, "\n%-24s", "Function");
+
+        for (size_t eventIdx = 0; eventIdx < __PERF_EVENT_LIST.size(); eventIdx++)
+        {
+            if (__perfCounterPtr->__fdList[eventIdx] >= 0)
+            {
+                fprintf(stderr, "%24s", std::get<0>(__PERF_EVENT_LIST[eventIdx]).c_str());
+            }
+        }
+
+        fprintf(stderr, "\n");
+
+        for (size_t funcIdx = 0; funcIdx < __funcList.size(); funcIdx++)
+        {
+            if (!__callCountList[funcIdx])
+            {
+                continue;
+            }
+
+            fprintf(stderr, "%-24s", __funcList[funcIdx].first.c_str());
+
+            for (size_t eventIdx = 0; eventIdx < __PERF_EVENT_LIST.size(); eventIdx++)
+            {
+                if (__perfCounterPtr->__fdList[eventIdx] >= 0)
+                {
+                    fprintf(stderr, "%24lu", __perfValueList[funcIdx][eventIdx]);
+                }
+            }
+
+            fprintf(stderr, "\n");
+        }
+    }
+
+
+    // Report Opcode
+    void __reportOpcode() const
+    {
+        vector<pair<string, uint64_t>> opcodeCountList;
+
+        for (size_t IP = 0; IP < __IPCountList.size(); IP++)
+        {
+            string opcodeStr = (*__CSPtr)[IP].substr(0, (*__CSPtr)[IP].find(' '));
+            auto opcodeIter = find_if(opcodeCountList.begin(), opcodeCountList.end(),
+                [&](auto &opcodePair) { return opcodePair.first == opcodeStr; });
+
+            if (opcodeIter == opcodeCountList.end())
+            {
+                opcodeCountList.emplace_back(opcodeStr, __IPCountList[IP]);
+            }
+            else
+            {
+                opcodeIter->second += __IPCountList[IP];
+            }
+        }
+
+        stable_sort(opcodeCountList.begin(), opcodeCountList.end(),
+            [](auto &lhs, auto &rhs) { return lhs.second > rhs.second; });
+
+        fprintf(stderr, "%-24s%12s%10s\n", "Opcode", "Count", "(%)");
+
+        for (auto &[opcodeStr, countNum]: opcodeCountList)
+        {
+            if (countNum)
+            {
+                fprintf(stderr, "%-24s%12lu%10.2f\n", opcodeStr.c_str(), countNum, __getPercent(countNum));
+            }
+        }
+    }
+
+
+    // Report Hot Range (A range is a maximal run of IPs in a function with the same count, i.e. a basic block)
+    void __reportHotRange() const
+    {
+        // (Start IP, End IP)
+        vector<pair<size_t, size_t>> rangeList;
+
+        for (size_t startIP = 0, endIP; startIP < __IPCountList.size(); startIP = endIP + 1)
+        {
+            for (endIP = startIP; endIP + 1 < __IPCountList.size() &&
+                __IPCountList[endIP + 1] == __IPCountList[startIP] &&
+                __funcIdxList[endIP + 1] == __funcIdxList[startIP]; endIP++);
+
+            if (__IPCountList[startIP])
+            {
+                rangeList.emplace_back(startIP, endIP);
+            }
+        }
+
+        auto getTotalCount = [&](const pair<size_t, size_t> &rangePair)
+        {
+            return __IPCountList[rangePair.first] * (rangePair.second - rangePair.first + 1);
+        };
+
+        stable_sort(rangeList.begin(), rangeList.end(),
+            [&](auto &lhs, auto &rhs) { return getTotalCount(lhs) > getTotalCount(rhs); });
+
+        if (rangeList.size() > __HOT_RANGE_NUM)
+        {
+            rangeList.resize(__HOT_RANGE_NUM);
+        }
+
+        fprintf(stderr, "%-24s%-24s%-24s%12s%16s%10s\n", "Hot Range", "Function", "Source", "Count", "Total", "(%)");
+
+        for (auto &rangePair: rangeList)
+        {
+            string rangeStr  = "IP " + to_string(rangePair.first) + "-" + to_string(rangePair.second);
+            string sourceStr = __getSource(rangePair.first);
+
+            fprintf(stderr, "%-24s%-24s%-24s%12lu%16lu%10.2f\n", rangeStr.c_str(),
+                __funcList[__funcIdxList[rangePair.first]].first.c_str(), sourceStr.empty() ? "-" : sourceStr.c_str(),
+                __IPCountList[rangePair.first], getTotalCount(rangePair), __getPercent(getTotalCount(rangePair)));
+        }
+    }
+
+
+    // Report Hot Line
+    void __reportHotLine() const
+    {
+        // "File:Line" -> Count
+        map<string, uint64_t> sourceCountMap;
+
+        for (size_t IP = 0; IP < __IPCountList.size(); IP++)
+        {
+            if (__IPCountList[IP])
+            {
+                string sourceStr = __getSource(IP);
+
+                if (!sourceStr.empty())
+                {
+                    sourceCountMap[sourceStr] += __IPCountList[IP];
+                }
+            }
+        }
+
+        if (sourceCountMap.empty())
+        {
+            return;
+        }
+
+        vector<pair<string, uint64_t>> sourceCountList(sourceCountMap.begin(), sourceCountMap.end());
+
+        stable_sort(sourceCountList.begin(), sourceCountList.end(),
+            [](auto &lhs, auto &rhs) { return lhs.second > rhs.second; });
+
+        if (sourceCountList.size() > __HOT_RANGE_NUM)
+        {
+            sourceCountList.resize(__HOT_RANGE_NUM);
+        }
+
+        fprintf(stderr, "\n%-48s%12s%10s\n", "Hot Line", "Count", "(%)");
+
+        for (auto &[sourceStr, countNum]: sourceCountList)
+        {
+            fprintf(stderr, "%-48s%12lu%10.2f\n", sourceStr.c_str(), countNum, __getPercent(countNum));
+        }
+    }
+
+
+    // Write Folded Stack ("main;sortNumList;getMinIdx 12345", the format of the flame graph tools)
+    void __writeFoldedStack() const
+    {
+        FILE *fdOut = fopen(__foldedStackFilePath.c_str(), "w");
+
+        if (!fdOut)
+        {
+            throw runtime_error("Invalid " + __foldedStackFilePath);
+        }
+
+        for (auto &[funcIdxList, sampleCount]: __foldedStackMap)
+        {
+            // The global code is omitted unless it is the only frame
+            string stackStr;
+
+            for (size_t idx = funcIdxList.size() > 1 ? 1 : 0; idx < funcIdxList.size(); idx++)
+            {
+                stackStr += (stackStr.empty() ? "" : ";") + __funcList[funcIdxList[idx]].first;
+            }
+
+            fprintf(fdOut, "%s %lu\n", stackStr.c_str(), sampleCount);
+        }
+
+        fclose(fdOut);
+    }
+
+
+    // Report
+    void __report()
+    {
+        __stopSample();
+
+        if (!__foldedStackFilePath.empty())
+        {
+            __writeFoldedStack();
+        }
+
+        // "main" never returns (Its "ret" is a jump to the end of code)
+        while (!__shadowStack.empty())
+        {
+            __leaveFunction();
+        }
+
+        if (!__reportBool)
+        {
+            return;
+        }
+
+        fprintf(stderr, "*** Profile: %lu instructions ***\n", __insCount);
+        __reportFunction();
+        __reportPerfCounter();
+        fprintf(stderr, "\n");
+        __reportOpcode();
+        fprintf(stderr, "\n");
+        __reportHotRange();
+        __reportHotLine();
+    }
+};
+
+
+}  // End namespace CMM
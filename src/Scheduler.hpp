@@ -0,0 +1,415 @@
+/*
+    Scheduler.hpp
+    =============
+        Class template __Scheduler implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <pthread.h>
+#include <sched.h>
+#include "Code.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::vector;
+using std::deque;
+using std::shared_ptr;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::condition_variable;
+using std::function;
+using std::atomic;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __Scheduler
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Run many contexts (Green threads) of a code on a pool of worker threads pinned to the CPUs.
+
+    Each worker has a queue of the ready contexts. It takes one from the front, runs it for a quantum of instructions
+    (Less if the fuel of the context runs out), and puts it back to the end if it is not finished, so the contexts of a
+    worker run in turn. A worker with an empty queue steals from the end of the other ones, and sleeps if there are
+    none.
+
+    A stream context waiting for its input is parked instead: it is in no queue, and does not hold a worker, until the
+    host pushes the input and wakes it. The contexts may be pushed while the workers run, until __close.
+
+    The tasks of spawn are pushed to the queue of the worker running their parent, after the slice ending at the spawn,
+    so the idle workers steal them. A "join" of an unfinished task parks the context on the task, and the worker
+    finishing the task wakes it.
+*/
+template <typename VMType>
+class __Scheduler
+{
+    // Friend
+    template <typename>
+    friend class __Batch;
+
+    template <typename>
+    friend class __Stream;
+
+    template <typename>
+    friend class __Server;
+
+    template <typename, typename, typename, typename>
+    friend class __VM;
+
+
+public:
+
+    // The context type of the VM
+    using __ContextType = typename VMType::__ContextType;
+
+    // Called by the worker after each slice of a context (ctx, finishBool, The error of a finished context)
+    using __SliceFunc = function<void (__ContextType &, bool, const string &)>;
+
+
+    // Constructor
+    explicit __Scheduler(const shared_ptr<const __Code> &codePtr, const vector<int> &cpuList, size_t workerNum,
+        uint64_t quantum, const __SliceFunc &sliceFunc = nullptr):
+        __codePtr   (codePtr),
+        __cpuList   (cpuList),
+        __workerNum (std::max(workerNum, (size_t)1)),
+        __quantum   (std::max(quantum, (uint64_t)1)),
+        __sliceFunc (sliceFunc),
+        __readyQueueList(__workerNum) {}
+
+
+    // Run (All the contexts to the end)
+    void operator()(const vector<__ContextType *> &ctxList)
+    {
+        __main(ctxList);
+    }
+
+
+private:
+
+    // A queue of the ready contexts
+    struct __ReadyQueue
+    {
+        mutex __queueMutex;
+        deque<__ContextType *> __ctxQueue;
+    };
+
+
+    // Attribute
+    shared_ptr<const __Code> __codePtr;
+    const vector<int> &__cpuList;
+    size_t __workerNum;
+    uint64_t __quantum;
+    __SliceFunc __sliceFunc;
+    vector<__ReadyQueue> __readyQueueList;
+    vector<thread> __workerList;
+
+    // The contexts pushed and not finished yet, the ones in the ready queues
+    atomic<size_t> __runningNum {0};
+    atomic<size_t> __readyNum {0};
+
+    // The queue of the next context pushed by the host
+    atomic<size_t> __pushIdx {0};
+
+    // No more contexts will be pushed
+    atomic<bool> __closeBool {false};
+
+    // The workers with no ready context wait on __idleCond
+    atomic<size_t> __idleNum {0};
+    mutex __idleMutex;
+    condition_variable __idleCond;
+
+    // Run statistics (The sums of all the workers)
+    uint64_t __insCount = 0;
+    uint64_t __callCount = 0;
+    size_t __maxSSSize = 0;
+    uint64_t __sliceCount = 0;
+    uint64_t __stealCount = 0;
+    uint64_t __parkCount = 0;
+    mutex __statMutex;
+
+
+    // Pin (The current thread to a CPU, it is only a hint, so the errors are ignored)
+    static void __pin(const vector<int> &cpuList, size_t workerIdx)
+    {
+        if (cpuList.empty())
+        {
+            return;
+        }
+
+        cpu_set_t cpuSet;
+
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpuList[workerIdx % cpuList.size()], &cpuSet);
+
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+
+
+    // Get CPU List (The CPUs allowed for this process)
+    static vector<int> __getCpuList()
+    {
+        vector<int> cpuList;
+        cpu_set_t cpuSet;
+
+        if (!sched_getaffinity(0, sizeof(cpuSet), &cpuSet))
+        {
+            for (int cpuIdx = 0; cpuIdx < CPU_SETSIZE; cpuIdx++)
+            {
+                if (CPU_ISSET(cpuIdx, &cpuSet))
+                {
+                    cpuList.push_back(cpuIdx);
+                }
+            }
+        }
+
+        return cpuList;
+    }
+
+
+    // Start (The workers)
+    void __start()
+    {
+        for (size_t workerIdx = 0; workerIdx < __workerNum; workerIdx++)
+        {
+            __workerList.emplace_back(&__Scheduler::__runWorker, this, workerIdx);
+        }
+    }
+
+
+    // Push (A new context, from any thread)
+    void __push(__ContextType *ctxPtr)
+    {
+        __runningNum++;
+        __pushReady(__pushIdx++ % __workerNum, ctxPtr);
+    }
+
+
+    // Wake (A parked context, after its __IO::__pushInput returns true, or its task is finished)
+    void __wake(__ContextType *ctxPtr)
+    {
+        __pushReady(__pushIdx++ % __workerNum, ctxPtr);
+    }
+
+
+    // Close (No more contexts, the workers exit after the running ones)
+    void __close()
+    {
+        __closeBool = true;
+        __notify(true);
+    }
+
+
+    // Join (The workers)
+    void __join()
+    {
+        for (auto &workerObj: __workerList)
+        {
+            workerObj.join();
+        }
+
+        __workerList.clear();
+    }
+
+
+    // Is Done
+    bool __isDone() const
+    {
+        return __closeBool && !__runningNum;
+    }
+
+
+    // Notify (The idle workers, there is a ready context or all the contexts are finished)
+    void __notify(bool allBool)
+    {
+        if (!allBool && !__idleNum)
+        {
+            return;
+        }
+
+        // A worker between its check and its wait holds the mutex
+        {
+            lock_guard<mutex> idleLock(__idleMutex);
+        }
+
+        allBool ? __idleCond.notify_all() : __idleCond.notify_one();
+    }
+
+
+    // Push Ready
+    void __pushReady(size_t workerIdx, __ContextType *ctxPtr)
+    {
+        {
+            lock_guard<mutex> queueLock(__readyQueueList[workerIdx].__queueMutex);
+
+            __readyQueueList[workerIdx].__ctxQueue.push_back(ctxPtr);
+        }
+
+        __readyNum++;
+        __notify(false);
+    }
+
+
+    // Pop Ready (The front of its own queue, or steal the end of another one)
+    bool __popReady(size_t workerIdx, __ContextType *&ctxPtr, uint64_t &stealCount)
+    {
+        for (size_t offsetIdx = 0; offsetIdx < __workerNum; offsetIdx++)
+        {
+            auto &readyQueue = __readyQueueList[(workerIdx + offsetIdx) % __workerNum];
+            lock_guard<mutex> queueLock(readyQueue.__queueMutex);
+
+            if (readyQueue.__ctxQueue.empty())
+            {
+                continue;
+            }
+
+            if (!offsetIdx)
+            {
+                ctxPtr = readyQueue.__ctxQueue.front();
+                readyQueue.__ctxQueue.pop_front();
+            }
+            else
+            {
+                ctxPtr = readyQueue.__ctxQueue.back();
+                readyQueue.__ctxQueue.pop_back();
+                stealCount++;
+            }
+
+            __readyNum--;
+
+            return true;
+        }
+
+        return false;
+    }
+
+
+    // Run Worker
+    void __runWorker(size_t workerIdx)
+    {
+        __pin(__cpuList, workerIdx);
+
+        VMType vmObj(__codePtr);
+        uint64_t sliceCount = 0, stealCount = 0, parkCount = 0;
+
+        while (!__isDone())
+        {
+            __ContextType *ctxPtr;
+
+            if (!__popReady(workerIdx, ctxPtr, stealCount))
+            {
+                unique_lock<mutex> idleLock(__idleMutex);
+
+                __idleNum++;
+                __idleCond.wait(idleLock, [this]() { return __readyNum || __isDone(); });
+                __idleNum--;
+
+                continue;
+            }
+
+            bool finishBool = true;
+            string errStr;
+
+            try
+            {
+                finishBool = vmObj.__execSlice(*ctxPtr, __quantum);
+            }
+            catch (const runtime_error &errObj)
+            {
+                errStr = errObj.what();
+            }
+
+            sliceCount++;
+
+            if (finishBool)
+            {
+                ctxPtr->__flush();
+            }
+
+            if (__sliceFunc)
+            {
+                __sliceFunc(*ctxPtr, finishBool, errStr);
+            }
+
+            // The context is not used after it is finished or parked (The host may free or wake it)
+            if (finishBool)
+            {
+                for (auto joinerPtr: ctxPtr->__finishTask(!errStr.empty()))
+                {
+                    __wake(joinerPtr);
+                }
+
+                if (!--__runningNum)
+                {
+                    __notify(true);
+                }
+
+                continue;
+            }
+
+            if (ctxPtr->__spawnPtr)
+            {
+                __runningNum++;
+                __pushReady(workerIdx, std::exchange(ctxPtr->__spawnPtr, nullptr));
+            }
+
+            auto joinPtr = std::exchange(ctxPtr->__joinPtr, nullptr);
+
+            if ((ctxPtr->__io.__waitBool && ctxPtr->__io.__park()) || (joinPtr && joinPtr->__parkJoiner(ctxPtr)))
+            {
+                parkCount++;
+            }
+            else
+            {
+                __pushReady(workerIdx, ctxPtr);
+            }
+        }
+
+        lock_guard<mutex> statLock(__statMutex);
+
+        __insCount += vmObj.__insCount;
+        __callCount += vmObj.__callCount;
+        __maxSSSize = std::max(__maxSSSize, vmObj.__maxSSSize);
+        __sliceCount += sliceCount;
+        __stealCount += stealCount;
+        __parkCount += parkCount;
+    }
+
+
+    // Main
+    void __main(const vector<__ContextType *> &ctxList)
+    {
+        for (auto ctxPtr: ctxList)
+        {
+            __push(ctxPtr);
+        }
+
+        __close();
+        __start();
+        __join();
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,648 @@
+/*
+    Server.hpp
+    ==========
+        Class template __Server implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "Code.hpp"
+#include "Compiler.hpp"
+#include "Cache.hpp"
+#include "Scheduler.hpp"
+#include "Util.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::deque;
+using std::shared_ptr;
+using std::make_shared;
+using std::unique_ptr;
+using std::make_unique;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::condition_variable;
+using std::atomic;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __Server
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Serve the compile and run requests of the clients of a Unix socket, so a short program does not pay the process
+    startup, the option parsing and the cold caches of a CMM run. A request is a header line, then the code and the
+    input of the program:
+
+        Kind CodeSize InputSize [Fuel [OptLevel]]\n <CodeSize bytes> <InputSize bytes>
+
+    Kind is "cmm" (A source, compiled in memory) or "asm" (The asm text of a compiled program), the input is the text
+    ints of the program, and Fuel / OptLevel (0 / -1 for the server ones) override --fuel and -O (A source is looked up
+    in the compile cache first, if there is one). The response is:
+
+        Status OutputSize StatsSize\n <OutputSize bytes> <StatsSize bytes>
+
+    Status is "ok" or "error", the output is the one of a normal run (Kept before an error), and the stats are a JSON
+    object (See __getStatsStr). A connection may send many requests, one after another.
+
+    The host thread polls the listening socket and the idle connections, and queues each connection with a request to
+    the workers. A worker serves the requests of a connection with its own context (So a warm SS and I/O buffer), then
+    gives it back to the host thread. SIGINT / SIGTERM stop the server after the requests being served.
+*/
+template <typename VMType>
+class __Server
+{
+    // Friend
+    friend class __Kernel;
+
+
+public:
+
+    // Constructor (0 jobs means one per CPU)
+    explicit __Server(const string &socketPath, size_t jobNum = 0, uint64_t fuel = UINT64_MAX, size_t inlineBudget = 0,
+        size_t optLevel = 1, __Cache *cachePtr = nullptr):
+        __socketPath  (socketPath),
+        __jobNum      (jobNum),
+        __fuel        (fuel),
+        __inlineBudget(inlineBudget),
+        __optLevel    (optLevel),
+        __cachePtr    (cachePtr) {}
+
+
+    // operator()
+    void operator()()
+    {
+        __main();
+    }
+
+
+private:
+
+    // The max size of a header line, and of the code or the input of a request
+    static constexpr size_t __MAX_HEADER_SIZE = 256;
+    static constexpr size_t __MAX_REQUEST_SIZE = 1 << 28;
+
+    // The bytes of a socket read
+    static constexpr size_t __READ_SIZE = 1 << 16;
+
+    // The I/O buffer of a worker context
+    static constexpr size_t __CONTEXT_BUFFER_SIZE = 1 << 12;
+
+
+    // A client connection (The bytes read after the last request are kept for the next one)
+    struct __Connection
+    {
+        int __fd;
+        string __bufferStr;
+    };
+
+
+    // A request
+    struct __Request
+    {
+        string __kindStr;
+        string __codeStr;
+        string __inputStr;
+        uint64_t __fuel;
+        size_t __optLevel;
+    };
+
+
+    // Attribute
+    string __socketPath;
+    size_t __jobNum;
+    uint64_t __fuel;
+    size_t __inlineBudget;
+    size_t __optLevel;
+    __Cache *__cachePtr;
+    int __listenFd = -1;
+
+    // The CPUs allowed for this process
+    vector<int> __cpuList;
+
+    // The pipe waking the host thread: A worker gives back a connection, or a signal stops the server
+    int __wakeFdList[2] = {-1, -1};
+
+    // The connections with a request, taken by the workers
+    deque<unique_ptr<__Connection>> __readyList;
+    bool __stopBool = false;
+    mutex __readyMutex;
+    condition_variable __readyCond;
+
+    // The connections given back by the workers, polled again by the host thread
+    vector<unique_ptr<__Connection>> __backList;
+    mutex __backMutex;
+
+    // The write end of the wake pipe and the flag of the signal handler
+    static inline int __signalFd = -1;
+    static inline volatile sig_atomic_t __signalBool = 0;
+
+    // Statistics
+    atomic<uint64_t> __requestCount {0};
+    atomic<uint64_t> __errorCount {0};
+
+
+    // On Signal (Wake the host thread to stop)
+    static void __onSignal(int)
+    {
+        __signalBool = 1;
+
+        if (write(__signalFd, "", 1) < 0) {}
+    }
+
+
+    // Open Socket (A stale socket file of the path is replaced)
+    void __openSocket()
+    {
+        sockaddr_un addrObj {};
+
+        if (__socketPath.size() >= sizeof(addrObj.sun_path))
+        {
+            throw runtime_error("Invalid socket path (Too long): " + __socketPath);
+        }
+
+        struct stat statObj;
+
+        if (!lstat(__socketPath.c_str(), &statObj) && S_ISSOCK(statObj.st_mode))
+        {
+            unlink(__socketPath.c_str());
+        }
+
+        addrObj.sun_family = AF_UNIX;
+        strcpy(addrObj.sun_path, __socketPath.c_str());
+
+        __listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        if (__listenFd < 0 || bind(__listenFd, (sockaddr *)&addrObj, sizeof(addrObj)) ||
+            listen(__listenFd, SOMAXCONN))
+        {
+            throw runtime_error("Invalid socket " + __socketPath + ": " + strerror(errno));
+        }
+
+        if (pipe2(__wakeFdList, O_NONBLOCK | O_CLOEXEC))
+        {
+            throw runtime_error(string("Invalid wake pipe: ") + strerror(errno));
+        }
+    }
+
+
+    // Read More (Append the next bytes of the connection to its buffer, false at its end)
+    static bool __readMore(__Connection &connObj)
+    {
+        char readBuffer[__READ_SIZE];
+
+        while (true)
+        {
+            ssize_t readSize = read(connObj.__fd, readBuffer, sizeof(readBuffer));
+
+            if (readSize > 0)
+            {
+                connObj.__bufferStr.append(readBuffer, readSize);
+
+                return true;
+            }
+
+            if (!readSize || errno != EINTR)
+            {
+                return false;
+            }
+        }
+    }
+
+
+    // Write All
+    static bool __writeAll(int connFd, const string &dataStr)
+    {
+        for (size_t dataIdx = 0; dataIdx < dataStr.size();)
+        {
+            ssize_t writeSize = send(connFd, dataStr.data() + dataIdx, dataStr.size() - dataIdx, MSG_NOSIGNAL);
+
+            if (writeSize < 0 && errno != EINTR)
+            {
+                return false;
+            }
+
+            dataIdx += std::max(writeSize, (ssize_t)0);
+        }
+
+        return true;
+    }
+
+
+    // Read Request (false at the end of the connection, or an invalid header, whose error is errStr)
+    bool __readRequest(__Connection &connObj, __Request &requestObj, string &errStr) const
+    {
+        size_t lineIdx;
+
+        while ((lineIdx = connObj.__bufferStr.find('\n')) == string::npos)
+        {
+            if (connObj.__bufferStr.size() > __MAX_HEADER_SIZE)
+            {
+                errStr = "Invalid request header (Too long)";
+
+                return false;
+            }
+
+            if (!__readMore(connObj))
+            {
+                return false;
+            }
+        }
+
+        // Kind CodeSize InputSize [Fuel [OptLevel]]
+        char kindBuffer[8];
+        unsigned long long codeSize, inputSize, fuel = 0;
+        long long optLevel = -1;
+        int fieldNum = sscanf(connObj.__bufferStr.substr(0, lineIdx).c_str(), "%7s %llu %llu %llu %lld", kindBuffer,
+            &codeSize, &inputSize, &fuel, &optLevel);
+
+        requestObj.__kindStr = fieldNum > 0 ? kindBuffer : "";
+
+        if (fieldNum < 3 || (requestObj.__kindStr != "cmm" && requestObj.__kindStr != "asm") ||
+            codeSize > __MAX_REQUEST_SIZE || inputSize > __MAX_REQUEST_SIZE || optLevel > 2)
+        {
+            errStr = "Invalid request header: " + connObj.__bufferStr.substr(0, std::min(lineIdx, __MAX_HEADER_SIZE));
+
+            return false;
+        }
+
+        requestObj.__fuel = fuel ? fuel : __fuel;
+        requestObj.__optLevel = optLevel < 0 ? __optLevel : optLevel;
+
+        connObj.__bufferStr.erase(0, lineIdx + 1);
+
+        while (connObj.__bufferStr.size() < codeSize + inputSize)
+        {
+            if (!__readMore(connObj))
+            {
+                return false;
+            }
+        }
+
+        requestObj.__codeStr.assign(connObj.__bufferStr, 0, codeSize);
+        requestObj.__inputStr.assign(connObj.__bufferStr, codeSize, inputSize);
+        connObj.__bufferStr.erase(0, codeSize + inputSize);
+
+        return true;
+    }
+
+
+    /*
+        Get Stats Str (The stats of a response, the schema is "cmm-serve/1"):
+
+        {
+            "schema": "cmm-serve/1", "error": null | str,
+            "compile_ms": null | float (null for an asm request), "instructions": int,
+            "cache": null | "hit" | "miss" (null for an asm request or without --cache),
+            "guest_instructions": int, "calls": int, "peak_ss_depth": int, "run_ms": float,
+            "wall_ms": float
+        }
+    */
+    static string __getStatsStr(const string &errStr, double compileTime, size_t insNum, const char *cacheStr,
+        const VMType *vmPtr, double runTime, double wallTime)
+    {
+        char compileBuffer[32], statsBuffer[320];
+
+        snprintf(compileBuffer, sizeof(compileBuffer), compileTime < 0 ? "null" : "%.3f", compileTime);
+        snprintf(statsBuffer, sizeof(statsBuffer), "\"compile_ms\": %s, \"instructions\": %zu, \"cache\": %s, "
+            "\"guest_instructions\": %lu, \"calls\": %lu, \"peak_ss_depth\": %zu, \"run_ms\": %.3f, \"wall_ms\": %.3f}",
+            compileBuffer, insNum, cacheStr, vmPtr ? vmPtr->__insCount : 0, vmPtr ? vmPtr->__callCount : 0,
+            vmPtr ? vmPtr->__maxSSSize : 0, runTime, wallTime);
+
+        return "{\"schema\": \"cmm-serve/1\", \"error\": " +
+            (errStr.empty() ? "null" : __Util::__toJsonStr(errStr)) + ", " + statsBuffer;
+    }
+
+
+    // Serve Request (The response of a request, run on the context of the worker)
+    string __serveRequest(const __Request &requestObj, typename VMType::__ContextType &ctxObj) const
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        string outputStr, errStr;
+        double compileTime = -1., runTime = 0.;
+        size_t insNum = 0;
+        const char *cacheStr = "null";
+        unique_ptr<VMType> vmPtr;
+
+        try
+        {
+            shared_ptr<const __Code> codePtr;
+
+            if (requestObj.__kindStr == "cmm")
+            {
+                string keyStr, asmStr;
+
+                if (__cachePtr)
+                {
+                    keyStr = __Cache::__getKey(requestObj.__codeStr, requestObj.__optLevel, __inlineBudget, false,
+                        sizeof(typename VMType::__WordType) * 8);
+                }
+
+                if (__cachePtr && __cachePtr->__load(keyStr, "request.c", asmStr))
+                {
+                    cacheStr = "\"hit\"";
+                }
+                else
+                {
+                    __Compiler compilerObj("request.c", "", __inlineBudget, false, requestObj.__optLevel, "", false,
+                        nullptr, false, sizeof(typename VMType::__WordType) * 8);
+
+                    asmStr = compilerObj.__compileSource(requestObj.__codeStr);
+
+                    if (__cachePtr)
+                    {
+                        __cachePtr->__store(keyStr, asmStr);
+                        cacheStr = "\"miss\"";
+                    }
+                }
+
+                codePtr = make_shared<const __Code>("request.c", asmStr);
+                compileTime = __Util::__getTime(startTime);
+            }
+            else
+            {
+                codePtr = make_shared<const __Code>("request.asm", requestObj.__codeStr);
+            }
+
+            insNum = codePtr->__CS.size();
+            vmPtr = make_unique<VMType>(codePtr);
+
+            auto runStartTime = std::chrono::steady_clock::now();
+
+            vmPtr->__startRecord(ctxObj, requestObj.__inputStr.data(), requestObj.__inputStr.size(), outputStr,
+                requestObj.__fuel);
+
+            // The output before a runtime error is kept, the same as a normal run
+            try
+            {
+                codePtr->__spawnBool ? vmPtr->__execTask(ctxObj) : vmPtr->__execAll(ctxObj);
+            }
+            catch (const std::exception &errObj)
+            {
+                errStr = errObj.what();
+            }
+
+            ctxObj.__flush();
+            runTime = __Util::__getTime(runStartTime);
+        }
+        catch (const std::exception &errObj)
+        {
+            errStr = errObj.what();
+        }
+
+        string statsStr = __getStatsStr(errStr, compileTime, insNum, cacheStr, vmPtr.get(), runTime,
+            __Util::__getTime(startTime));
+
+        return (errStr.empty() ? "ok " : "error ") + to_string(outputStr.size()) + " " + to_string(statsStr.size()) +
+            "\n" + outputStr + statsStr;
+    }
+
+
+    // Serve Connection (Its requests in the buffer or sent now, false if it is finished)
+    bool __serveConnection(__Connection &connObj, typename VMType::__ContextType &ctxObj)
+    {
+        do
+        {
+            __Request requestObj;
+            string errStr;
+
+            if (!__readRequest(connObj, requestObj, errStr))
+            {
+                // An invalid header ends the connection, as the rest of it can not be parsed
+                if (!errStr.empty())
+                {
+                    string statsStr = __getStatsStr(errStr, -1., 0, "null", nullptr, 0., 0.);
+
+                    __writeAll(connObj.__fd, "error 0 " + to_string(statsStr.size()) + "\n" + statsStr);
+                    __errorCount++;
+                }
+
+                return false;
+            }
+
+            string responseStr = __serveRequest(requestObj, ctxObj);
+
+            __requestCount++;
+
+            if (responseStr[0] == 'e')
+            {
+                __errorCount++;
+            }
+
+            if (!__writeAll(connObj.__fd, responseStr))
+            {
+                return false;
+            }
+        }
+        while (!connObj.__bufferStr.empty());
+
+        return true;
+    }
+
+
+    // Run Worker (Serve the ready connections until the server stops)
+    void __runWorker(size_t workerIdx)
+    {
+        __Scheduler<VMType>::__pin(__cpuList, workerIdx);
+
+        typename VMType::__ContextType ctxObj("", "", false, __CONTEXT_BUFFER_SIZE);
+
+        while (true)
+        {
+            unique_ptr<__Connection> connPtr;
+
+            {
+                unique_lock<mutex> readyLock(__readyMutex);
+
+                __readyCond.wait(readyLock, [this]() { return __stopBool || !__readyList.empty(); });
+
+                if (__stopBool)
+                {
+                    return;
+                }
+
+                connPtr = std::move(__readyList.front());
+                __readyList.pop_front();
+            }
+
+            if (!__serveConnection(*connPtr, ctxObj))
+            {
+                close(connPtr->__fd);
+
+                continue;
+            }
+
+            {
+                lock_guard<mutex> backLock(__backMutex);
+
+                __backList.push_back(std::move(connPtr));
+            }
+
+            if (write(__wakeFdList[1], "", 1) < 0) {}
+        }
+    }
+
+
+    // Main
+    void __main()
+    {
+        if (__socketPath.empty())
+        {
+            return;
+        }
+
+        __openSocket();
+
+        __cpuList = __Scheduler<VMType>::__getCpuList();
+
+        if (!__jobNum)
+        {
+            __jobNum = std::max(__cpuList.size(), (size_t)1);
+        }
+
+        __signalFd = __wakeFdList[1];
+        signal(SIGINT, __onSignal);
+        signal(SIGTERM, __onSignal);
+
+        vector<thread> workerList;
+
+        for (size_t workerIdx = 0; workerIdx < __jobNum; workerIdx++)
+        {
+            workerList.emplace_back(&__Server::__runWorker, this, workerIdx);
+        }
+
+        fprintf(stderr, "Serving on %s with %zu workers\n", __socketPath.c_str(), __jobNum);
+
+        // The idle connections, polled after the listening socket and the wake pipe
+        vector<unique_ptr<__Connection>> idleList;
+        vector<pollfd> pollList;
+
+        while (!__signalBool)
+        {
+            pollList.assign({{__listenFd, POLLIN, 0}, {__wakeFdList[0], POLLIN, 0}});
+
+            for (auto &connPtr: idleList)
+            {
+                pollList.push_back({connPtr->__fd, POLLIN, 0});
+            }
+
+            if (poll(pollList.data(), pollList.size(), -1) < 0)
+            {
+                continue;
+            }
+
+            // The connections with a request (Or closed) go to the workers
+            for (size_t connIdx = idleList.size(); connIdx-- > 0;)
+            {
+                if (pollList[connIdx + 2].revents)
+                {
+                    lock_guard<mutex> readyLock(__readyMutex);
+
+                    __readyList.push_back(std::move(idleList[connIdx]));
+                    idleList.erase(idleList.begin() + connIdx);
+                    __readyCond.notify_one();
+                }
+            }
+
+            if (pollList[1].revents)
+            {
+                char drainBuffer[256];
+
+                while (read(__wakeFdList[0], drainBuffer, sizeof(drainBuffer)) > 0) {}
+
+                lock_guard<mutex> backLock(__backMutex);
+
+                for (auto &connPtr: __backList)
+                {
+                    idleList.push_back(std::move(connPtr));
+                }
+
+                __backList.clear();
+            }
+
+            if (pollList[0].revents)
+            {
+                for (int connFd; (connFd = accept4(__listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0;)
+                {
+                    idleList.push_back(make_unique<__Connection>(__Connection {connFd, ""}));
+                }
+            }
+        }
+
+        {
+            lock_guard<mutex> readyLock(__readyMutex);
+
+            __stopBool = true;
+            __readyCond.notify_all();
+        }
+
+        for (auto &workerObj: workerList)
+        {
+            workerObj.join();
+        }
+
+        for (auto *connListPtr: {&idleList, &__backList})
+        {
+            for (auto &connPtr: *connListPtr)
+            {
+                close(connPtr->__fd);
+            }
+        }
+
+        for (auto &connPtr: __readyList)
+        {
+            close(connPtr->__fd);
+        }
+
+        close(__listenFd);
+        close(__wakeFdList[0]);
+        close(__wakeFdList[1]);
+        unlink(__socketPath.c_str());
+
+        fprintf(stderr, "Served %lu requests (%lu errors)\n", (unsigned long)__requestCount,
+            (unsigned long)__errorCount);
+
+        if (__cachePtr)
+        {
+            fprintf(stderr, "Compile cache: %lu hits, %lu misses, %lu evictions\n",
+                (unsigned long)__cachePtr->__hitCount, (unsigned long)__cachePtr->__missCount,
+                (unsigned long)__cachePtr->__evictCount);
+        }
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,368 @@
+/*
+    Stream.hpp
+    ==========
+        Class template __Stream implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include "Code.hpp"
+#include "Scheduler.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::shared_ptr;
+using std::make_shared;
+using std::unique_ptr;
+using std::make_unique;
+using std::mutex;
+using std::lock_guard;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __Stream
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    Run many instances of a program, whose inputs arrive over time, as green threads on the __Scheduler.
+
+    Each line "Id Int Int ..." of the input pushes the ints to the input of the instance Id (A new id starts a new
+    instance), and "Id ." closes it (Then an "in" fails, the same as at the end of a file). All the inputs are closed at
+    the end of the input. The outputs are written as the lines "Id Int", and "Id ." when the instance is finished.
+
+    An instance running out of its input is parked and does not hold a worker, so a few workers serve many instances
+    waiting for their inputs. The host thread only reads the input and wakes the parked instances; the outputs of each
+    slice are written by the worker which ran it.
+*/
+template <typename VMType>
+class __Stream
+{
+    // Friend
+    friend class __Kernel;
+
+
+public:
+
+    // Constructor (An empty path means stdin / stdout, 0 jobs means one per CPU, 0 quantum means __DEFAULT_QUANTUM)
+    explicit __Stream(const string &asmFilePath, const string &inputFilePath = "", const string &outputFilePath = "",
+        size_t jobNum = 0, uint64_t quantum = 0, uint64_t fuel = UINT64_MAX):
+        __asmFilePath   (asmFilePath),
+        __inputFilePath (inputFilePath),
+        __outputFilePath(outputFilePath),
+        __jobNum        (jobNum),
+        __quantum       (quantum ? quantum : __DEFAULT_QUANTUM),
+        __fuel          (fuel) {}
+
+
+    // operator()
+    void operator()()
+    {
+        __main();
+    }
+
+
+private:
+
+    // The instructions of a slice if there is no --quantum
+    static constexpr uint64_t __DEFAULT_QUANTUM = 10000;
+
+    // The I/O buffer of an instance context (A full output buffer yields the instance)
+    static constexpr size_t __INSTANCE_BUFFER_SIZE = 256;
+
+
+    // An instance (The output text is declared first, so it outlives the context flushing to it)
+    struct __Instance
+    {
+        string __outputStr;
+        unique_ptr<typename VMType::__ContextType> __ctxPtr;
+    };
+
+
+    // Attribute
+    string __asmFilePath;
+    string __inputFilePath;
+    string __outputFilePath;
+    size_t __jobNum;
+    uint64_t __quantum;
+    uint64_t __fuel;
+    shared_ptr<const __Code> __codePtr;
+
+    // The CPUs allowed for this process
+    vector<int> __cpuList;
+
+    // The running instances (Only used by the host thread)
+    unordered_map<size_t, unique_ptr<__Instance>> __instanceMap;
+
+    // The ids of the finished instances, freed by the host thread
+    vector<size_t> __finishIdList;
+    mutex __finishMutex;
+
+    // The output, written by the workers
+    FILE *__fdOut = nullptr;
+    mutex __outputMutex;
+
+    // Run statistics (The same names as the __VM ones for __Kernel::__outputStats)
+    uint64_t __insCount = 0;
+    uint64_t __callCount = 0;
+    size_t __maxSSSize = 0;
+    uint64_t __sliceCount = 0;
+    uint64_t __stealCount = 0;
+    uint64_t __parkCount = 0;
+    size_t __instanceNum = 0;
+    size_t __errorNum = 0;
+    size_t __lineErrorNum = 0;
+
+
+    // Write Output (Called by a worker after each slice: The outputs of the slice as "Id Int" lines)
+    void __writeOutput(typename VMType::__ContextType &ctxObj, bool finishBool, const string &errStr)
+    {
+        ctxObj.__flush();
+
+        string &outputStr = *ctxObj.__io.__outputStrPtr;
+
+        if (outputStr.empty() && !finishBool)
+        {
+            return;
+        }
+
+        string idStr = to_string(ctxObj.__id), lineStr;
+
+        for (size_t startIdx = 0, endIdx; startIdx < outputStr.size(); startIdx = endIdx + 1)
+        {
+            endIdx = outputStr.find('\n', startIdx);
+            lineStr += idStr + " ";
+            lineStr.append(outputStr, startIdx, endIdx - startIdx + 1);
+        }
+
+        outputStr.clear();
+
+        if (finishBool)
+        {
+            lineStr += idStr + " .\n";
+        }
+
+        {
+            lock_guard<mutex> outputLock(__outputMutex);
+
+            fwrite(lineStr.data(), 1, lineStr.size(), __fdOut);
+            fflush(__fdOut);
+
+            if (!errStr.empty())
+            {
+                fprintf(stderr, "Instance %zu: %s\n", ctxObj.__id, errStr.c_str());
+                __errorNum++;
+            }
+        }
+
+        // The instance is not used after this
+        if (finishBool)
+        {
+            lock_guard<mutex> finishLock(__finishMutex);
+
+            __finishIdList.push_back(ctxObj.__id);
+        }
+    }
+
+
+    // Free Finished (The instances finished by the workers)
+    void __freeFinished()
+    {
+        lock_guard<mutex> finishLock(__finishMutex);
+
+        for (auto instanceId: __finishIdList)
+        {
+            __instanceMap.erase(instanceId);
+        }
+
+        __finishIdList.clear();
+    }
+
+
+    // Feed Line ("Id Int Int ..." or "Id .", false if the line is invalid)
+    bool __feedLine(const char *linePtr, size_t lineSize, const VMType &vmObj, __Scheduler<VMType> &schedulerObj)
+    {
+        const char *endPtr = linePtr + lineSize;
+        char *idEndPtr;
+
+        if (!lineSize || !isdigit((unsigned char)*linePtr))
+        {
+            return false;
+        }
+
+        size_t instanceId = strtoull(linePtr, &idEndPtr, 10);
+        const char *dataPtr = idEndPtr;
+
+        while (dataPtr < endPtr && (*dataPtr == ' ' || *dataPtr == '\t'))
+        {
+            dataPtr++;
+        }
+
+        bool closeBool = dataPtr < endPtr && *dataPtr == '.';
+        auto instanceIter = __instanceMap.find(instanceId);
+
+        // The ints of the line end with its '\n', so an "in" never reads a part of an int
+        string dataStr = closeBool ? "" : string(dataPtr, endPtr - dataPtr);
+
+        if (!dataStr.empty() && dataStr.back() != '\n')
+        {
+            dataStr.push_back('\n');
+        }
+
+        if (instanceIter != __instanceMap.end())
+        {
+            auto ctxPtr = instanceIter->second->__ctxPtr.get();
+
+            if (ctxPtr->__io.__pushInput(dataStr.data(), dataStr.size(), closeBool))
+            {
+                schedulerObj.__wake(ctxPtr);
+            }
+        }
+        else if (!closeBool)
+        {
+            auto &instancePtr = __instanceMap[instanceId];
+
+            instancePtr = make_unique<__Instance>();
+            instancePtr->__ctxPtr = make_unique<typename VMType::__ContextType>("", "", false, __INSTANCE_BUFFER_SIZE);
+
+            auto ctxPtr = instancePtr->__ctxPtr.get();
+
+            vmObj.__startStream(*ctxPtr, instancePtr->__outputStr, __fuel);
+            ctxPtr->__id = instanceId;
+            ctxPtr->__io.__pushInput(dataStr.data(), dataStr.size(), false);
+
+            schedulerObj.__push(ctxPtr);
+            __instanceNum++;
+        }
+
+        return true;
+    }
+
+
+    // Main
+    void __main()
+    {
+        if (__asmFilePath.empty())
+        {
+            return;
+        }
+
+        __codePtr = make_shared<const __Code>(__asmFilePath);
+        __cpuList = __Scheduler<VMType>::__getCpuList();
+
+        if (!__jobNum)
+        {
+            __jobNum = std::max(__cpuList.size(), (size_t)1);
+        }
+
+        FILE *fdIn = __inputFilePath.empty() ? stdin : fopen(__inputFilePath.c_str(), "r");
+
+        if (!fdIn)
+        {
+            throw runtime_error("Invalid " + __inputFilePath);
+        }
+
+        __fdOut = __outputFilePath.empty() ? stdout : fopen(__outputFilePath.c_str(), "w");
+
+        if (!__fdOut)
+        {
+            throw runtime_error("Invalid " + __outputFilePath);
+        }
+
+        VMType vmObj(__codePtr);
+
+        __Scheduler<VMType> schedulerObj(__codePtr, __cpuList, __jobNum, __quantum,
+            [this](typename VMType::__ContextType &ctxObj, bool finishBool, const string &errStr)
+            {
+                __writeOutput(ctxObj, finishBool, errStr);
+            });
+
+        schedulerObj.__start();
+
+        char *linePtr = nullptr;
+        size_t lineCapacity = 0;
+        size_t lineIdx = 0;
+
+        for (ssize_t lineSize; (lineSize = ::getline(&linePtr, &lineCapacity, fdIn)) >= 0;)
+        {
+            lineIdx++;
+
+            __freeFinished();
+
+            if (!__feedLine(linePtr, lineSize, vmObj, schedulerObj))
+            {
+                lock_guard<mutex> outputLock(__outputMutex);
+
+                fprintf(stderr, "Line %zu: Invalid instance id\n", lineIdx);
+                __lineErrorNum++;
+            }
+        }
+
+        free(linePtr);
+
+        if (fdIn != stdin)
+        {
+            fclose(fdIn);
+        }
+
+        // The end of the input closes the inputs of all the instances
+        __freeFinished();
+
+        for (auto &[instanceId, instancePtr]: __instanceMap)
+        {
+            if (instancePtr->__ctxPtr->__io.__pushInput(nullptr, 0, true))
+            {
+                schedulerObj.__wake(instancePtr->__ctxPtr.get());
+            }
+        }
+
+        schedulerObj.__close();
+        schedulerObj.__join();
+
+        __freeFinished();
+
+        if (__fdOut != stdout)
+        {
+            fclose(__fdOut);
+        }
+
+        __insCount = schedulerObj.__insCount;
+        __callCount = schedulerObj.__callCount;
+        __maxSSSize = schedulerObj.__maxSSSize;
+        __sliceCount = schedulerObj.__sliceCount;
+        __stealCount = schedulerObj.__stealCount;
+        __parkCount = schedulerObj.__parkCount;
+
+        if (__lineErrorNum)
+        {
+            throw runtime_error("Invalid lines: " + to_string(__lineErrorNum) + " of " + to_string(lineIdx));
+        }
+
+        if (__errorNum)
+        {
+            throw runtime_error("Invalid instances: " + to_string(__errorNum) + " of " + to_string(__instanceNum));
+        }
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,191 @@
+/*
+    TaskGroup.hpp
+    =============
+        Class template __TaskGroup implementation.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include "IO.hpp"
+#include "Context.hpp"
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::deque;
+using std::unique_ptr;
+using std::make_unique;
+using std::mutex;
+using std::lock_guard;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Template __TaskGroup
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    The tasks of a program calling spawn: The main context and the contexts of its tasks, run by the __Scheduler.
+
+    The global vars (The SS words [0, __globalNum) of the main context) are copied to __globalList at the first spawn,
+    then all the contexts of the group read and write them there, so they are shared by the tasks. A task is spawned
+    with its frame at the same SS addresses as in its parent (So the array pointers of the frame are still valid),
+    and the words below the frame are never touched: an address below the frame of a task is either a global var
+    or the stack of another task, which is an error.
+
+    The in / out instructions of all the tasks use the I/O of the main context, under __ioMutex.
+*/
+template <typename WordT>
+class __TaskGroup
+{
+    // Friend
+    template <typename, typename, typename, typename>
+    friend class __VM;
+
+    template <typename>
+    friend class __Context;
+
+
+public:
+
+    // Constructor
+    explicit __TaskGroup(size_t globalNum, uint64_t fuel, __IO &ioObj):
+        __globalNum(globalNum),
+        __fuel     (fuel),
+        __ioPtr    (&ioObj) {}
+
+
+private:
+
+    // The words reserved above the frame of a new task, so its SS rarely grows by a copy of the untouched words
+    static constexpr size_t __STACK_RESERVE = 1 << 16;
+
+
+    // Attribute
+    size_t __globalNum;
+    uint64_t __fuel;
+    __IO *__ioPtr;
+    mutex __ioMutex;
+
+    // The shared global vars (Never resized after the first spawn, so the pointers of the contexts stay valid)
+    vector<WordT> __globalList;
+    bool __shareBool = false;
+
+    // The contexts of the tasks, the handle of a task is its index + 1
+    deque<unique_ptr<__Context<WordT>>> __taskList;
+    mutex __taskMutex;
+
+
+    // Spawn (A task running from IP with the frame of frameSize words on the top of the SS of ctx)
+    WordT __spawn(__Context<WordT> &ctx, size_t IP, size_t frameSize, size_t endIP, size_t RSSize)
+    {
+        if (frameSize > ctx.__SS.size() || ctx.__SS.size() - frameSize < __globalNum)
+        {
+            throw runtime_error("Invalid spawn frame size " + to_string(frameSize));
+        }
+
+        auto taskPtr = make_unique<__Context<WordT>>("", "", false, 0);
+        size_t baseIdx = ctx.__SS.size() - frameSize;
+
+        taskPtr->__reset(RSSize, __fuel);
+        taskPtr->__SS.reserve(ctx.__SS.size() + __STACK_RESERVE);
+        taskPtr->__SS.resize(baseIdx);
+        taskPtr->__SS.insert(taskPtr->__SS.end(), ctx.__SS.end() - frameSize, ctx.__SS.end());
+
+        // The same as a "call", and the OldIP is the last instruction, so the "ret" of the function ends the task
+        taskPtr->__IP = IP;
+        taskPtr->__BP = taskPtr->__SS.size() - 1;
+        taskPtr->__SS.push_back(0);
+        taskPtr->__SS.push_back(endIP);
+        taskPtr->__groupPtr = this;
+        taskPtr->__baseIdx  = baseIdx;
+
+        lock_guard<mutex> taskLock(__taskMutex);
+
+        // Only the main context is running before the first spawn
+        if (!__shareBool)
+        {
+            __globalList.assign(ctx.__SS.begin(), ctx.__SS.begin() + __globalNum);
+            __shareBool = true;
+
+            ctx.__globalPtr = __globalList.data();
+            ctx.__globalNum = __globalNum;
+            ctx.__baseIdx   = __globalNum;
+        }
+
+        taskPtr->__globalPtr = __globalList.data();
+        taskPtr->__globalNum = __globalNum;
+
+        ctx.__spawnPtr = taskPtr.get();
+        __taskList.push_back(std::move(taskPtr));
+
+        return __taskList.size();
+    }
+
+
+    // Get Task (By its handle)
+    __Context<WordT> *__getTask(WordT handleIdx)
+    {
+        lock_guard<mutex> taskLock(__taskMutex);
+
+        if (handleIdx < 1 || (size_t)handleIdx > __taskList.size())
+        {
+            throw runtime_error("Invalid task handle " + to_string(handleIdx));
+        }
+
+        return __taskList[handleIdx - 1].get();
+    }
+
+
+    // Get Task Num
+    size_t __getTaskNum()
+    {
+        lock_guard<mutex> taskLock(__taskMutex);
+
+        return __taskList.size();
+    }
+
+
+    // Read Int (The input of the main context)
+    bool __readInt(WordT &intVal)
+    {
+        lock_guard<mutex> ioLock(__ioMutex);
+
+        return __ioPtr->__readInt(intVal);
+    }
+
+
+    // Write Int (The output of the main context)
+    void __writeInt(WordT intVal)
+    {
+        lock_guard<mutex> ioLock(__ioMutex);
+
+        __ioPtr->__writeInt(intVal);
+    }
+
+
+    // Flush (The output of the main context)
+    void __flush()
+    {
+        lock_guard<mutex> ioLock(__ioMutex);
+
+        __ioPtr->__flush();
+    }
+};
+
+
+}  // End namespace CMM
@@ -0,0 +1,66 @@
+/*
+    Util.hpp
+    ========
+        Struct __Util implementation (The helpers shared by __Kernel and __Server).
+*/
+
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Struct __Util
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __Util
+{
+    // Get Time (ms)
+    static double __getTime(std::chrono::steady_clock::time_point startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+
+    // To JSON String (Quoted, with the quotes, backslashes and control chars escaped)
+    static string __toJsonStr(const string &rawStr)
+    {
+        string jsonStr = "\"";
+
+        for (unsigned char curChar: rawStr)
+        {
+            if (curChar == '"' || curChar == '\\')
+            {
+                jsonStr += '\\';
+                jsonStr += curChar;
+            }
+            else if (curChar < 0x20)
+            {
+                char escapeStr[8];
+
+                snprintf(escapeStr, sizeof(escapeStr), "\\u%04x", curChar);
+                jsonStr += escapeStr;
+            }
+            else
+            {
+                jsonStr += curChar;
+            }
+        }
+
+        return jsonStr + "\"";
+    }
+};
+
+
+}  // End namespace CMM
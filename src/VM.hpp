@@ -1,15 +1,25 @@
 /*
     VM.hpp
     ======
-        Class __VM implementation.
+        Class template __VM implementation.
 */
 
 #pragma once
 
 #include <string>
 #include <vector>
-#include <fstream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <algorithm>
+#include "Code.hpp"
+#include "Context.hpp"
+#include "TaskGroup.hpp"
+#include "ArrayKernel.hpp"
+#include "Scheduler.hpp"
+#include "Profiler.hpp"
+#include "PerfCounter.hpp"
+#include "VMPolicy.hpp"
 
 namespace CMM
 {
@@ -19,22 +29,82 @@ namespace CMM
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 using std::string;
+using std::to_string;
 using std::vector;
-using std::ifstream;
+using std::shared_ptr;
+using std::make_shared;
+using std::mutex;
+using std::lock_guard;
 using std::runtime_error;
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Class __VM
+// Class Template __VM
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/*
+    The features are chosen at compile time, so the hot loop has no branch for the unused ones:
+
+    WordT:         The word of SS, AX, BP and RS (int32_t or int64_t)
+    BoundsPolicy:  __UncheckedBounds, __CheckedBounds
+    TracePolicy:   __NoTrace, __StderrTrace
+    ProfilePolicy: __NoProfile, __StatProfile, __FullProfile
+*/
+template <typename WordT = int32_t, typename BoundsPolicy = __UncheckedBounds, typename TracePolicy = __NoTrace,
+    typename ProfilePolicy = __NoProfile>
 class __VM
 {
+    // Friend
+    friend class __Kernel;
+
+    template <typename VMType>
+    friend class __Batch;
+
+    template <typename VMType, size_t LaneNum>
+    friend class __LaneVM;
+
+    template <typename VMType>
+    friend class __Server;
+
+    template <typename VMType>
+    friend class __Scheduler;
+
+    template <typename VMType>
+    friend class __Stream;
+
+
 public:
 
+    // The context type of the programs it runs
+    using __ContextType = __Context<WordT>;
+
+    // The word type of the programs it runs
+    using __WordType = WordT;
+
+    // A batch can run it on a __LaneVM (Without the trace and the profiler of each instruction)
+    static constexpr bool __laneBool = TracePolicy::__laneBool && !ProfilePolicy::__profileBool;
+
+
     // Constructor
-    explicit __VM(const string &inputFilePath):
-        __inputFilePath(inputFilePath) {}
+    explicit __VM(const string &inputFilePath, const string &ioInputFilePath = "", const string &ioOutputFilePath = "",
+        bool ioBinaryBool = false, bool profileBool = false, const string &foldedStackFilePath = "",
+        uint64_t sampleInterval = 1000, uint64_t sampleTimerUs = 0, bool perfCounterBool = false,
+        uint64_t fuel = UINT64_MAX, size_t jobNum = 0, uint64_t quantum = 0):
+        __inputFilePath(inputFilePath),
+        __fuel         (fuel),
+        __jobNum       (jobNum),
+        __quantum      (quantum),
+        __ctx          (ioInputFilePath, ioOutputFilePath, ioBinaryBool),
+        __profiler     (profileBool, foldedStackFilePath, sampleInterval, sampleTimerUs),
+        __perfCounter  (perfCounterBool) {}
+
+
+    // Constructor (A shared loaded code, the contexts are given by each run)
+    explicit __VM(const shared_ptr<const __Code> &codePtr):
+        __codePtr(codePtr)
+    {
+        __codePtr->__checkWordSize(sizeof(WordT) * 8);
+    }
 
 
     // operator()
@@ -46,144 +116,605 @@ public:
 
 private:
 
+    // The instructions of a slice of the tasks if there is no --quantum
+    static constexpr uint64_t __DEFAULT_TASK_QUANTUM = 10000;
+
+
     // Attribute
     string __inputFilePath;
-    vector<string> __CS;
-    size_t __IP;
-    vector<int32_t> __SS;
-    int32_t __AX;
-    int32_t __BP;
+    uint64_t __fuel = UINT64_MAX;
+    size_t __jobNum = 0;
+    uint64_t __quantum = 0;
+    shared_ptr<const __Code> __codePtr;
+    __Context<WordT> __ctx;
+    __Profiler __profiler;
+    __PerfCounter __perfCounter;
+
+    // Run statistics (Only counted if ProfilePolicy::__statBool)
+    uint64_t __insCount = 0;
+    uint64_t __callCount = 0;
+    size_t __maxSSSize = 0;
+
+    // Task statistics (Only if the program calls spawn)
+    size_t __taskNum = 0;
+    uint64_t __sliceCount = 0;
+    uint64_t __stealCount = 0;
+    uint64_t __parkCount = 0;
+
+
+    // Get Word (By an absolute address: A shared global var of a task, or a word of SS)
+    static WordT *__getWord(__Context<WordT> &ctx, WordT addrIdx)
+    {
+        if ((size_t)addrIdx < ctx.__baseIdx)
+        {
+            return ctx.__getShared(addrIdx);
+        }
+
+        BoundsPolicy::__checkIdx(ctx.__SS, addrIdx);
+
+        return &ctx.__SS[addrIdx];
+    }
 
 
-    // Construct __CS
-    void __constructCS()
+    // Get Range (wordNum words by an absolute address, all of them in the shared global vars or in SS)
+    static WordT *__getRange(__Context<WordT> &ctx, WordT addrIdx, WordT wordNum)
     {
-        ifstream fdIn(__inputFilePath);
+        if (wordNum < 0)
+        {
+            throw runtime_error("Invalid range size " + to_string(wordNum));
+        }
 
-        if (!fdIn)
+        if ((size_t)addrIdx < ctx.__baseIdx)
         {
-            throw runtime_error("Invalid " + __inputFilePath);
+            if ((size_t)addrIdx + wordNum > ctx.__globalNum)
+            {
+                throw runtime_error("Invalid access to the stack of another task");
+            }
+
+            return ctx.__globalPtr + addrIdx;
         }
 
-        for (string line; getline(fdIn, line); __CS.push_back(line));
+        BoundsPolicy::__checkRange(ctx.__SS, addrIdx, wordNum);
+
+        return ctx.__SS.data() + addrIdx;
     }
 
 
-    // Exec Code
-    void __execCode()
+    // Get Task (By its handle)
+    static __Context<WordT> *__getTask(__Context<WordT> &ctx, WordT handleIdx)
     {
-        for (__IP = 0; __IP < __CS.size(); __IP++)
+        if (!ctx.__groupPtr)
         {
-            if (!__CS[__IP].compare(0, 4, "ldc "))
+            throw runtime_error("Invalid task handle " + to_string(handleIdx));
+        }
+
+        return ctx.__groupPtr->__getTask(handleIdx);
+    }
+
+
+    // Exec Code (From ctx.__IP, with SliceBool at most sliceLeft instructions, true if the program is finished)
+    template <bool SliceBool>
+    bool __execCode(__Context<WordT> &ctx, uint64_t &sliceLeft)
+    {
+        const auto &CS = __codePtr->__CS;
+
+        for (; ctx.__IP < CS.size(); ctx.__IP++)
+        {
+            // Yield before the next instruction, so ctx.__IP is where to resume
+            if constexpr (SliceBool)
             {
-                __AX = stoll(__CS[__IP].substr(4));
+                if (!sliceLeft)
+                {
+                    return false;
+                }
+
+                sliceLeft--;
             }
-            else if (__CS[__IP] == "ld")
+
+            if constexpr (ProfilePolicy::__profileBool)
             {
-                __AX = __SS[__BP - __AX];
+                __profiler.__exec(ctx.__IP);
             }
-            else if (__CS[__IP] == "ald")
+
+            if constexpr (ProfilePolicy::__statBool)
             {
-                __AX = __SS[__AX];
+                __insCount++;
+                __maxSSSize = std::max(__maxSSSize, ctx.__SS.size());
             }
-            else if (__CS[__IP] == "st")
+
+            TracePolicy::__trace(ctx.__IP, CS[ctx.__IP], ctx.__AX, ctx.__SS.size());
+
+            if (!CS[ctx.__IP].compare(0, 4, "ldc "))
             {
-                __SS[__BP - __AX] = __SS.back();
+                ctx.__AX = stoll(CS[ctx.__IP].substr(4));
             }
-            else if (__CS[__IP] == "ast")
+            else if (CS[ctx.__IP] == "ld")
             {
-                __SS[__AX] = __SS.back();
+                BoundsPolicy::__checkIdx(ctx.__SS, (WordT)(ctx.__BP - ctx.__AX));
+                ctx.__AX = ctx.__SS[ctx.__BP - ctx.__AX];
             }
-            else if (__CS[__IP] == "push")
+            else if (CS[ctx.__IP] == "ald")
             {
-                __SS.push_back(__AX);
+                // The shared global vars of the tasks (Or only ctx.__SS, if there is no task)
+                if ((size_t)ctx.__AX < ctx.__baseIdx)
+                {
+                    ctx.__AX = __atomic_load_n(ctx.__getShared(ctx.__AX), __ATOMIC_RELAXED);
+                }
+                else
+                {
+                    BoundsPolicy::__checkIdx(ctx.__SS, ctx.__AX);
+                    ctx.__AX = ctx.__SS[ctx.__AX];
+                }
             }
-            else if (__CS[__IP] == "pop")
+            else if (CS[ctx.__IP] == "st")
             {
-                __SS.pop_back();
+                BoundsPolicy::__checkIdx(ctx.__SS, (WordT)(ctx.__BP - ctx.__AX));
+                ctx.__SS[ctx.__BP - ctx.__AX] = ctx.__SS.back();
             }
-            else if (!__CS[__IP].compare(0, 4, "jmp "))
+            else if (CS[ctx.__IP] == "ast")
             {
-                __IP += stoll(__CS[__IP].substr(4)) - 1;
+                if ((size_t)ctx.__AX < ctx.__baseIdx)
+                {
+                    __atomic_store_n(ctx.__getShared(ctx.__AX), ctx.__SS.back(), __ATOMIC_RELAXED);
+                }
+                else
+                {
+                    BoundsPolicy::__checkIdx(ctx.__SS, ctx.__AX);
+                    ctx.__SS[ctx.__AX] = ctx.__SS.back();
+                }
             }
-            else if (!__CS[__IP].compare(0, 3, "jz "))
+            else if (CS[ctx.__IP] == "push")
             {
-                if (!__AX)
+                ctx.__SS.push_back(ctx.__AX);
+            }
+            else if (CS[ctx.__IP] == "pop")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__SS.pop_back();
+            }
+            else if (!CS[ctx.__IP].compare(0, 4, "jmp "))
+            {
+                ctx.__IP += stoll(CS[ctx.__IP].substr(4)) - 1;
+            }
+            else if (!CS[ctx.__IP].compare(0, 3, "jz "))
+            {
+                if (!ctx.__AX)
+                {
+                    ctx.__IP += stoll(CS[ctx.__IP].substr(3)) - 1;
+                }
+            }
+            else if (CS[ctx.__IP] == "add")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() + ctx.__AX;
+            }
+            else if (CS[ctx.__IP] == "sub")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() - ctx.__AX;
+            }
+            else if (CS[ctx.__IP] == "mul")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() * ctx.__AX;
+            }
+            else if (CS[ctx.__IP] == "div")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+
+                if (!ctx.__AX)
                 {
-                    __IP += stoll(__CS[__IP].substr(3)) - 1;
+                    throw runtime_error("Division by zero");
                 }
+
+                ctx.__AX = ctx.__SS.back() / ctx.__AX;
+            }
+            else if (CS[ctx.__IP] == "lt")
+            {
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() < ctx.__AX;
             }
-            else if (__CS[__IP] == "add")
+            else if (CS[ctx.__IP] == "le")
             {
-                __AX = __SS.back() + __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() <= ctx.__AX;
             }
-            else if (__CS[__IP] == "sub")
+            else if (CS[ctx.__IP] == "gt")
             {
-                __AX = __SS.back() - __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() > ctx.__AX;
             }
-            else if (__CS[__IP] == "mul")
+            else if (CS[ctx.__IP] == "ge")
             {
-                __AX = __SS.back() * __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() >= ctx.__AX;
             }
-            else if (__CS[__IP] == "div")
+            else if (CS[ctx.__IP] == "eq")
             {
-                __AX = __SS.back() / __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() == ctx.__AX;
             }
-            else if (__CS[__IP] == "lt")
+            else if (CS[ctx.__IP] == "ne")
             {
-                __AX = __SS.back() < __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = ctx.__SS.back() != ctx.__AX;
+            }
+            else if (CS[ctx.__IP] == "in")
+            {
+                // The tasks share the input of the main context
+                if (ctx.__groupPtr)
+                {
+                    ctx.__groupPtr->__readInt(ctx.__AX);
+                }
+                // A stream context with no input yet waits for it, the "in" is run again when it is resumed
+                else if (!ctx.__io.__readInt(ctx.__AX) && ctx.__io.__waitBool)
+                {
+                    if constexpr (SliceBool)
+                    {
+                        sliceLeft++;
+                    }
+
+                    if constexpr (ProfilePolicy::__statBool)
+                    {
+                        __insCount--;
+                    }
+
+                    return false;
+                }
+            }
+            else if (CS[ctx.__IP] == "out")
+            {
+                if (ctx.__groupPtr)
+                {
+                    ctx.__groupPtr->__writeInt(ctx.__AX);
+                }
+                else
+                {
+                    ctx.__io.__writeInt(ctx.__AX);
+
+                    // A stream context yields after the "out" when its output buffer is full
+                    if constexpr (SliceBool)
+                    {
+                        if (ctx.__io.__isOutputFull())
+                        {
+                            ctx.__IP++;
+
+                            return false;
+                        }
+                    }
+                }
+            }
+            else if (!CS[ctx.__IP].compare(0, 4, "lea "))
+            {
+                ctx.__AX = ctx.__SS.size() - stoll(CS[ctx.__IP].substr(4));
+            }
+            else if (!CS[ctx.__IP].compare(0, 5, "call "))
+            {
+                ctx.__SS.push_back(ctx.__BP);
+                ctx.__BP = ctx.__SS.size() - 2;
+                ctx.__SS.push_back(ctx.__IP);
+                ctx.__IP += stoll(CS[ctx.__IP].substr(5)) - 1;
+
+                if constexpr (ProfilePolicy::__profileBool)
+                {
+                    __profiler.__enterFunction(ctx.__IP + 1);
+                }
+
+                if constexpr (ProfilePolicy::__statBool)
+                {
+                    __callCount++;
+                }
+            }
+            else if (!CS[ctx.__IP].compare(0, 3, "sr "))
+            {
+                WordT regIdx = stoll(CS[ctx.__IP].substr(3));
+
+                BoundsPolicy::__checkIdx(ctx.__RS, regIdx);
+                ctx.__RS[regIdx] = ctx.__AX;
+            }
+            else if (!CS[ctx.__IP].compare(0, 3, "lr "))
+            {
+                WordT regIdx = stoll(CS[ctx.__IP].substr(3));
+
+                BoundsPolicy::__checkIdx(ctx.__RS, regIdx);
+                ctx.__AX = ctx.__RS[regIdx];
+            }
+            else if (!CS[ctx.__IP].compare(0, 9, "tailcall "))
+            {
+                // Move the new frame (Above the OldBP and the OldIP) to the current frame
+                BoundsPolicy::__checkSize(ctx.__SS, ctx.__BP + 3);
+
+                WordT frameSize = ctx.__SS.size() - ctx.__BP - 3;
+
+                for (WordT idx = 0; idx < frameSize; idx++)
+                {
+                    BoundsPolicy::__checkIdx(ctx.__SS, (WordT)(ctx.__BP - idx));
+                    ctx.__SS[ctx.__BP - idx] = ctx.__SS[ctx.__SS.size() - idx - 1];
+                }
+
+                ctx.__SS.resize(ctx.__BP + 3);
+                ctx.__IP += stoll(CS[ctx.__IP].substr(9)) - 1;
+
+                if constexpr (ProfilePolicy::__profileBool)
+                {
+                    __profiler.__leaveFunction();
+                    __profiler.__enterFunction(ctx.__IP + 1);
+                }
+
+                if constexpr (ProfilePolicy::__statBool)
+                {
+                    __callCount++;
+                }
             }
-            else if (__CS[__IP] == "le")
+            else if (!CS[ctx.__IP].compare(0, 6, "spawn "))
             {
-                __AX = __SS.back() <= __AX;
+                // A new task runs the function with the frame of AX words on the top of SS, like a "call"
+                if (!ctx.__groupPtr)
+                {
+                    throw runtime_error("Invalid spawn (Only a single run can spawn tasks)");
+                }
+
+                ctx.__AX = ctx.__groupPtr->__spawn(ctx, ctx.__IP + stoll(CS[ctx.__IP].substr(6)), ctx.__AX,
+                    CS.size() - 1, __codePtr->__RSSize);
+
+                if constexpr (ProfilePolicy::__statBool)
+                {
+                    __callCount++;
+                }
+
+                // Yield, so the scheduler pushes the task to a ready queue
+                if constexpr (SliceBool)
+                {
+                    ctx.__IP++;
+
+                    return false;
+                }
             }
-            else if (__CS[__IP] == "gt")
+            else if (CS[ctx.__IP] == "join")
             {
-                __AX = __SS.back() > __AX;
+                auto taskPtr = __getTask(ctx, ctx.__AX);
+
+                // An unfinished task parks the context on it, the "join" is run again when the task wakes it
+                if (!taskPtr->__finishBool)
+                {
+                    ctx.__joinPtr = taskPtr;
+
+                    if constexpr (SliceBool)
+                    {
+                        sliceLeft++;
+                    }
+
+                    if constexpr (ProfilePolicy::__statBool)
+                    {
+                        __insCount--;
+                    }
+
+                    return false;
+                }
+
+                if (taskPtr->__errorBool)
+                {
+                    throw runtime_error("Invalid join of a failed task");
+                }
+
+                ctx.__AX = taskPtr->__AX;
             }
-            else if (__CS[__IP] == "ge")
+            else if (CS[ctx.__IP] == "aadd")
             {
-                __AX = __SS.back() >= __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 1);
+                ctx.__AX = __atomic_fetch_add(__getWord(ctx, ctx.__AX), ctx.__SS.back(), __ATOMIC_SEQ_CST);
             }
-            else if (__CS[__IP] == "eq")
+            else if (CS[ctx.__IP] == "acas")
             {
-                __AX = __SS.back() == __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                // The old value is in expectVal either way
+                WordT expectVal = ctx.__SS.back();
+
+                __atomic_compare_exchange_n(__getWord(ctx, ctx.__AX), &expectVal, ctx.__SS[ctx.__SS.size() - 2], false,
+                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+                ctx.__AX = expectVal;
             }
-            else if (__CS[__IP] == "ne")
+            else if (CS[ctx.__IP] == "ret")
             {
-                __AX = __SS.back() != __AX;
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                ctx.__IP = ctx.__SS.back();
+                ctx.__SS.pop_back();
+                ctx.__BP = ctx.__SS.back();
+                ctx.__SS.pop_back();
+
+                if constexpr (ProfilePolicy::__profileBool)
+                {
+                    __profiler.__leaveFunction();
+                }
             }
-            else if (__CS[__IP] == "in")
+            else if (CS[ctx.__IP] == "afill")
             {
-                scanf("%d", &__AX);
+                // fill(Array, Lo, Hi, Value): AX = Array, SS.TOP() = Lo, then Hi and Value, AX = Hi - Lo
+                BoundsPolicy::__checkSize(ctx.__SS, 3);
+
+                WordT loIdx = ctx.__SS.back(), wordNum = ctx.__SS[ctx.__SS.size() - 2] - loIdx;
+                WordT *wordPtr = __getRange(ctx, ctx.__AX + loIdx, wordNum);
+
+                __ArrayKernel::__fill(wordPtr, wordNum, ctx.__SS[ctx.__SS.size() - 3]);
+                ctx.__AX = wordNum;
             }
-            else if (__CS[__IP] == "out")
+            else if (CS[ctx.__IP] == "acopy")
             {
-                printf("%d\n", __AX);
+                // copy(Dst, Src, N): AX = Dst, SS.TOP() = Src, then N, AX = N
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                WordT wordNum = ctx.__SS[ctx.__SS.size() - 2];
+                WordT *dstPtr = __getRange(ctx, ctx.__AX, wordNum);
+                WordT *srcPtr = __getRange(ctx, ctx.__SS.back(), wordNum);
+
+                __ArrayKernel::__copy(dstPtr, srcPtr, wordNum);
+                ctx.__AX = wordNum;
             }
-            else if (!__CS[__IP].compare(0, 5, "addr "))
+            else if (CS[ctx.__IP] == "asum")
             {
-                __AX = __SS.size() - stoll(__CS[__IP].substr(5));
+                // sum(Array, Lo, Hi): AX = Array, SS.TOP() = Lo, then Hi
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                WordT loIdx = ctx.__SS.back(), wordNum = ctx.__SS[ctx.__SS.size() - 2] - loIdx;
+
+                ctx.__AX = __ArrayKernel::__sum(__getRange(ctx, ctx.__AX + loIdx, wordNum), wordNum);
             }
-            else if (!__CS[__IP].compare(0, 5, "call "))
+            else if (CS[ctx.__IP] == "amin")
             {
-                __SS.push_back(__BP);
-                __BP = __SS.size() - 2;
-                __SS.push_back(__IP);
-                __IP += stoll(__CS[__IP].substr(5)) - 1;
+                // argmin(Array, Lo, Hi): AX = Array, SS.TOP() = Lo, then Hi, AX = The index of the first min
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                WordT loIdx = ctx.__SS.back(), wordNum = ctx.__SS[ctx.__SS.size() - 2] - loIdx;
+
+                if (wordNum <= 0)
+                {
+                    throw runtime_error("Invalid empty range of argmin");
+                }
+
+                ctx.__AX = loIdx + __ArrayKernel::__argmin(__getRange(ctx, ctx.__AX + loIdx, wordNum), wordNum);
             }
-            else if (__CS[__IP] == "ret")
+            else if (CS[ctx.__IP] == "adot")
             {
-                __IP = __SS.back();
-                __SS.pop_back();
-                __BP = __SS.back();
-                __SS.pop_back();
+                // dot(Lhs, Rhs, N): AX = Lhs, SS.TOP() = Rhs, then N
+                BoundsPolicy::__checkSize(ctx.__SS, 2);
+
+                WordT wordNum = ctx.__SS[ctx.__SS.size() - 2];
+                WordT *lhsPtr = __getRange(ctx, ctx.__AX, wordNum);
+
+                ctx.__AX = __ArrayKernel::__dot(lhsPtr, __getRange(ctx, ctx.__SS.back(), wordNum), wordNum);
             }
             else
             {
                 throw runtime_error("Invalid instruction");
             }
         }
+
+        return true;
+    }
+
+
+    // Exec (The runtime errors are attributed to the source line)
+    template <bool SliceBool>
+    bool __exec(__Context<WordT> &ctx, uint64_t &sliceLeft)
+    {
+        try
+        {
+            return __execCode<SliceBool>(ctx, sliceLeft);
+        }
+        catch (const runtime_error &errObj)
+        {
+            __throwAt(ctx, errObj.what());
+        }
+    }
+
+
+    // Throw At (The error at the current IP of ctx)
+    [[noreturn]] void __throwAt(const __Context<WordT> &ctx, const string &errStr) const
+    {
+        string sourceStr = __codePtr->__getSource(ctx.__IP);
+
+        throw runtime_error(errStr + " at " +
+            (sourceStr.empty() ? "IP " + to_string(ctx.__IP) : sourceStr + " (IP " + to_string(ctx.__IP) + ")"));
+    }
+
+
+    // Exec Slice (Run ctx for at most sliceNum instructions and its fuel, true if the program is finished)
+    bool __execSlice(__Context<WordT> &ctx, uint64_t sliceNum)
+    {
+        uint64_t sliceLeft = std::min(sliceNum, ctx.__fuel);
+        bool finishBool = __exec<true>(ctx, sliceLeft);
+
+        if (ctx.__fuel != UINT64_MAX)
+        {
+            ctx.__fuel -= std::min(sliceNum, ctx.__fuel) - sliceLeft;
+
+            if (!finishBool && !ctx.__fuel)
+            {
+                __throwAt(ctx, "Out of fuel");
+            }
+        }
+
+        return finishBool;
+    }
+
+
+    // Exec All (Run ctx to the end or out of its fuel)
+    void __execAll(__Context<WordT> &ctx)
+    {
+        if (ctx.__fuel == UINT64_MAX)
+        {
+            uint64_t sliceLeft = 0;
+
+            __exec<false>(ctx, sliceLeft);
+        }
+        else
+        {
+            __execSlice(ctx, UINT64_MAX);
+        }
+    }
+
+
+    // Start Record (A batch record: The input is the text, the output text is appended to outputStr)
+    void __startRecord(__Context<WordT> &ctx, const char *inputPtr, size_t inputSize, string &outputStr,
+        uint64_t fuel) const
+    {
+        ctx.__reset(__codePtr->__RSSize, fuel);
+        ctx.__io.__openMemory(inputPtr, inputSize, &outputStr);
+    }
+
+
+    // Start Stream (A stream context: The input is pushed by the host, the output text is appended to outputStr)
+    void __startStream(__Context<WordT> &ctx, string &outputStr, uint64_t fuel) const
+    {
+        ctx.__reset(__codePtr->__RSSize, fuel);
+        ctx.__io.__openStream(&outputStr);
+    }
+
+
+    // Exec Task (A program calling spawn: ctx and its tasks run as green threads on the __Scheduler)
+    void __execTask(__Context<WordT> &ctx)
+    {
+        auto cpuList = __Scheduler<__VM>::__getCpuList();
+        __TaskGroup<WordT> groupObj(__codePtr->__globalNum, ctx.__fuel, ctx.__io);
+
+        // The first error of the tasks (A "join" of a failed task fails as well)
+        string errStr;
+        mutex errMutex;
+
+        __Scheduler<__VM> schedulerObj(__codePtr, cpuList, __jobNum ? __jobNum : std::max(cpuList.size(), (size_t)1),
+            __quantum ? __quantum : __DEFAULT_TASK_QUANTUM,
+            [&errStr, &errMutex](__Context<WordT> &, bool, const string &taskErrStr)
+            {
+                if (!taskErrStr.empty())
+                {
+                    lock_guard<mutex> errLock(errMutex);
+
+                    if (errStr.empty())
+                    {
+                        errStr = taskErrStr;
+                    }
+                }
+            });
+
+        ctx.__groupPtr = &groupObj;
+        schedulerObj({&ctx});
+        ctx.__groupPtr = nullptr;
+
+        __insCount = schedulerObj.__insCount;
+        __callCount = schedulerObj.__callCount;
+        __maxSSSize = schedulerObj.__maxSSSize;
+        __taskNum = groupObj.__getTaskNum();
+        __sliceCount = schedulerObj.__sliceCount;
+        __stealCount = schedulerObj.__stealCount;
+        __parkCount = schedulerObj.__parkCount;
+
+        if (!errStr.empty())
+        {
+            throw runtime_error(errStr);
+        }
     }
 
 
@@ -195,8 +726,46 @@ private:
             return;
         }
 
-        __constructCS();
-        __execCode();
+        __codePtr = make_shared<const __Code>(__inputFilePath);
+        __codePtr->__checkWordSize(sizeof(WordT) * 8);
+        __ctx.__reset(__codePtr->__RSSize, __fuel);
+        __ctx.__io.__open();
+
+        // The tasks are run by the VMs of the workers
+        if (__codePtr->__spawnBool)
+        {
+            if (ProfilePolicy::__profileBool || __perfCounter.__enableBool)
+            {
+                throw runtime_error("Invalid spawn with --profile, --folded-stack-file or --perf-counters");
+            }
+
+            __execTask(__ctx);
+            __ctx.__io.__flush();
+
+            return;
+        }
+
+        __perfCounter.__open();
+        __perfCounter.__start();
+
+        if constexpr (ProfilePolicy::__profileBool)
+        {
+            __profiler.__init(__codePtr->__CS, __codePtr->__funcList,
+                [this](size_t IP) { return __codePtr->__getSource(IP); },
+                __perfCounter.__isAvailable() ? &__perfCounter : nullptr);
+        }
+
+        __execAll(__ctx);
+        __perfCounter.__stop();
+        __ctx.__io.__flush();
+
+        if constexpr (ProfilePolicy::__profileBool)
+        {
+            __profiler.__report();
+        }
+
+        // The perf counters need the guest instruction count (So ProfilePolicy::__statBool)
+        __perfCounter.__report(__insCount);
     }
 };
 
@@ -0,0 +1,149 @@
+/*
+    VMPolicy.hpp
+    ============
+        Policy types of the class template __VM.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+
+namespace CMM
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Using
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::runtime_error;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bounds Policy: Unchecked (The SS / RS accesses are trusted)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __UncheckedBounds
+{
+    // Check Index
+    template <typename WordT, typename AllocT>
+    static void __checkIdx(const vector<WordT, AllocT> &, WordT) {}
+
+
+    // Check Size
+    template <typename WordT, typename AllocT>
+    static void __checkSize(const vector<WordT, AllocT> &, size_t) {}
+
+
+    // Check Range
+    template <typename WordT, typename AllocT>
+    static void __checkRange(const vector<WordT, AllocT> &, WordT, WordT) {}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bounds Policy: Checked (An invalid SS / RS access throws instead of corrupting the VM)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __CheckedBounds
+{
+    // Check Index
+    template <typename WordT, typename AllocT>
+    static void __checkIdx(const vector<WordT, AllocT> &wordList, WordT wordIdx)
+    {
+        if (wordIdx < 0 || (size_t)wordIdx >= wordList.size())
+        {
+            throw runtime_error("Invalid stack index " + to_string(wordIdx) + " (Size " +
+                to_string(wordList.size()) + ")");
+        }
+    }
+
+
+    // Check Size (At least minSize words, for "back" and "pop")
+    template <typename WordT, typename AllocT>
+    static void __checkSize(const vector<WordT, AllocT> &wordList, size_t minSize)
+    {
+        if (wordList.size() < minSize)
+        {
+            throw runtime_error("Invalid stack size " + to_string(wordList.size()) + " (Need " +
+                to_string(minSize) + ")");
+        }
+    }
+
+
+    // Check Range (The wordNum words from wordIdx, for the array builtins)
+    template <typename WordT, typename AllocT>
+    static void __checkRange(const vector<WordT, AllocT> &wordList, WordT wordIdx, WordT wordNum)
+    {
+        if (wordIdx < 0 || (size_t)wordIdx + wordNum > wordList.size())
+        {
+            throw runtime_error("Invalid stack range " + to_string(wordIdx) + " + " + to_string(wordNum) + " (Size " +
+                to_string(wordList.size()) + ")");
+        }
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Trace Policy: None
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __NoTrace
+{
+    // The lockstep lanes of a batch can run it
+    static constexpr bool __laneBool = true;
+
+    // Trace
+    template <typename WordT>
+    static void __trace(size_t, const string &, WordT, size_t) {}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Trace Policy: Stderr (Each instruction with AX and the SS size before it)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __StderrTrace
+{
+    static constexpr bool __laneBool = false;
+
+    // Trace
+    template <typename WordT>
+    static void __trace(size_t IP, const string &insStr, WordT AX, size_t SSSize)
+    {
+        fprintf(stderr, "%8zu  %-16s AX = %-12lld SS = %zu\n", IP, insStr.c_str(), (long long)AX, SSSize);
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Profile Policy: None, Stat (The run statistics only), Full (The profiler and the run statistics)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct __NoProfile
+{
+    static constexpr bool __profileBool = false;
+    static constexpr bool __statBool    = false;
+};
+
+
+struct __StatProfile
+{
+    static constexpr bool __profileBool = false;
+    static constexpr bool __statBool    = true;
+};
+
+
+struct __FullProfile
+{
+    static constexpr bool __profileBool = true;
+    static constexpr bool __statBool    = true;
+};
+
+
+}  // End namespace CMM